@@ -54,6 +54,7 @@
 #include <dtkWidgets/dtkNotificationDisplay.h>
 
 #include <medComposerExtension.h>
+#include <medComposerNodeCache.h>
 
 #include <QtCore>
 #include <QtWidgets>
@@ -118,32 +119,7 @@ medComposerArea::medComposerArea(QWidget *parent) : QWidget(parent), d(new medCo
     d->composer->view()->setBackgroundBrush(QBrush(QPixmap(":dtkVisualProgramming/pixmaps/dtkComposerScene-bg.png")));
     d->composer->view()->setCacheMode(QGraphicsView::CacheBackground);
     
-    dtkComposer::node::initialize();
-
-    QScopedPointer<dtkComposerExtension> extension(new medComposerExtension);
-    d->composer->factory()->extend(extension.data());
-
-    QString pluginsPath = getenv("MEDINRIA_PLUGINS_DIR");
-    QString defaultPath;
-    QDir plugins_dir;
-#ifdef Q_OS_MAC
-    plugins_dir = qApp->applicationDirPath() + "/../PlugIns";
-#else
-    plugins_dir = qApp->applicationDirPath() + "/../plugins";
-#endif
-    defaultPath = plugins_dir.absolutePath();
-
-    if ( !pluginsPath.isEmpty() )
-        dtkComposer::extension::initialize(pluginsPath);
-    else
-        dtkComposer::extension::initialize(defaultPath);
-
-    QStringList exts = dtkComposer::extension::pluginFactory().keys();
-    for(QString extKey : exts)
-    {
-        dtkComposerExtension* ext=dtkComposer::extension::pluginFactory().create(extKey);
-        d->composer->factory()->extend(ext);
-    }
+    medComposerExtension::initializeFactory(d->composer->factory());
 
     d->controls = nullptr;
 
@@ -253,6 +229,9 @@ medComposerArea::medComposerArea(QWidget *parent) : QWidget(parent), d(new medCo
     QAction *reset_action = mainToolBar->addAction(QIcon(":dtkVisualProgramming/pixmaps/dtkCreatorToolbarButton_Reset_Active.png"), "Reset");
     reset_action->setShortcut(Qt::ControlModifier + Qt::ShiftModifier + Qt::Key_D);
 
+    QAction *clear_cache_action = new QAction("Clear node results", this);
+    clear_cache_action->setToolTip("Forget the node results kept to skip the nodes whose inputs and parameters did not change");
+
     QFrame *buttons = new QFrame(this);
     buttons->setObjectName("medComposerAreaSegmentedButtons");
 
@@ -347,10 +326,16 @@ medComposerArea::medComposerArea(QWidget *parent) : QWidget(parent), d(new medCo
     debug_menu->addAction(next_action);
     debug_menu->addAction(stop_action);
     debug_menu->addAction(reset_action);
+    debug_menu->addSeparator();
+    debug_menu->addAction(clear_cache_action);
 
     // -- Connections
 
+    connect(run_action, SIGNAL(triggered()), medComposerNodeCache::instance(), SLOT(startEvaluation()));
     connect(run_action, SIGNAL(triggered()), d->composer, SLOT(run()));
+    connect(clear_cache_action, SIGNAL(triggered()), medComposerNodeCache::instance(), SLOT(clear()));
+    connect(medComposerNodeCache::instance(), SIGNAL(lookedUp(const QString&, bool)), this, SLOT(onNodeCacheLookedUp(const QString&, bool)));
+    connect(medComposerNodeCache::instance(), SIGNAL(failed(const QString&)), this, SLOT(onNodeFailed(const QString&)));
     connect(step_action, SIGNAL(triggered()), d->composer, SLOT(step()));
     connect(continue_action, SIGNAL(triggered()), d->composer, SLOT(cont()));
     connect(next_action, SIGNAL(triggered()), d->composer, SLOT(next()));
@@ -725,3 +710,18 @@ void medComposerArea::onComposerNodeFlagged(dtkComposerSceneNode *node)
 {
     dtkComposerViewController::instance()->insert(node);
 }
+
+void medComposerArea::onNodeCacheLookedUp(const QString& node, bool hit)
+{
+    if (hit) {
+        dtkInfo() << node << ": inputs and parameters unchanged, previous result reused";
+        dtkNotify(QString("<div style=\"color: #006600\">%1: previous result reused</div>").arg(node), 2000);
+    } else {
+        dtkInfo() << node << ": computed";
+    }
+}
+
+void medComposerArea::onNodeFailed(const QString& node)
+{
+    dtkNotify(QString("<div style=\"color: #cc0000\">%1: failed</div>").arg(node), 5000);
+}
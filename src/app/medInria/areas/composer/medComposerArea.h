@@ -49,6 +49,8 @@ protected slots:
 
 protected slots:
     void onComposerNodeFlagged(dtkComposerSceneNode *);
+    void onNodeCacheLookedUp(const QString& node, bool hit);
+    void onNodeFailed(const QString& node);
 
 private:
     medComposerAreaPrivate *d;
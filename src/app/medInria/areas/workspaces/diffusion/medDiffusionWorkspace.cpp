@@ -24,6 +24,8 @@
 
 #include <medToolBoxFactory.h>
 
+#include <dtkCoreSupport/dtkSmartPointer.h>
+
 class medDiffusionWorkspacePrivate
 {
 public:
@@ -34,6 +36,9 @@ public:
     medDiffusionSelectorToolBox *diffusionScalarMapsToolBox;
     medDiffusionSelectorToolBox *diffusionTractographyToolBox;
 
+    // fibers shown while the tractography runs
+    dtkSmartPointer<medAbstractData> tractographyPartialOutput;
+
     bool processRunning;
 };
 
@@ -64,6 +69,7 @@ medDiffusionWorkspace::medDiffusionWorkspace(QWidget *parent) : medAbstractWorks
 
     connect(d->diffusionTractographyToolBox,SIGNAL(jobRunning(bool)),this,SLOT(updateRunningFlags(bool)));
     connect(d->diffusionTractographyToolBox,SIGNAL(jobFinished(medAbstractJob::medJobExitStatus)),this,SLOT(getTractographyOutput(medAbstractJob::medJobExitStatus)));
+    connect(d->diffusionTractographyToolBox,SIGNAL(partialOutputChanged()),this,SLOT(getTractographyPartialOutput()));
 
     // -- View toolboxes --
     QList<QString> toolboxNames = medToolBoxFactory::instance()->toolBoxesFromCategory("view");
@@ -112,7 +118,7 @@ void medDiffusionWorkspace::getEstimationOutput(medAbstractJob::medJobExitStatus
     if (!outputData)
         return;
 
-    d->diffusionContainer->addData(outputData);
+    d->diffusionContainer->addData(outputData.data());
 }
 
 void medDiffusionWorkspace::getScalarMapsOutput(medAbstractJob::medJobExitStatus status)
@@ -125,11 +131,13 @@ void medDiffusionWorkspace::getScalarMapsOutput(medAbstractJob::medJobExitStatus
     if (!outputData)
         return;
 
-    d->diffusionContainer->addData(outputData);
+    d->diffusionContainer->addData(outputData.data());
 }
 
 void medDiffusionWorkspace::getTractographyOutput(medAbstractJob::medJobExitStatus status)
 {
+    this->removeTractographyPartialOutput();
+
     if (status != medAbstractJob::MED_JOB_EXIT_SUCCESS)
         return;
 
@@ -138,7 +146,38 @@ void medDiffusionWorkspace::getTractographyOutput(medAbstractJob::medJobExitStat
     if (!outputData)
         return;
 
-    d->diffusionContainer->addData(outputData);
+    d->diffusionContainer->addData(outputData.data());
+}
+
+/**
+ * Replaces the fibers shown so far by the ones of the last batch.
+ */
+void medDiffusionWorkspace::getTractographyPartialOutput()
+{
+    dtkSmartPointer<medAbstractData> outputData = d->diffusionTractographyToolBox->processPartialOutput();
+
+    if (outputData.data() == d->tractographyPartialOutput.data() || d->diffusionContainer.isNull())
+        return;
+
+    this->removeTractographyPartialOutput();
+
+    if (!outputData)
+        return;
+
+    d->tractographyPartialOutput = outputData;
+    d->diffusionContainer->addData(outputData.data());
+}
+
+void medDiffusionWorkspace::removeTractographyPartialOutput()
+{
+    if (!d->tractographyPartialOutput.data())
+        return;
+
+    medAbstractLayeredView *medView = d->diffusionContainer.isNull() ? nullptr : dynamic_cast <medAbstractLayeredView *> (d->diffusionContainer->view());
+    if (medView)
+        medView->removeData(d->tractographyPartialOutput.data());
+
+    d->tractographyPartialOutput = nullptr;
 }
 
 void medDiffusionWorkspace::updateRunningFlags(bool running)
@@ -206,6 +245,11 @@ void medDiffusionWorkspace::addToolBoxInput(medAbstractData *data)
         d->diffusionScalarMapsToolBox->addInputImage(medData);
         d->diffusionTractographyToolBox->addInputImage(medData);
     }
+    else if (medData->identifier() == "itkDataImageUChar3")
+    {
+        // candidate seed mask
+        d->diffusionTractographyToolBox->addInputImage(medData);
+    }
 }
 
 void medDiffusionWorkspace::resetToolBoxesInputs()
@@ -41,6 +41,7 @@ public slots:
     void getEstimationOutput(medAbstractJob::medJobExitStatus status);
     void getScalarMapsOutput(medAbstractJob::medJobExitStatus status);
     void getTractographyOutput(medAbstractJob::medJobExitStatus status);
+    void getTractographyPartialOutput();
 
     void updateRunningFlags(bool running);
     
@@ -52,5 +53,7 @@ public slots:
     void changeCurrentContainer();
 
 private:
+    void removeTractographyPartialOutput();
+
     medDiffusionWorkspacePrivate *d;
 };
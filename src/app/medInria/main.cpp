@@ -23,6 +23,7 @@
 #include <medApplication.h>
 #include <medSplashScreen.h>
 
+#include <medComposerBatchRunner.h>
 #include <medPluginManager.h>
 #include <medDataIndex.h>
 #include <medDatabaseController.h>
@@ -66,8 +67,115 @@ void forceShow(medMainWindow& mainwindow )
 //#endif
 }
 
+QString argumentValue(const QStringList& arguments, const QString& option)
+{
+    for (const QString& arg : arguments)
+    {
+        if (arg.startsWith(option + "="))
+        {
+            return arg.mid(option.size() + 1);
+        }
+    }
+    return QString();
+}
+
+int runComposerBatch(QCoreApplication& application, const QString& composition)
+{
+    const QStringList arguments = application.arguments();
+
+    medComposerBatchRunner runner;
+    if (!runner.setComposition(composition) || !runner.setManifest(argumentValue(arguments, "--manifest")))
+    {
+        qCritical() << "A composition and a manifest are needed to run a batch.";
+        return 1;
+    }
+
+    const QString workdir = argumentValue(arguments, "--workdir");
+    runner.setWorkingDirectory(workdir.isEmpty() ? QDir::currentPath() : workdir);
+
+    const int jobs = argumentValue(arguments, "--jobs").toInt();
+    if (jobs > 0)
+    {
+        runner.setMaximumJobs(jobs);
+    }
+
+    const qint64 megabyte = 1024 * 1024;
+    runner.setMemoryBudget(argumentValue(arguments, "--memory").toLongLong() * megabyte,
+                           argumentValue(arguments, "--subject-memory").toLongLong() * megabyte);
+    runner.setResume(arguments.contains("--resume"));
+
+    const int total = runner.subjects().size();
+    int finished = 0;
+    QObject::connect(&runner, &medComposerBatchRunner::subjectStarted, [](const QString& subject)
+    {
+        qInfo() << "Started" << subject;
+    });
+    QObject::connect(&runner, &medComposerBatchRunner::subjectFinished,
+                     [&finished, total, &runner](const QString& subject, bool success, const QString& message)
+    {
+        ++finished;
+        qInfo() << QString("[%1/%2]").arg(finished).arg(total).toStdString().c_str()
+                << subject << (success ? "succeeded," : "failed,") << message
+                << (success ? "" : "- see " + runner.subjectDirectory(subject) + "/evaluation.log");
+    });
+    QObject::connect(&runner, &medComposerBatchRunner::finished, &application, [&application](int failures)
+    {
+        qInfo() << "Batch finished," << failures << "subject(s) failed.";
+        application.exit(failures ? 1 : 0);
+    });
+
+    if (!runner.start())
+    {
+        return 1;
+    }
+    return application.exec();
+}
+
+void useCLocale()
+{
+    setlocale(LC_NUMERIC, "C");
+    QLocale::setDefault(QLocale("C"));
+}
+
 int main(int argc,char* argv[])
 {
+    // Headless runs of compositions, handled before the GUI application, its
+    // splash screen and the single instance check.
+    // The batch runner evaluates each subject in a child process.
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+    {
+        arguments << QString::fromLocal8Bit(argv[i]);
+    }
+
+    const QString batchComposition = argumentValue(arguments, "--composer-batch");
+    if (!batchComposition.isEmpty())
+    {
+        QCoreApplication application(argc, argv);
+        medApplication::setApplicationIdentity();
+        useCLocale();
+        return runComposerBatch(application, batchComposition);
+    }
+
+    const QString evaluatedComposition = argumentValue(arguments, "--composer-evaluate");
+    if (!evaluatedComposition.isEmpty())
+    {
+        // the composition is read into a graphics scene, which is never shown
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QApplication application(argc, argv);
+        medApplication::setApplicationIdentity();
+        useCLocale();
+
+        medApplication::initializeProcessPlugins();
+        medPluginManager::instance()->initialize();
+        const int status = medComposerBatchRunner::evaluate(evaluatedComposition);
+        medPluginManager::instance()->uninitialize();
+        return status;
+    }
+
     // Setup openGL surface compatible with QVTKOpenGLNativeWidget required by medVtkView.
     // We could have used "SurfaceFormat::setDefaultFormat(QVTKOpenGLNativeWidget::defaultFormat())"
     // directly, but in order to avoid a link to VTK here, here is a copy of
@@ -95,8 +203,7 @@ int main(int argc,char* argv[])
     medApplication application(argc,argv);
     medSplashScreen splash(QPixmap(":/pixmaps/medInria-logo-homepage.png"));
 
-    setlocale(LC_NUMERIC, "C");
-    QLocale::setDefault(QLocale("C"));
+    useCLocale();
 
     if (dtkApplicationArgumentsContain(&application, "-h") || dtkApplicationArgumentsContain(&application, "--help"))
     {
@@ -108,7 +215,9 @@ int main(int argc,char* argv[])
             #ifdef ACTIVATE_WALL_OPTION
                  << "[[--wall] [--tracker=URL]] "
             #endif
-                 << "[[--view] [files]]";
+                 << "[[--view] [files]] "
+                 << "[--composer-batch=composition --manifest=subjects.csv [--workdir=dir] [--jobs=N] "
+                 << "[--memory=MB --subject-memory=MB] [--resume]]";
         return 1;
     }
 
@@ -139,7 +248,15 @@ int main(int argc,char* argv[])
                      << "--tracker"
                      << "--stereo"
                      << "--view"
-                     << "--debug");
+                     << "--debug"
+                     << "--composer-batch"
+                     << "--composer-evaluate"
+                     << "--manifest"
+                     << "--workdir"
+                     << "--jobs"
+                     << "--memory"
+                     << "--subject-memory"
+                     << "--resume");
             for (QStringList::const_iterator opt=options.constBegin();opt!=options.constEnd();++opt)
             {
                 if (arg.startsWith(*opt))
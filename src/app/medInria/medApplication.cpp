@@ -48,10 +48,7 @@ medApplication::medApplication(int & argc, char**argv) :
 {
     d->mainWindow = nullptr;
 
-    this->setApplicationName("medInria");
-    this->setApplicationVersion(MEDINRIA_VERSION);
-    this->setOrganizationName("inria");
-    this->setOrganizationDomain("fr");
+    setApplicationIdentity();
     this->setWindowIcon(QIcon(":/medInria.ico"));
 
     medLogger::initialize();
@@ -136,7 +133,19 @@ void medApplication::initialize()
     medAbstractDataFactory * datafactory = medAbstractDataFactory::instance();
     datafactory->registerDataType<medSeedPointAnnotationData>();
 
-    // process layer:
+    initializeProcessPlugins();
+}
+
+void medApplication::setApplicationIdentity()
+{
+    QCoreApplication::setApplicationName("medInria");
+    QCoreApplication::setApplicationVersion(MEDINRIA_VERSION);
+    QCoreApplication::setOrganizationName("inria");
+    QCoreApplication::setOrganizationDomain("fr");
+}
+
+void medApplication::initializeProcessPlugins()
+{
     QString pluginsPath = getenv("MEDINRIA_PLUGINS_DIR");
     QString defaultPath;
     QDir plugins_dir;
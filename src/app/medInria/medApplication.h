@@ -29,6 +29,11 @@ public:
     bool event(QEvent *event);
     void setMainWindow(medMainWindow *mw);
 
+    //! Names the application for its settings, also in the headless runs
+    static void setApplicationIdentity();
+    //! Loads the plugins of the process layer
+    static void initializeProcessPlugins();
+
 signals:
     void showMessage(const QString& message);
 
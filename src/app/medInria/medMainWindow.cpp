@@ -19,6 +19,7 @@
 #include <medEmptyDbWarning.h>
 #include <medHomepageArea.h>
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 #include <medLogger.h>
 #include <medMainWindow.h>
 #include <medQuickAccessMenu.h>
@@ -711,7 +712,7 @@ void medMainWindow::closeEvent(QCloseEvent *event)
 
     dtkInfo() << "### Application is closing...";
 
-    if ( QThreadPool::globalInstance()->activeThreadCount() > 0 )
+    if ( medJobScheduler::instance()->runningJobs() > 0 )
     {
         int res = QMessageBox::information(this,
                                            tr("System message"),
@@ -727,12 +728,12 @@ void medMainWindow::closeEvent(QCloseEvent *event)
             // send cancel request to all running jobs, then wait for them
             // Note: most Jobs don't have the cancel method implemented, so this will be effectively the same as waitfordone.
             medJobManagerL::instance()->dispatchGlobalCancelEvent();
-            QThreadPool::globalInstance()->waitForDone();
+            medJobScheduler::instance()->waitForDone();
         }
         else
         {
             // just hide the window and wait
-            QThreadPool::globalInstance()->waitForDone();
+            medJobScheduler::instance()->waitForDone();
         }
     }
 
@@ -14,6 +14,7 @@
 #include <medPacsDataSource.h>
 
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 
 #include <medBrowserPacsHostToolBox.h>
 #include <medBrowserPacsNodesToolBox.h>
@@ -106,5 +107,5 @@ void medPacsDataSource::onPacsMove( const QVector<medMoveCommandItem>& cmdList)
     medPacsMover* mover = new medPacsMover(cmdList);
     connect(mover, SIGNAL(import(QString)), this, SIGNAL(dataReceived(QString)));
     medJobManagerL::instance()->registerJobItem(mover, tr("Moving"));
-    QThreadPool::globalInstance()->start(mover);
+    medJobScheduler::instance()->start(mover, medJobScheduler::DataJob);
 }
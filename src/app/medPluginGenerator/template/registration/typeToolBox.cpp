@@ -26,6 +26,7 @@
 #include <medAbstractView.h>
 #include <medRunnableProcess.h>
 #include <medJobManager.h>
+#include <medJobScheduler.h>
 
 #include <medAbstractImageData.h>
 
@@ -133,5 +134,5 @@ void %1ToolBox::run()
              d->progression_stack, SLOT(setActive(QObject*,bool)));
     
     medJobManager::instance()->registerJobItem(runProcess);
-    QThreadPool::globalInstance()->start(dynamic_cast<QRunnable*>(runProcess));
+    medJobScheduler::instance()->start(dynamic_cast<QRunnable*>(runProcess), medJobScheduler::HeavyProcessJob);
 }
@@ -191,9 +191,31 @@ void medAbstractData::invokeModified()
     emit dataModified(this);
 }
 
+/**
+ * @brief Memory used by the content of the data, in bytes
+ *
+ * Used by medDataManager to bound the memory of the data it keeps loaded.
+ * @return qint64 the size, 0 if unknown
+ */
+qint64 medAbstractData::memorySize()
+{
+    return 0;
+}
+
+/**
+ * @brief Thumbnail of the data
+ *
+ * Rendered on the CPU when the data type supports it (see renderThumbnail()),
+ * otherwise in a view created in the GUI thread.
+ */
 QImage medAbstractData::generateThumbnail(QSize size)
 {
-    QImage thumbnail;
+    QImage thumbnail = this->renderThumbnail(size);
+    if (!thumbnail.isNull())
+    {
+        return thumbnail;
+    }
+
     if (QThread::currentThread() != QApplication::instance()->thread())
     {
         QMetaObject::invokeMethod(this,
@@ -210,6 +232,20 @@ QImage medAbstractData::generateThumbnail(QSize size)
     return thumbnail;
 }
 
+/**
+ * @brief Renders the thumbnail without a view, usually with medThumbnailRenderer
+ *
+ * Must be safe to call from any thread, as importers call it from their
+ * workers.
+ * @return QImage the thumbnail, or a null image if the data type does not
+ * support it
+ */
+QImage medAbstractData::renderThumbnail(QSize size)
+{
+    Q_UNUSED(size);
+    return QImage();
+}
+
 QImage medAbstractData::generateThumbnailInGuiThread(QSize size)
 {
     // Hack: some drivers crash on offscreen rendering, so we detect which one
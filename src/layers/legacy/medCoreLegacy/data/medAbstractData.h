@@ -45,6 +45,10 @@ public:
 
     virtual QImage generateThumbnail(QSize size);
 
+    virtual QImage renderThumbnail(QSize size);
+
+    virtual qint64 memorySize();
+
 public slots:
 
     void clearAttachedData();
@@ -118,3 +118,13 @@ int medAbstractImageData::scalarValueMaxCount(void)
 
     return 0;
 }
+
+medImageStatistics medAbstractImageData::statistics()
+{
+    return medImageStatistics();
+}
+
+void medAbstractImageData::setStatistics(const medImageStatistics &statistics)
+{
+    Q_UNUSED(statistics);
+}
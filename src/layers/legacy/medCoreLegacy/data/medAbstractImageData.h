@@ -17,6 +17,7 @@
 
 #include <medAbstractData.h>
 #include <medCoreLegacyExport.h>
+#include <medImageStatistics.h>
 
 class MEDCORELEGACY_EXPORT medAbstractImageData: public medAbstractData
 {
@@ -48,6 +49,18 @@ public:
     virtual int scalarValueMinCount();
     virtual int scalarValueMaxCount();
 
+    /**
+     * Summary statistics and histogram of the voxel values, computed once
+     * and kept until the data is modified. Invalid when not supported.
+     */
+    virtual medImageStatistics statistics();
+
+    /**
+     * Provides statistics computed earlier, e.g. stored in the database, so
+     * that they do not have to be computed again from the voxels.
+     */
+    virtual void setStatistics(const medImageStatistics &statistics);
+
     virtual void deleteHistogram(){}
 
     static const char* PixelMeaningMetaData;
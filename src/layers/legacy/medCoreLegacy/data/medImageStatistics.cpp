@@ -0,0 +1,330 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medImageStatistics.h>
+
+#include <QDataStream>
+#include <QFile>
+
+#include <algorithm>
+
+namespace
+{
+const quint32 fileMagic = 0x6d535441; // "mSTA"
+const quint32 fileVersion = 1;
+}
+
+medImageStatistics::medImageStatistics()
+    : count(0), minimum(0), maximum(0), mean(0), variance(0), histogramOrigin(0), binWidth(1)
+{
+}
+
+bool medImageStatistics::isValid() const
+{
+    return count > 0;
+}
+
+double medImageStatistics::percentile(double percentage) const
+{
+    if (!isValid())
+    {
+        return 0;
+    }
+
+    const double target = qBound(0.0, percentage, 100.0) / 100.0 * count;
+    double cumulated = 0;
+    for (int i = 0; i < histogram.size(); ++i)
+    {
+        if (histogram[i] > 0 && cumulated + histogram[i] >= target)
+        {
+            double value = histogramOrigin + (i + (target - cumulated) / histogram[i]) * binWidth;
+            return qBound(minimum, value, maximum);
+        }
+        cumulated += histogram[i];
+    }
+    return maximum;
+}
+
+medImageStatistics medImageStatistics::downsampled(int maximumBinCount) const
+{
+    medImageStatistics result = *this;
+    while (result.histogram.size() > std::max(1, maximumBinCount))
+    {
+        // edges stay multiples of the width, as in the accumulator
+        const double width = 2 * result.binWidth;
+        const double origin = std::floor(result.histogramOrigin / width) * width;
+        const int first = static_cast<int>(std::floor((result.histogramOrigin - origin) / result.binWidth));
+
+        QVector<qint64> bins((first + result.histogram.size() + 1) / 2, 0);
+        for (int i = 0; i < result.histogram.size(); ++i)
+        {
+            bins[(first + i) / 2] += result.histogram[i];
+        }
+
+        result.histogram = bins;
+        result.histogramOrigin = origin;
+        result.binWidth = width;
+    }
+    return result;
+}
+
+bool medImageStatistics::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << fileMagic << fileVersion
+           << count << minimum << maximum << mean << variance
+           << histogramOrigin << binWidth << histogram;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * Returns invalid statistics when the file is missing or unreadable.
+ */
+medImageStatistics medImageStatistics::load(const QString &fileName)
+{
+    medImageStatistics statistics;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return statistics;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != fileMagic || version != fileVersion)
+    {
+        return statistics;
+    }
+
+    stream >> statistics.count >> statistics.minimum >> statistics.maximum >> statistics.mean >> statistics.variance
+           >> statistics.histogramOrigin >> statistics.binWidth >> statistics.histogram;
+
+    if (stream.status() != QDataStream::Ok || statistics.binWidth <= 0)
+    {
+        return medImageStatistics();
+    }
+    return statistics;
+}
+
+medImageStatistics::Accumulator::Accumulator(bool integerValues)
+    : m_integerValues(integerValues), m_count(0), m_shift(0), m_sum(0), m_squareSum(0),
+      m_minimum(0), m_maximum(0), m_origin(0), m_width(1), m_inverseWidth(1),
+      m_rangeKnown(false), m_rangeLowest(0)
+{
+}
+
+void medImageStatistics::Accumulator::setValueRange(double lowest, double highest)
+{
+    m_rangeKnown = m_integerValues && (highest - lowest < binCount);
+    m_rangeLowest = std::floor(lowest);
+}
+
+/**
+ * Anchors the histogram on the known range of the values, or centers it on
+ * the first value, with bins as narrow as the precision of the values makes
+ * useful.
+ */
+void medImageStatistics::Accumulator::initialize(double value)
+{
+    m_shift = value;
+    m_minimum = m_maximum = value;
+
+    if (m_integerValues)
+    {
+        m_width = 1;
+    }
+    else
+    {
+        int exponent = (value != 0) ? std::ilogb(value) - 12 : -20;
+        m_width = std::ldexp(1.0, exponent);
+    }
+    m_inverseWidth = 1 / m_width;
+    if (m_rangeKnown)
+    {
+        m_origin = m_rangeLowest;
+    }
+    else
+    {
+        m_origin = (std::floor(value * m_inverseWidth) - binCount / 2) * m_width;
+    }
+    m_bins.assign(binCount, 0);
+}
+
+/**
+ * Extends the histogram range to the value. The bins are moved as long as the
+ * range of the values fits in them, and only widened when it does not.
+ */
+void medImageStatistics::Accumulator::include(double value)
+{
+    while (value < m_origin || value >= m_origin + binCount * m_width)
+    {
+        const double lowest = std::floor(std::min(m_minimum, value) * m_inverseWidth);
+        const double highest = std::floor(std::max(m_maximum, value) * m_inverseWidth);
+        if (highest - lowest < binCount)
+        {
+            // centered on the values, to leave room on both sides
+            moveBins((std::floor((lowest + highest) / 2) - binCount / 2) * m_width);
+            if (value < m_origin || value >= m_origin + binCount * m_width)
+            {
+                moveBins((value < m_origin) ? lowest * m_width : (highest - binCount + 1) * m_width);
+            }
+        }
+        else
+        {
+            doubleBinWidth(value < m_origin);
+        }
+    }
+}
+
+/**
+ * Shifts the bins to a new origin, a multiple of the width. The counted values
+ * must stay in range.
+ */
+void medImageStatistics::Accumulator::moveBins(double origin)
+{
+    const int offset = static_cast<int>(std::lround((m_origin - origin) * m_inverseWidth));
+
+    std::vector<qint64> bins(binCount, 0);
+    for (int i = 0; i < binCount; ++i)
+    {
+        if (m_bins[i])
+        {
+            bins[qBound(0, i + offset, binCount - 1)] = m_bins[i];
+        }
+    }
+
+    m_bins.swap(bins);
+    m_origin = origin;
+}
+
+/**
+ * Merges the bins by pairs. The new range contains the previous one, and is
+ * extended on the lower or upper side.
+ */
+void medImageStatistics::Accumulator::doubleBinWidth(bool towardsLowerValues)
+{
+    const double width = 2 * m_width;
+    double origin;
+    if (towardsLowerValues)
+    {
+        origin = std::ceil((m_origin - binCount * m_width) / width) * width;
+    }
+    else
+    {
+        origin = std::floor(m_origin / width) * width;
+    }
+
+    std::vector<qint64> bins(binCount, 0);
+    for (int i = 0; i < binCount; ++i)
+    {
+        if (m_bins[i])
+        {
+            int bin = static_cast<int>(std::floor((m_origin + i * m_width - origin) / width));
+            bins[bin] += m_bins[i];
+        }
+    }
+
+    m_bins.swap(bins);
+    m_origin = origin;
+    m_width = width;
+    m_inverseWidth = 1 / width;
+}
+
+void medImageStatistics::Accumulator::merge(const Accumulator &other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    if (m_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    // sums of the other accumulator, centered on this one's shift
+    const double offset = other.m_shift - m_shift;
+    m_sum += other.m_sum + other.m_count * offset;
+    m_squareSum += other.m_squareSum + 2 * offset * other.m_sum + other.m_count * offset * offset;
+    m_count += other.m_count;
+    m_minimum = std::min(m_minimum, other.m_minimum);
+    m_maximum = std::max(m_maximum, other.m_maximum);
+
+    // with bins at least as wide, each of the other bins falls in a single bin
+    while (m_width < other.m_width)
+    {
+        doubleBinWidth(false);
+    }
+    include(other.m_minimum);
+    include(other.m_maximum);
+
+    for (int i = 0; i < binCount; ++i)
+    {
+        if (other.m_bins[i])
+        {
+            int bin = static_cast<int>(std::floor((other.m_origin + i * other.m_width - m_origin) * m_inverseWidth));
+            m_bins[qBound(0, bin, binCount - 1)] += other.m_bins[i];
+        }
+    }
+}
+
+medImageStatistics medImageStatistics::Accumulator::statistics() const
+{
+    medImageStatistics statistics;
+    if (m_count == 0)
+    {
+        return statistics;
+    }
+
+    statistics.count = m_count;
+    statistics.minimum = m_minimum;
+    statistics.maximum = m_maximum;
+    statistics.mean = m_shift + m_sum / m_count;
+    if (m_count > 1)
+    {
+        statistics.variance = std::max(0.0, (m_squareSum - m_sum * m_sum / m_count) / (m_count - 1));
+    }
+
+    // only the bins between the extreme values
+    int first = 0;
+    int last = binCount - 1;
+    while (first < last && m_bins[first] == 0)
+    {
+        ++first;
+    }
+    while (last > first && m_bins[last] == 0)
+    {
+        --last;
+    }
+
+    statistics.histogramOrigin = m_origin + first * m_width;
+    statistics.binWidth = m_width;
+    statistics.histogram.reserve(last - first + 1);
+    for (int i = first; i <= last; ++i)
+    {
+        statistics.histogram.append(m_bins[i]);
+    }
+    return statistics;
+}
@@ -0,0 +1,147 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QString>
+#include <QVector>
+
+#include <cmath>
+#include <vector>
+
+#include <medCoreLegacyExport.h>
+
+/**
+ * @class medImageStatistics
+ * @brief Summary statistics of the values of an image.
+ *
+ * The histogram has bins of equal width, at most Accumulator::binCount of
+ * them. For integer values spanning fewer than binCount values, there is one
+ * bin per value.
+ */
+class MEDCORELEGACY_EXPORT medImageStatistics
+{
+public:
+    medImageStatistics();
+
+    /** False when no finite value was accumulated. */
+    bool isValid() const;
+
+    /**
+     * Value below which a percentage of the values lie, interpolated in the
+     * histogram bins.
+     * @param percentage - between 0 and 100
+     */
+    double percentile(double percentage) const;
+
+    /**
+     * Same statistics, with bins merged by pairs until there are at most
+     * maximumBinCount of them.
+     */
+    medImageStatistics downsampled(int maximumBinCount) const;
+
+    bool save(const QString &fileName) const;
+    static medImageStatistics load(const QString &fileName);
+
+    qint64 count;
+    double minimum;
+    double maximum;
+    double mean;
+    double variance;
+
+    double histogramOrigin; //! lower edge of the first bin
+    double binWidth;
+    QVector<qint64> histogram;
+
+    class Accumulator;
+};
+
+/**
+ * @class medImageStatistics::Accumulator
+ * @brief Computes the statistics in a single pass over the values.
+ *
+ * The histogram range follows the values: when a value falls outside of it,
+ * the bins are moved, or merged by pairs, doubling their width, when the
+ * values do not fit in them anymore. Bin widths are powers
+ * of two and bin edges are multiples of the width, so the accumulators of
+ * separate chunks of an image can be merged exactly.
+ */
+class MEDCORELEGACY_EXPORT medImageStatistics::Accumulator
+{
+public:
+    static const int binCount = 4096;
+
+    /**
+     * @param integerValues - bins are never narrower than 1
+     */
+    explicit Accumulator(bool integerValues = false);
+
+    /**
+     * Range the values are known to lie in, such as the range of the pixel
+     * type. Integer ranges of at most binCount values get one bin per value
+     * from the start.
+     */
+    void setValueRange(double lowest, double highest);
+
+    inline void add(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            return;
+        }
+        if (m_count == 0)
+        {
+            initialize(value);
+        }
+
+        const double centered = value - m_shift;
+        m_count++;
+        m_sum += centered;
+        m_squareSum += centered * centered;
+        m_minimum = std::min(m_minimum, value);
+        m_maximum = std::max(m_maximum, value);
+
+        double position = (value - m_origin) * m_inverseWidth;
+        if (position < 0 || position >= binCount)
+        {
+            include(value);
+            position = std::min((value - m_origin) * m_inverseWidth, binCount - 1.0);
+        }
+        m_bins[static_cast<int>(position)]++;
+    }
+
+    void merge(const Accumulator &other);
+
+    medImageStatistics statistics() const;
+
+private:
+    void initialize(double value);
+    void include(double value);
+    void moveBins(double origin);
+    void doubleBinWidth(bool towardsLowerValues);
+
+    bool m_integerValues;
+    qint64 m_count;
+    double m_shift;        // first value, subtracted for the accuracy of the sums
+    double m_sum;
+    double m_squareSum;
+    double m_minimum;
+    double m_maximum;
+
+    double m_origin;
+    double m_width;
+    double m_inverseWidth;
+    std::vector<qint64> m_bins;
+
+    bool m_rangeKnown;
+    double m_rangeLowest;
+};
@@ -0,0 +1,212 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medThumbnailRenderer.h>
+
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// rectangle of the given aspect ratio, centered in the thumbnail
+QRect fittedRect(double physicalWidth, double physicalHeight, const QSize &size)
+{
+    if (physicalWidth <= 0 || physicalHeight <= 0)
+    {
+        return QRect(QPoint(0, 0), size);
+    }
+
+    double scale = std::min(size.width() / physicalWidth, size.height() / physicalHeight);
+    int width  = qBound(1, static_cast<int>(std::lround(physicalWidth * scale)), size.width());
+    int height = qBound(1, static_cast<int>(std::lround(physicalHeight * scale)), size.height());
+    return QRect((size.width() - width) / 2, (size.height() - height) / 2, width, height);
+}
+
+// window of the slice values, robust to a few extreme values
+void percentileWindow(const QVector<float> &values, float &lower, float &upper)
+{
+    // a sample is enough for the percentiles
+    const int sampleCount = std::min(values.size(), 65536);
+    const double stride = static_cast<double>(values.size()) / sampleCount;
+    std::vector<float> sample;
+    sample.reserve(sampleCount);
+    for (int i = 0; i < sampleCount; ++i)
+    {
+        float value = values[static_cast<int>(i * stride)];
+        if (std::isfinite(value))
+        {
+            sample.push_back(value);
+        }
+    }
+
+    lower = upper = 0;
+    if (sample.empty())
+    {
+        return;
+    }
+
+    auto lowerIt = sample.begin() + sample.size() / 100;
+    auto upperIt = sample.begin() + (sample.size() * 99) / 100;
+    std::nth_element(sample.begin(), lowerIt, sample.end());
+    lower = *lowerIt;
+    std::nth_element(sample.begin(), upperIt, sample.end());
+    upper = *upperIt;
+
+    if (upper <= lower)
+    {
+        auto range = std::minmax_element(sample.begin(), sample.end());
+        lower = *range.first;
+        upper = *range.second;
+    }
+}
+
+}
+
+QImage medThumbnailRenderer::renderSlice(const QVector<float> &values, int width, int height,
+                                         double spacingX, double spacingY, const QSize &size)
+{
+    QImage thumbnail(size, QImage::Format_RGB32);
+    thumbnail.fill(Qt::black);
+    if (width <= 0 || height <= 0 || values.size() < width * height || size.isEmpty())
+    {
+        return thumbnail;
+    }
+
+    float lower, upper;
+    percentileWindow(values, lower, upper);
+    const float scale = (upper > lower) ? 255.0f / (upper - lower) : 0.0f;
+
+    // each thumbnail pixel averages the slice pixels it covers
+    const QRect target = fittedRect(width * spacingX, height * spacingY, size);
+    for (int y = 0; y < target.height(); ++y)
+    {
+        // first slice row at the bottom of the thumbnail
+        const int row = target.height() - 1 - y;
+        const int firstRow = row * height / target.height();
+        const int lastRow = std::max(firstRow + 1, (row + 1) * height / target.height());
+
+        QRgb *line = reinterpret_cast<QRgb *>(thumbnail.scanLine(target.top() + y)) + target.left();
+        for (int x = 0; x < target.width(); ++x)
+        {
+            const int firstColumn = x * width / target.width();
+            const int lastColumn = std::max(firstColumn + 1, (x + 1) * width / target.width());
+
+            double sum = 0;
+            for (int j = firstRow; j < lastRow; ++j)
+            {
+                const float *value = values.constData() + static_cast<qint64>(j) * width;
+                for (int i = firstColumn; i < lastColumn; ++i)
+                {
+                    sum += value[i];
+                }
+            }
+            float mean = static_cast<float>(sum / ((lastRow - firstRow) * (lastColumn - firstColumn)));
+            int gray = std::isfinite(mean) ? qBound(0, static_cast<int>((mean - lower) * scale), 255) : 0;
+            line[x] = qRgb(gray, gray, gray);
+        }
+    }
+
+    return thumbnail;
+}
+
+QImage medThumbnailRenderer::renderProjection(const QVector<QVector3D> &points,
+                                              const QVector< QPair<int, int> > &segments,
+                                              ColorMode mode, const QSize &size)
+{
+    QImage thumbnail(size, QImage::Format_RGB32);
+    thumbnail.fill(Qt::black);
+    if (points.isEmpty() || segments.isEmpty() || size.isEmpty())
+    {
+        return thumbnail;
+    }
+
+    QVector3D minimum = points[0];
+    QVector3D maximum = points[0];
+    for (const QVector3D &point : points)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            minimum[axis] = std::min(minimum[axis], point[axis]);
+            maximum[axis] = std::max(maximum[axis], point[axis]);
+        }
+    }
+
+    // seen along the axis of smallest extent
+    const QVector3D extent = maximum - minimum;
+    int depthAxis = 2;
+    if (extent[0] <= extent[1] && extent[0] <= extent[2])
+    {
+        depthAxis = 0;
+    }
+    else if (extent[1] <= extent[2])
+    {
+        depthAxis = 1;
+    }
+    const int axisX = (depthAxis == 0) ? 1 : 0;
+    const int axisY = (depthAxis == 2) ? 1 : 2;
+
+    const QRect target = fittedRect(std::max(extent[axisX], 1e-6f), std::max(extent[axisY], 1e-6f), size);
+    const double scaleX = (target.width() - 1) / std::max(extent[axisX], 1e-6f);
+    const double scaleY = (target.height() - 1) / std::max(extent[axisY], 1e-6f);
+    auto project = [&](const QVector3D &point)
+    {
+        return QPointF(target.left() + (point[axisX] - minimum[axisX]) * scaleX,
+                       target.bottom() - (point[axisY] - minimum[axisY]) * scaleY);
+    };
+
+    // back to front, subsampled when there are too many segments
+    const int stride = std::max(1, segments.size() / maximumSegmentCount());
+    QVector< QPair<float, int> > order;
+    order.reserve(segments.size() / stride + 1);
+    for (int i = 0; i < segments.size(); i += stride)
+    {
+        float depth = points[segments[i].first][depthAxis] + points[segments[i].second][depthAxis];
+        order.append(qMakePair(depth, i));
+    }
+    std::sort(order.begin(), order.end());
+
+    QPainter painter(&thumbnail);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    const float depthRange = std::max(extent[depthAxis], 1e-6f);
+    for (const QPair<float, int> &entry : order)
+    {
+        const QVector3D &p1 = points[segments[entry.second].first];
+        const QVector3D &p2 = points[segments[entry.second].second];
+
+        QColor color;
+        if (mode == ColorByDirection)
+        {
+            QVector3D direction = (p2 - p1).normalized();
+            color = QColor::fromRgbF(std::abs(direction.x()), std::abs(direction.y()), std::abs(direction.z()));
+        }
+        else
+        {
+            float depth = (entry.first * 0.5f - minimum[depthAxis]) / depthRange;
+            int gray = qBound(0, static_cast<int>(64 + 191 * depth), 255);
+            color = QColor(gray, gray, gray);
+        }
+
+        painter.setPen(color);
+        painter.drawLine(project(p1), project(p2));
+    }
+
+    return thumbnail;
+}
+
+int medThumbnailRenderer::maximumSegmentCount()
+{
+    return 200000;
+}
@@ -0,0 +1,62 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QImage>
+#include <QPair>
+#include <QSize>
+#include <QVector>
+#include <QVector3D>
+
+#include <medCoreLegacyExport.h>
+
+/**
+ * @class medThumbnailRenderer
+ * @brief Renders thumbnails on the CPU, without views nor OpenGL.
+ *
+ * Used by the data types to implement medAbstractData::renderThumbnail().
+ * All the methods can be called from any thread.
+ */
+class MEDCORELEGACY_EXPORT medThumbnailRenderer
+{
+public:
+    enum ColorMode
+    {
+        ColorByDirection, //! segments colored by their orientation, as fibers usually are
+        ShadeByDepth      //! gray levels, brighter for the segments in front
+    };
+
+    /**
+     * Renders a slice of scalar values, windowed between the 1st and 99th
+     * percentiles, keeping its physical aspect ratio.
+     * @param values - width * height values, row by row, the first row at the bottom
+     * @param spacingX, spacingY - size of the pixels along the rows and columns
+     */
+    static QImage renderSlice(const QVector<float> &values, int width, int height,
+                              double spacingX, double spacingY, const QSize &size);
+
+    /**
+     * Renders the orthographic projection of segments along the axis on
+     * which they extend the least.
+     * @param segments - pairs of indices in points
+     */
+    static QImage renderProjection(const QVector<QVector3D> &points,
+                                   const QVector< QPair<int, int> > &segments,
+                                   ColorMode mode, const QSize &size);
+
+    /**
+     * Highest number of segments drawn by renderProjection(). Data types can
+     * subsample their segments accordingly.
+     */
+    static int maximumSegmentCount();
+};
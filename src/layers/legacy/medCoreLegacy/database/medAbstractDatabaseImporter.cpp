@@ -20,31 +20,74 @@
 #include <medAbstractImageData.h>
 #include <medDatabaseController.h>
 #include <medGlobalDefs.h>
+#include <medJobScheduler.h>
 #include <medMetaDataKeys.h>
+#include <medReaderDispatcher.h>
 #include <medStorage.h>
 
+#include <QtConcurrent>
+
+/**
+* Header of one input file, read during the filtering step of importFile().
+**/
+struct medImportHeader
+{
+    QString filePath;
+    dtkSmartPointer<medAbstractData> data;
+    bool isEmpty = false;
+};
+
+/**
+* One output volume of importFile(), aggregating one or many input files.
+**/
+struct medImportVolume
+{
+    enum Status { Pending, ReadFailed, WriteFailed, Skipped, Ready };
+
+    QString aggregatedFileName;
+    QStringList filesPaths;
+    QString patientID;
+    QString seriesID;
+    // unique within the database and the other volumes of the import
+    QString seriesDescription;
+    dtkSmartPointer<medAbstractData> data;
+    QImage thumbnail;
+    Status status = Pending;
+};
+
 class medAbstractDatabaseImporterPrivate
 {
 public:
     QString file;
     dtkSmartPointer<medAbstractData> data;
     static QMutex mutex;
-    bool isCancelled;
+    // series names given to volumes of the running imports which are not
+    // in the database yet, guarded by the mutex
+    static QSet<QString> seriesNamesInFlight;
+    // set by onCancel, read by the import workers
+    QAtomicInt isCancelled;
     bool indexWithoutImporting;
     medDataIndex index;
 
     QMap<int, QString> volumeIdToImageFile;
 
+    // thumbnails already rendered by the workers
+    QHash<medAbstractData*, QImage> renderedThumbnails;
+
+    // remembers the readers selected during this import
+    medReaderDispatcher readerDispatcher;
+
     QUuid uuid;
 };
 
-QMutex medAbstractDatabaseImporterPrivate::mutex;
+QMutex medAbstractDatabaseImporterPrivate::mutex ( QMutex::Recursive );
+QSet<QString> medAbstractDatabaseImporterPrivate::seriesNamesInFlight;
 
 //-----------------------------------------------------------------------------------------------------------
 
 medAbstractDatabaseImporter::medAbstractDatabaseImporter ( const QString& file, const QUuid& uuid, bool indexWithoutImporting) : medJobItemL(), d ( new medAbstractDatabaseImporterPrivate )
 {
-    d->isCancelled = false;
+    d->isCancelled.storeRelease ( 0 );
     d->file = file;
     d->data = nullptr;
     d->indexWithoutImporting = indexWithoutImporting;
@@ -55,7 +98,7 @@ medAbstractDatabaseImporter::medAbstractDatabaseImporter ( const QString& file,
 
 medAbstractDatabaseImporter::medAbstractDatabaseImporter ( medAbstractData* medData, const QUuid& uuid, bool indexWithoutImporting) : medJobItemL(), d ( new medAbstractDatabaseImporterPrivate )
 {
-    d->isCancelled = false;
+    d->isCancelled.storeRelease ( 0 );
     d->data = medData;
     d->file = QString("");
     d->indexWithoutImporting = indexWithoutImporting;
@@ -84,7 +127,7 @@ QString medAbstractDatabaseImporter::file ( void )
 **/
 bool medAbstractDatabaseImporter::isCancelled ( void )
 {
-    return d->isCancelled;
+    return d->isCancelled.loadAcquire();
 }
 
 /**
@@ -141,14 +184,16 @@ void medAbstractDatabaseImporter::internalRun ( void )
 
 void medAbstractDatabaseImporter::importFile ( void )
 {
-    QMutexLocker locker ( &d->mutex );
-
     /* The idea of this algorithm can be summarized in 3 steps:
      * 1. Get a list of all the files that will (try to) be imported or indexed
      * 2. Filter files that cannot be read, or won't be possible to write afterwards, or are already in the db
      * 3. Fill files metadata, write them to the db, and populate db tables
      *
      * note that depending on the input files, they might be aggregated by volume
+     *
+     * Reading headers (step 2) and reading/writing volumes (step 3) are spread
+     * over worker threads, only the accesses to the database are serialized
+     * through the static mutex.
      */
 
     // 1) Obtain a list of all the files that are going to be processed
@@ -163,8 +208,6 @@ void medAbstractDatabaseImporter::importFile ( void )
     QMap<QString, QString> imagesGroupedByPatient;
     QMap<QString, QString> imagesGroupedBySeriesId;
 
-    int currentFileNumber = 0; // this variable will be used only for calculating progress
-
     // if importing, and depending on the input files, they might be aggregated
     // that is: files corresponding to the same volume will be written
     // in a single output meta file (e.g. .mha)
@@ -174,11 +217,55 @@ void medAbstractDatabaseImporter::importFile ( void )
 
     // 2) Select (by filtering) files to be imported
     //
-    // In this first loop we read the headers of all the images to be imported
+    // In this first stage we read the headers of all the images to be imported
     // and check if we don't have any problem in reading the file, the header
     // or in selecting a proper format to store the new file afterwards
     // new files ARE NOT written in the database yet, but are stored in a map for writing in a posterior step
 
+    // 2.1) Read file information, just the header not the whole file.
+    // Workers pick the next unread file until the list is exhausted.
+    QVector<medImportHeader> headers ( fileList.count() );
+    QAtomicInt nextFileNumber ( 0 );
+    QAtomicInt filesReadCount ( 0 );
+
+    QThreadPool headerPool;
+    headerPool.setMaxThreadCount ( importerThreadCount() );
+
+    for ( int worker = 0; worker < headerPool.maxThreadCount(); ++worker )
+    {
+        QtConcurrent::run ( &headerPool, [&]()
+        {
+            int currentFileNumber;
+            while ( !d->isCancelled.loadAcquire() &&
+                    ( currentFileNumber = nextFileNumber.fetchAndAddOrdered ( 1 ) ) < fileList.count() )
+            {
+                medImportHeader &header = headers[currentFileNumber];
+                QFileInfo fileInfo ( fileList[currentFileNumber] );
+                header.filePath = fileInfo.filePath();
+                header.isEmpty = ( fileInfo.size() == 0 );
+
+                if ( !header.isEmpty )
+                {
+                    bool readOnlyImageInformation = true;
+                    header.data = tryReadImages ( QStringList ( header.filePath ), readOnlyImageInformation );
+                }
+
+                int filesRead = filesReadCount.fetchAndAddOrdered ( 1 ) + 1;
+                emit progress ( this, ( ( qreal ) filesRead/ ( qreal ) fileList.count() ) * 50.0 ); //TODO: reading and filtering represents 50% of the importing process?
+            }
+        });
+    }
+    headerPool.waitForDone();
+
+    // some checks to see if the user cancelled or something failed
+    if ( d->isCancelled.loadAcquire() )
+    {
+        emit showError (tr ( "User cancelled import process" ), 5000 );
+        emit dataImported(medDataIndex(), d->uuid);
+        emit cancelled ( this );
+        return;
+    }
+
     QString tmpPatientId;
     QString currentPatientId = "";
     QString patientID;
@@ -190,23 +277,13 @@ void medAbstractDatabaseImporter::importFile ( void )
     bool atLeastOneImportSucceeded = false;
     bool atLeastOneImportError = false;
 
-    for( QString file: fileList )
+    // 2.2) Group the headers by volume, in the (sorted) order of the file list
+    for( const medImportHeader &header : headers )
     {
-        if ( d->isCancelled ) // check if user canceled the process
-            break;
-
-        emit progress ( this, ( ( qreal ) currentFileNumber/ ( qreal ) fileList.count() ) * 50.0 ); //TODO: reading and filtering represents 50% of the importing process?
-
-        currentFileNumber++;
-
-        QFileInfo fileInfo ( file );
-        if (fileInfo.size() != 0)
+        QFileInfo fileInfo ( header.filePath );
+        if ( !header.isEmpty )
         {
-            dtkSmartPointer<medAbstractData> medData;
-
-            // 2.1) Try reading file information, just the header not the whole file
-            bool readOnlyImageInformation = true;
-            medData = tryReadImages ( QStringList ( fileInfo.filePath() ), readOnlyImageInformation );
+            dtkSmartPointer<medAbstractData> medData = header.data;
 
             if ( !medData )
             {
@@ -218,7 +295,7 @@ void medAbstractDatabaseImporter::importFile ( void )
                 continue;
             }
 
-            // 2.2) Fill missing metadata
+            // 2.3) Fill missing metadata
             populateMissingMetadata ( medData, med::smartBaseName(fileInfo.fileName()));
             QString patientName = medMetaDataKeys::PatientName.getFirstValue(medData).simplified();
             QString birthDate = medMetaDataKeys::BirthDate.getFirstValue(medData);
@@ -228,6 +305,7 @@ void medAbstractDatabaseImporter::importFile ( void )
             {
                 currentPatientId = tmpPatientId;
 
+                QMutexLocker locker ( &d->mutex );
                 patientID = getPatientID(patientName, birthDate);
             }
 
@@ -243,7 +321,7 @@ void medAbstractDatabaseImporter::importFile ( void )
             else
                 medData->setMetaData ( medMetaDataKeys::SeriesID.key(), QStringList() << currentSeriesId );
 
-            // 2.3) Generate an unique id for each volume
+            // 2.4) Generate an unique id for each volume
             // all images of the same volume should share the same id
             QString volumeId = generateUniqueVolumeId ( medData );
 
@@ -254,7 +332,7 @@ void medAbstractDatabaseImporter::importFile ( void )
                 volumeNumber++;
             }
 
-            // 2.3) a) Determine future file name and path based on patient/study/series/image
+            // 2.4) a) Determine future file name and path based on patient/study/series/image
             // i.e.: where we will write the imported image
             QString imageFileName = determineFutureImageFileName ( medData, volumeUniqueIdToVolumeNumber[volumeId] );
 #ifdef Q_OS_WIN32
@@ -266,7 +344,7 @@ void medAbstractDatabaseImporter::importFile ( void )
                 return;
             }
 #endif
-            // 2.3) b) Find the proper extension according to the type of the data
+            // 2.4) b) Find the proper extension according to the type of the data
             // i.e.: in which format we will write the file in our database
             QString futureExtension  = determineFutureImageExtensionByDataType ( medData );
 
@@ -278,7 +356,7 @@ void medAbstractDatabaseImporter::importFile ( void )
 
             imageFileName = imageFileName + futureExtension;
 
-            // 2.3) c) Add the image to a map for writing them all in the database in a posterior step
+            // 2.4) c) Add the image to a map for writing them all in the database in a posterior step
             imagesGroupedByVolume[imageFileName] << fileInfo.filePath();
             imagesGroupedByPatient[imageFileName] = patientID;
             imagesGroupedBySeriesId[imageFileName] = currentSeriesId;
@@ -291,14 +369,8 @@ void medAbstractDatabaseImporter::importFile ( void )
         }
     }
 
-    // some checks to see if the user cancelled or something failed
-    if ( d->isCancelled )
-    {
-        emit showError (tr ( "User cancelled import process" ), 5000 );
-        emit dataImported(medDataIndex(), d->uuid);
-        emit cancelled ( this );
-        return;
-    }
+    // headers are not needed anymore, release them before reading the volumes
+    headers.clear();
 
     // from now on the process cannot be cancelled
     emit disableCancel ( this );
@@ -323,74 +395,85 @@ void medAbstractDatabaseImporter::importFile ( void )
         qDebug() << "Chosen directory contains " << imagesGroupedByVolume.size() << " files";
 
     int imagesCount = imagesGroupedByVolume.count(); // used only to calculate progress
-    int currentImageIndex = 0; // used only to calculate progress
-
-    medDataIndex index; //stores the last volume's index to be emitted on success
 
-    // final loop: re-read, re-populate and write to db
-    for ( ; it != imagesGroupedByVolume.end(); it++ )
+    // Series names of the volumes are chosen here, before the workers start,
+    // as none of the volumes is in the database yet to make them unique.
+    // They stay reserved, also against the other imports, until the volumes
+    // are in the database.
+    QVector<medImportVolume> volumes;
+    volumes.reserve ( imagesCount );
+    for ( ; it != imagesGroupedByVolume.end(); it++, itPat++, itSer++ )
     {
-        emit progress ( this, ( ( qreal ) currentImageIndex/ ( qreal ) imagesCount ) * 50.0 + 50.0 ); // 50? I do not think that reading all the headers is half the job...
+        medImportVolume volume;
+        volume.aggregatedFileName = it.key(); // note that this file might be aggregating more than one input files
+        volume.filesPaths = it.value();       // input files being aggregated, might be only one or many
+        volume.patientID = itPat.value();
+        volume.seriesID = itSer.value();
+        volume.seriesDescription = reserveSeriesName ( med::smartBaseName ( QFileInfo ( volume.filesPaths[0] ).fileName() ) );
+        volumes << volume;
+    }
+
+    // 3.2) Read the whole images and write them in the storage concurrently.
+    // Full volumes are memory hungry, so fewer of them are in flight than headers.
+    QThreadPool volumePool;
+    volumePool.setMaxThreadCount ( qMax ( 1, importerThreadCount() / 2 ) );
 
-        currentImageIndex++;
+    QVector< QFuture<void> > volumeFutures;
+    volumeFutures.reserve ( imagesCount );
+    for ( int i = 0; i < imagesCount; ++i )
+    {
+        medImportVolume *volume = &volumes[i];
+        volumeFutures << QtConcurrent::run ( &volumePool, [this, volume]()
+        {
+            readAndWriteVolume ( *volume );
+        });
+    }
 
-        QString aggregatedFileName = it.key(); // note that this file might be aggregating more than one input files
-        QStringList filesPaths = it.value();   // input files being aggregated, might be only one or many
-        patientID = itPat.value();
-        QString seriesID = itSer.value();
+    medDataIndex index; //stores the last volume's index to be emitted on success
 
-        dtkSmartPointer<medAbstractData> imagemedData;
+    // 3.3) Populate the database in the order of the volumes, while the
+    // following volumes are still being read and written by the workers
+    for ( int i = 0; i < imagesCount; ++i )
+    {
+        emit progress ( this, ( ( qreal ) i/ ( qreal ) imagesCount ) * 50.0 + 50.0 ); // 50? I do not think that reading all the headers is half the job...
 
-        // 3.2) Try to read the whole image, not just the header
-        bool readOnlyImageInformation = false;
-        imagemedData = tryReadImages ( filesPaths, readOnlyImageInformation );
+        volumeFutures[i].waitForFinished();
+        medImportVolume &volume = volumes[i];
 
-        if ( imagemedData )
+        // the following volumes may already be in the storage, so a volume
+        // which cannot be read is skipped instead of aborting the import
+        if ( volume.status == medImportVolume::ReadFailed )
         {
-            // 3.3) a) re-populate missing metadata
-            // as files might be aggregated we use the aggregated file name as SeriesDescription (if not provided, of course)
-            QFileInfo imagefileInfo ( filesPaths[0] );
-            populateMissingMetadata ( imagemedData, med::smartBaseName(imagefileInfo.fileName()) );
-            imagemedData->setMetaData ( medMetaDataKeys::PatientID.key(), QStringList() << patientID );
-            imagemedData->setMetaData ( medMetaDataKeys::SeriesID.key(), QStringList() << seriesID );
-
-            // 3.3) b) now we are able to add some more metadata
-            addAdditionalMetaData ( imagemedData, aggregatedFileName, filesPaths );
+            qWarning() << "Could not repopulate data!";
+            emit showError (tr ( "Could not read data: " ) + volume.filesPaths[0], 5000 );
+            continue;
         }
-        else
+        else if ( volume.status == medImportVolume::WriteFailed )
         {
-            qWarning() << "Could not repopulate data!";
-            emit showError (tr ( "Could not read data: " ) + filesPaths[0], 5000 );
-            emit dataImported(medDataIndex(), d->uuid);
-            emit failure(this);
-            return;
+            emit showError (tr ( "Could not save data file: " ) + volume.filesPaths[0], 5000 );
+            volume.data = nullptr;
+            continue;
         }
-
-        if ( !d->indexWithoutImporting )
+        else if ( volume.status != medImportVolume::Ready )
         {
-            // create location to store file
-            QFileInfo fileInfo ( medStorage::dataLocation() + aggregatedFileName );
-            if ( !fileInfo.dir().exists() && !medStorage::mkpath ( fileInfo.dir().path() ) )
-            {
-                qDebug() << "Cannot create directory: " << fileInfo.dir().path();
-                continue;
-            }
-
-            // now writing file
-            bool writeSuccess = tryWriteImage ( fileInfo.filePath(), imagemedData );
-
-            if ( !writeSuccess )
-            {
-                emit showError (tr ( "Could not save data file: " ) + filesPaths[0], 5000 );
-                continue;
-            }
+            volume.data = nullptr;
+            continue;
         }
+
         atLeastOneImportSucceeded = true;
 
         // and finally we populate the database
-        QFileInfo aggregatedFileNameFileInfo ( aggregatedFileName );
+        QFileInfo aggregatedFileNameFileInfo ( volume.aggregatedFileName );
         QString pathToStoreThumbnails = aggregatedFileNameFileInfo.dir().path() + "/" + aggregatedFileNameFileInfo.completeBaseName() + "/";
-        index = this->populateDatabaseAndGenerateThumbnails ( imagemedData, pathToStoreThumbnails );
+        d->renderedThumbnails.insert ( volume.data, volume.thumbnail );
+        {
+            QMutexLocker locker ( &d->mutex );
+            index = this->populateDatabaseAndGenerateThumbnails ( volume.data, pathToStoreThumbnails );
+        }
+        d->renderedThumbnails.remove ( volume.data );
+
+        // release the volume as soon as it is in the database
+        volume.data = nullptr;
 
         if(!d->uuid.isNull())
         {
@@ -400,11 +483,13 @@ void medAbstractDatabaseImporter::importFile ( void )
         {
             emit dataImported(index);
         }
-
-        itPat++;
-        itSer++;
     } // end of the final loop
 
+    for ( const medImportVolume &volume : volumes )
+    {
+        releaseSeriesName ( volume.seriesDescription );
+    }
+
     if ( ! atLeastOneImportSucceeded) {
         emit progress ( this,100 );
         emit dataImported(medDataIndex(), d->uuid);
@@ -418,6 +503,102 @@ void medAbstractDatabaseImporter::importFile ( void )
     emit success ( this );
 }
 
+/**
+* Reads the whole volume, re-populates its metadata and writes it in the
+* storage (if importing), and renders its thumbnail. Runs in the import
+* worker threads, database accesses are serialized.
+* @param volume - the volume to process, its status and data are updated
+**/
+void medAbstractDatabaseImporter::readAndWriteVolume ( medImportVolume& volume )
+{
+    // 3.2) a) Try to read the whole image, not just the header
+    bool readOnlyImageInformation = false;
+    volume.data = tryReadImages ( volume.filesPaths, readOnlyImageInformation );
+
+    if ( !volume.data )
+    {
+        volume.status = medImportVolume::ReadFailed;
+        return;
+    }
+
+    // 3.2) b) re-populate missing metadata
+    // as files might be aggregated we use the aggregated file name as SeriesDescription (if not provided, of course)
+    populateMissingMetadata ( volume.data, volume.seriesDescription, true );
+    volume.data->setMetaData ( medMetaDataKeys::PatientID.key(), QStringList() << volume.patientID );
+    volume.data->setMetaData ( medMetaDataKeys::SeriesID.key(), QStringList() << volume.seriesID );
+
+    // 3.2) c) now we are able to add some more metadata
+    addAdditionalMetaData ( volume.data, volume.aggregatedFileName, volume.filesPaths );
+
+    if ( !d->indexWithoutImporting )
+    {
+        // create location to store file
+        QFileInfo fileInfo ( medStorage::dataLocation() + volume.aggregatedFileName );
+        if ( !fileInfo.dir().exists() && !medStorage::mkpath ( fileInfo.dir().path() ) )
+        {
+            qDebug() << "Cannot create directory: " << fileInfo.dir().path();
+            volume.status = medImportVolume::Skipped;
+            return;
+        }
+
+        // now writing file
+        if ( !tryWriteImage ( fileInfo.filePath(), volume.data ) )
+        {
+            volume.status = medImportVolume::WriteFailed;
+            return;
+        }
+    }
+
+    // 3.2) d) render the thumbnail and compute the statistics on the CPU, in parallel with the other volumes
+    volume.thumbnail = volume.data->renderThumbnail ( med::defaultThumbnailSize );
+    if ( medAbstractImageData *imageData = dynamic_cast<medAbstractImageData*> ( volume.data.data() ) )
+    {
+        imageData->statistics();
+    }
+
+    volume.status = medImportVolume::Ready;
+}
+
+/**
+* Returns a series name unused in the database and not reserved by a running
+* import, and reserves it until @releaseSeriesName is called.
+* @param seriesName - the series name
+**/
+QString medAbstractDatabaseImporter::reserveSeriesName ( const QString& seriesName )
+{
+    QMutexLocker locker ( &d->mutex );
+
+    QString newSeriesName = seriesName;
+    int suffix = 0;
+    while ( d->seriesNamesInFlight.contains ( newSeriesName ) || ensureUniqueSeriesName ( newSeriesName ) != newSeriesName )
+    {
+        suffix++;
+        newSeriesName = seriesName + "_" + QString::number ( suffix );
+    }
+    d->seriesNamesInFlight.insert ( newSeriesName );
+
+    return newSeriesName;
+}
+
+/**
+* Releases a series name reserved by @reserveSeriesName, once its series is
+* in the database or will not be.
+**/
+void medAbstractDatabaseImporter::releaseSeriesName ( const QString& seriesName )
+{
+    QMutexLocker locker ( &d->mutex );
+    d->seriesNamesInFlight.remove ( seriesName );
+}
+
+/**
+* Returns the number of worker threads used by one import, shared with the
+* other running jobs.
+**/
+int medAbstractDatabaseImporter::importerThreadCount ( void )
+{
+    return medJobScheduler::instance()->threadsPerJob();
+}
+
 void medAbstractDatabaseImporter::importData()
 {
     QMutexLocker locker ( &d->mutex );
@@ -431,7 +612,7 @@ void medAbstractDatabaseImporter::importData()
 
     // Update name of the series if a permanent data has this name already
     QString seriesDescription = d->data->metadata(medMetaDataKeys::SeriesDescription.key());
-    QString newSeriesDescription = ensureUniqueSeriesName(seriesDescription);
+    QString newSeriesDescription = reserveSeriesName(seriesDescription);
     d->data->setMetaData(medMetaDataKeys::SeriesDescription.key(), QStringList() << newSeriesDescription );
 
     if ( !d->data->hasMetaData ( medMetaDataKeys::FilePaths.key() ) )
@@ -473,6 +654,7 @@ void medAbstractDatabaseImporter::importData()
             if ( !medStorage::mkpath ( medStorage::dataLocation() + subDirName ) )
             {
                 qWarning() << "Unable to create directory for images";
+                releaseSeriesName(newSeriesDescription);
                 emit failure ( this );
                 emit dataImported(medDataIndex(), d->uuid);
                 return ;
@@ -503,6 +685,7 @@ void medAbstractDatabaseImporter::importData()
 
     // Now, populate the database
     medDataIndex index = this->populateDatabaseAndGenerateThumbnails (  d->data, thumb_dir );
+    releaseSeriesName(newSeriesDescription);
 
     emit progress(this, 100);
     emit success(this);
@@ -518,7 +701,7 @@ void medAbstractDatabaseImporter::importData()
 
 void medAbstractDatabaseImporter::onCancel ( QObject* )
 {
-    d->isCancelled = true;
+    d->isCancelled.storeRelease ( 1 );
 }
 
 //-----------------------------------------------------------------------------------------------------------
@@ -528,8 +711,10 @@ void medAbstractDatabaseImporter::onCancel ( QObject* )
 * If metadata is not present it's filled with default or empty values.
 * @param medData - the object whose missing metadata will be filled
 * @param seriesDescription - string used to fill SeriesDescription field if not present
+* @param uniqueSeriesDescription - true if seriesDescription is already unique
 **/
-void medAbstractDatabaseImporter::populateMissingMetadata ( medAbstractData* medData, const QString seriesDescription )
+void medAbstractDatabaseImporter::populateMissingMetadata ( medAbstractData* medData, const QString seriesDescription,
+                                                            bool uniqueSeriesDescription )
 {
     if ( !medData )
     {
@@ -552,7 +737,15 @@ void medAbstractDatabaseImporter::populateMissingMetadata ( medAbstractData* med
         // it could be that we have already another image with this characteristics
         // so we would like to check whether the image filename is on the db
         // and if so we would add some suffix to distinguish it
-        newSeriesDescription = ensureUniqueSeriesName(seriesDescription);
+        if ( uniqueSeriesDescription )
+        {
+            newSeriesDescription = seriesDescription;
+        }
+        else
+        {
+            QMutexLocker locker ( &d->mutex );
+            newSeriesDescription = ensureUniqueSeriesName(seriesDescription);
+        }
     }
     else
     {
@@ -678,7 +871,11 @@ void medAbstractDatabaseImporter::populateMissingMetadata ( medAbstractData* med
 **/
 QString medAbstractDatabaseImporter::generateThumbnail ( medAbstractData* medData, QString pathToStoreThumbnail )
 {
-    QImage thumbnail = medData->generateThumbnail(med::defaultThumbnailSize);
+    QImage thumbnail = d->renderedThumbnails.value(medData);
+    if ( thumbnail.isNull() )
+    {
+        thumbnail = medData->generateThumbnail(med::defaultThumbnailSize);
+    }
     QString thumbnailPath = pathToStoreThumbnail + "thumbnail.png";
     QString fullThumbnailPath = medStorage::dataLocation() + thumbnailPath;
 
@@ -697,9 +894,39 @@ QString medAbstractDatabaseImporter::generateThumbnail ( medAbstractData* medDat
     return thumbnailPath;
 }
 
+//-----------------------------------------------------------------------------------------------------------
+/**
+* Saves the statistics of an image next to its thumbnail, with a histogram
+* small enough to be read back quickly when the series is opened.
+* @param medData - @medAbstractData object whose statistics will be saved
+* @param pathToStoreStatistics - path where the statistics will be stored
+**/
+void medAbstractDatabaseImporter::storeStatistics ( medAbstractData* medData, QString pathToStoreStatistics )
+{
+    medAbstractImageData *imageData = dynamic_cast<medAbstractImageData*> ( medData );
+    if ( !imageData )
+    {
+        return;
+    }
+
+    medImageStatistics statistics = imageData->statistics();
+    if ( !statistics.isValid() )
+    {
+        return;
+    }
+
+    QString fullStatisticsPath = medStorage::dataLocation() + pathToStoreStatistics + "statistics.dat";
+    if ( ! statistics.downsampled ( 1024 ).save ( fullStatisticsPath ) )
+    {
+        qWarning("medAbstractDatabaseImporter: Saving statistics to %s failed.", qPrintable(fullStatisticsPath));
+    }
+}
+
 //-----------------------------------------------------------------------------------------------------------
 /**
 * Tries to find a @dtkAbstractDataReader able to read input file/s.
+* Readers selected for previous files of the import are tried first
+* (see @medReaderDispatcher).
 * @param filename - Input file/s we would like to find a reader for
 * @return a proper reader if found, nullptr otherwise
 **/
@@ -707,26 +934,15 @@ dtkSmartPointer<dtkAbstractDataReader> medAbstractDatabaseImporter::getSuitableR
 {
     QList<QString> readers = medAbstractDataFactory::instance()->readers();
 
+    // called by the import workers, the import reports its failure itself
+    // when no file could be read
     if ( readers.size() ==0 )
     {
         emit showError (tr ( "No reader plugin" ), 5000 );
-        emit failure ( this );
         return nullptr;
     }
 
-    dtkSmartPointer<dtkAbstractDataReader> dataReader;
-    for (int i=0; i<readers.size(); i++)
-    {
-        dataReader = medAbstractDataFactory::instance()->readerSmartPointer(readers[i]);
-        dataReader->enableDeferredDeletion(false);
-
-        if (dataReader->canRead(filename))
-        {
-            return dataReader;
-        }
-    }
-
-    return nullptr;
+    return d->readerDispatcher.reader(filename);
 }
 
 //-----------------------------------------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 
 class medAbstractDatabaseImporterPrivate;
 class medAbstractData;
+struct medImportVolume;
 
 /**
 * @class medAbstractDatabaseImporter
@@ -74,7 +75,8 @@ protected:
     QString callerUuid ( void );
     medDataIndex index(void) const;
 
-    void populateMissingMetadata ( medAbstractData* medData, const QString seriesDescription );
+    void populateMissingMetadata ( medAbstractData* medData, const QString seriesDescription,
+                                   bool uniqueSeriesDescription = false );
     void addAdditionalMetaData ( medAbstractData* imData, QString aggregatedFileName, QStringList aggregatedFilesPaths );
 
     dtkSmartPointer<dtkAbstractDataReader> getSuitableReader ( QStringList filename );
@@ -90,10 +92,16 @@ protected:
 
     QString generateUniqueVolumeId ( const medAbstractData* medData );
     QString generateThumbnail(medAbstractData* medData, QString pathToStoreThumbnail );
+    void storeStatistics ( medAbstractData* medData, QString pathToStoreStatistics );
 
     void importData();
     void importFile();
 
+    void readAndWriteVolume ( medImportVolume& volume );
+    QString reserveSeriesName ( const QString& seriesName );
+    void releaseSeriesName ( const QString& seriesName );
+    static int importerThreadCount ( void );
+
     /**
     * Finds if parameter @seriesName is already being used in the database
     * if is not, it returns @seriesName unchanged
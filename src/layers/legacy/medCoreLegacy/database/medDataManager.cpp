@@ -12,15 +12,56 @@
 =========================================================================*/
 
 #include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <medAbstractDataFactory.h>
 #include <medDatabaseController.h>
 #include <medDatabaseNonPersistentController.h>
 #include <medDataManager.h>
+#include <medDatabaseReader.h>
 #include <medGlobalDefs.h>
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 #include <medMessageController.h>
 #include <medPluginManager.h>
+#include <medSettingsManager.h>
+
+namespace
+{
+// default memory above which unused data is released, in MB
+const qint64 defaultCacheMemoryBudget = 2048;
+}
+
+/**
+ * Asynchronous load of one data, shared by all the requests on its index.
+ */
+struct medDataLoad
+{
+    int priority = medDataRequest::PrefetchPriority;
+    QList<QSharedPointer<medDataRequest> > requests;
+    QRunnable *loader = nullptr; // queued in the loading pool, reset when it starts
+    bool waiting = false;        // prefetch waiting for a loading thread
+    bool prefetchSlot = false;   // counted in the running prefetches
+    bool skipped = false;        // started after all its requests were canceled
+    dtkSmartPointer<medAbstractData> result;
+    medMessageProgress *message = nullptr;
+};
+
+class medDataManagerPrivate;
+
+class medDataLoader : public QRunnable
+{
+public:
+    medDataLoader(medDataManagerPrivate *manager, const medDataIndex& index)
+        : manager(manager), index(index) {}
+
+    void run() override;
+
+private:
+    medDataManagerPrivate *manager;
+    medDataIndex index;
+};
 
 /* THESE CLASSES NEED TO BE THREAD-SAFE, don't forget to lock the mutex in the
  * methods below that access state.
@@ -36,6 +77,12 @@ public:
         dbController = medDatabaseController::instance();
         nonPersDbController = medDatabaseNonPersistentController::instance();
 
+        accessTick = 0;
+        activePrefetches = 0;
+        loadPool.setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 4));
+        cacheMemoryBudget = medSettingsManager::instance()->value("medDataManager", "cache_memory_budget",
+                                                                  defaultCacheMemoryBudget).toLongLong() * 1024 * 1024;
+
         if( ! dbController || ! nonPersDbController) {
             qCritical() << "One of the DB controllers could not be created !";
         }
@@ -49,6 +96,7 @@ public:
             if (loadedDataObjectTracker.value(i).isNull())
             {
                 loadedDataObjectTracker.remove(i);
+                lastAccess.remove(i);
             }
         }
     }
@@ -66,6 +114,71 @@ public:
         }
     }
 
+    /**
+     * Queues the load of index in the loading pool. Prefetches wait when they
+     * would take the last loading thread, kept for the visible requests.
+     * The mutex must be locked.
+     */
+    void scheduleLoad(const medDataIndex& index)
+    {
+        medDataLoad& load = loads[index];
+
+        if (load.priority == medDataRequest::PrefetchPriority)
+        {
+            if (activePrefetches >= loadPool.maxThreadCount() - 1)
+            {
+                load.waiting = true;
+                waitingPrefetches.append(index);
+                return;
+            }
+            load.prefetchSlot = true;
+            activePrefetches++;
+        }
+
+        load.loader = new medDataLoader(this, index);
+        loadPool.start(load.loader, load.priority);
+    }
+
+    /**
+     * Takes back the load of index if it has not started yet.
+     * The mutex must be locked.
+     */
+    bool unscheduleLoad(const medDataIndex& index)
+    {
+        medDataLoad& load = loads[index];
+
+        if (load.waiting)
+        {
+            waitingPrefetches.removeOne(index);
+            load.waiting = false;
+            return true;
+        }
+
+        if (load.loader && loadPool.tryTake(load.loader))
+        {
+            delete load.loader;
+            load.loader = nullptr;
+            if (load.prefetchSlot)
+            {
+                load.prefetchSlot = false;
+                activePrefetches--;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /** The mutex must be locked. */
+    void scheduleWaitingPrefetches()
+    {
+        while (!waitingPrefetches.isEmpty() && activePrefetches < loadPool.maxThreadCount() - 1)
+        {
+            medDataIndex index = waitingPrefetches.takeFirst();
+            loads[index].waiting = false;
+            scheduleLoad(index);
+        }
+    }
+
     Q_DECLARE_PUBLIC(medDataManager)
 
     medDataManager * const q_ptr;
@@ -74,9 +187,53 @@ public:
     medAbstractDbController * dbController;
     medAbstractDbController * nonPersDbController;
     QTimer timer;
+
+    // loaded data cache: last access tick of each loaded data, for the LRU eviction
+    QHash<medDataIndex, quint64> lastAccess;
+    quint64 accessTick;
+    qint64 cacheMemoryBudget;
+    medDataManager::CacheStatistics statistics;
     QHash<QUuid, medDataIndex> makePersistentJobs;
+
+    // asynchronous loads, see requestData()
+    QHash<medDataIndex, medDataLoad> loads;
+    QList<medDataIndex> waitingPrefetches;
+    int activePrefetches;
+    QThreadPool loadPool;
 };
 
+void medDataLoader::run()
+{
+    bool skipped;
+    {
+        QMutexLocker locker(&(manager->mutex));
+        medDataLoad& load = manager->loads[index];
+        load.loader = nullptr; // deleted by the pool when run() returns
+        load.skipped = load.requests.isEmpty();
+        skipped = load.skipped;
+    }
+
+    if (!skipped)
+    {
+        medDataManager *q = manager->q_ptr;
+        medDataIndex loadedIndex = index;
+
+        // read directly rather than through the controller, which shows its progress from the calling thread
+        medDatabaseReader reader(index);
+        QObject::connect(&reader, &medDatabaseReader::progressed, [q, loadedIndex](int progress)
+        {
+            QMetaObject::invokeMethod(q, "updateLoadProgress", Qt::QueuedConnection,
+                                      Q_ARG(medDataIndex, loadedIndex), Q_ARG(int, progress));
+        });
+        dtkSmartPointer<medAbstractData> data = reader.run();
+
+        QMutexLocker locker(&(manager->mutex));
+        manager->loads[index].result = data;
+    }
+
+    QMetaObject::invokeMethod(manager->q_ptr, "finishLoad", Qt::QueuedConnection, Q_ARG(medDataIndex, index));
+}
+
 // ------------------------- medDataManager -----------------------------------
 
 medDataManager * medDataManager::s_instance = nullptr;
@@ -105,9 +262,22 @@ medAbstractData* medDataManager::retrieveData(const medDataIndex& index)
     if(dataObjRef)
     {
         // we found an existing instance of that object
+        d->lastAccess[index] = ++d->accessTick;
+        d->statistics.hits++;
         return dataObjRef;
     }
 
+    // data not loaded yet, or released by the cache: (re)load it
+    d->statistics.misses++;
+
+    // an asynchronous load which has not started yet is answered by this one
+    medDataLoad takenOverLoad;
+    if (d->loads.contains(index) && d->unscheduleLoad(index))
+    {
+        takenOverLoad = d->loads.take(index);
+        d->scheduleWaitingPrefetches();
+    }
+
     // No existing ref, we need to load from the file DB, then the non-persistent DB
     if (d->dbController->contains(index)) {
         dataObjRef = d->dbController->retrieve(index);
@@ -119,11 +289,215 @@ medAbstractData* medDataManager::retrieveData(const medDataIndex& index)
         dataObjRef->setDataIndex(index);
 
         d->loadedDataObjectTracker.insert(index, dataObjRef);
+        d->lastAccess[index] = ++d->accessTick;
+    }
+
+    if (takenOverLoad.message)
+    {
+        dataObjRef ? takenOverLoad.message->success() : takenOverLoad.message->failure();
+    }
+    for (QSharedPointer<medDataRequest> request : takenOverLoad.requests)
+    {
+        request->finish(dataObjRef);
+    }
+
+    if (dataObjRef)
+    {
+        // make room for the new data, which is referenced by the caller as soon as it is returned
+        evictUnusedData(index);
         return dataObjRef;
     }
     return nullptr;
 }
 
+/**
+ * Retrieves data without blocking the calling thread, which must be the main thread.
+ * Data which is already loaded, or held by the non-persistent database, is
+ * answered immediately; otherwise it is read from the database in a loading
+ * thread. Requests on the same index share a single read, at the highest of
+ * their priorities.
+ * @param index - series to retrieve
+ * @param priority - VisiblePriority for data about to be displayed
+ * @return handle notified of the progress and the result of the retrieval
+ */
+QSharedPointer<medDataRequest> medDataManager::requestData(const medDataIndex& index, medDataRequest::Priority priority)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    // deleteLater, as the last reference can be dropped while the request emits
+    QSharedPointer<medDataRequest> request(new medDataRequest(index, priority), &QObject::deleteLater);
+
+    if (d->loads.contains(index))
+    {
+        medDataLoad& load = d->loads[index];
+        load.requests.append(request);
+        d->statistics.coalesced++;
+
+        if (priority > load.priority)
+        {
+            // a request which is still queued moves ahead of the less urgent ones
+            bool rescheduled = d->unscheduleLoad(index);
+            load.priority = priority;
+            if (!load.message)
+            {
+                load.message = medMessageController::instance()->showProgress("Opening database item");
+            }
+            if (rescheduled)
+            {
+                d->scheduleLoad(index);
+            }
+        }
+        return request;
+    }
+
+    if (d->loadedDataObjectTracker.value(index) || !d->dbController->contains(index))
+    {
+        // nothing to wait for: already loaded, in memory, or unknown
+        request->finish(retrieveData(index));
+        return request;
+    }
+
+    d->statistics.misses++;
+
+    medDataLoad& load = d->loads[index];
+    load.priority = priority;
+    load.requests.append(request);
+    if (priority != medDataRequest::PrefetchPriority)
+    {
+        load.message = medMessageController::instance()->showProgress("Opening database item");
+    }
+    d->scheduleLoad(index);
+
+    return request;
+}
+
+/**
+ * Loads data in the background, behind the other requests, so that a later
+ * retrieval is immediate. Cancel the returned request if it is not needed anymore.
+ */
+QSharedPointer<medDataRequest> medDataManager::prefetchData(const medDataIndex& index)
+{
+    return requestData(index, medDataRequest::PrefetchPriority);
+}
+
+void medDataManager::cancelRequest(medDataRequest *request)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    medDataIndex index = request->index();
+    if (!d->loads.contains(index))
+    {
+        return;
+    }
+
+    medDataLoad& load = d->loads[index];
+    for (int i = 0; i < load.requests.count(); ++i)
+    {
+        if (load.requests[i].data() == request)
+        {
+            load.requests.removeAt(i);
+            break;
+        }
+    }
+
+    // a load already started is completed anyway, its data goes to the cache
+    if (load.requests.isEmpty() && d->unscheduleLoad(index))
+    {
+        if (load.message)
+        {
+            medMessageController::instance()->remove(load.message);
+        }
+        d->loads.remove(index);
+        d->scheduleWaitingPrefetches();
+    }
+}
+
+void medDataManager::updateLoadProgress(medDataIndex index, int progress)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    if (d->loads.contains(index))
+    {
+        medDataLoad& load = d->loads[index];
+        if (load.message)
+        {
+            load.message->setProgress(progress);
+        }
+        for (QSharedPointer<medDataRequest> request : load.requests)
+        {
+            request->setProgress(progress);
+        }
+    }
+}
+
+void medDataManager::finishLoad(medDataIndex index)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    if (!d->loads.contains(index))
+    {
+        return;
+    }
+
+    medDataLoad load = d->loads.take(index);
+    if (load.prefetchSlot)
+    {
+        d->activePrefetches--;
+    }
+
+    if (load.skipped && !load.requests.isEmpty())
+    {
+        // requests arrived after the loader gave up, load again
+        load.skipped = false;
+        load.prefetchSlot = false;
+        d->loads.insert(index, load);
+        d->scheduleLoad(index);
+        d->scheduleWaitingPrefetches();
+        return;
+    }
+
+    medAbstractData *data = load.result;
+    if (data)
+    {
+        medAbstractData *loadedData = d->loadedDataObjectTracker.value(index);
+        if (loadedData)
+        {
+            // a synchronous retrieveData() was faster, keep a single instance
+            data = loadedData;
+        }
+        else
+        {
+            data->setDataIndex(index);
+            d->loadedDataObjectTracker.insert(index, data);
+        }
+        d->lastAccess[index] = ++d->accessTick;
+    }
+
+    if (load.message)
+    {
+        data ? load.message->success() : load.message->failure();
+    }
+    if (!data && !load.skipped)
+    {
+        medMessageController::instance()->showError("Opening item failed.", 3000);
+    }
+
+    for (QSharedPointer<medDataRequest> request : load.requests)
+    {
+        request->finish(data);
+    }
+
+    if (data)
+    {
+        evictUnusedData(index);
+    }
+    d->scheduleWaitingPrefetches();
+}
+
 QUuid medDataManager::importData(medAbstractData *data, bool persistent)
 {
     if (!data)
@@ -282,7 +656,7 @@ void medDataManager::launchExporter(medDatabaseExporter* exporter, const QString
     connect(exporter, SIGNAL(failure(QObject *)), this, SIGNAL(exportFinished()));
 
     medJobManagerL::instance()->registerJobItem(exporter);
-    QThreadPool::globalInstance()->start(exporter);
+    medJobScheduler::instance()->start(exporter, medJobScheduler::DataJob);
 }
 
 QList<medDataIndex> medDataManager::getSeriesListFromStudy(const medDataIndex& indexStudy)
@@ -362,16 +736,102 @@ void medDataManager::garbageCollect()
     Q_D(medDataManager);
     QMutexLocker locker(&(d->mutex));
 
-    // garbage collect data that are only referenced by the manager
+    evictUnusedData();
+}
+
+/**
+ * Releases data only referenced by the manager, least recently used first,
+ * until the loaded data fits in the cache memory budget. Released data is
+ * reloaded from its controller by the next retrieveData().
+ * Data whose memory size is unknown is released as soon as it is unused.
+ * The mutex must be locked.
+ * @param inUse - data being returned to a caller, not referenced yet, never released
+ */
+void medDataManager::evictUnusedData(const medDataIndex& inUse)
+{
+    Q_D(medDataManager);
+
+    qint64 usedBytes = 0;
+    qint64 evictionsBefore = d->statistics.evictions;
+    QMap<quint64, medDataIndex> unusedByAccess;
+
     QMutableHashIterator <medDataIndex, dtkSmartPointer<medAbstractData> > it(d->loadedDataObjectTracker);
     while(it.hasNext()) {
         it.next();
         medAbstractData *data = it.value();
-        if(data->count() <= 1) {
+        qint64 size = data->memorySize();
+        bool unused = (data->count() <= 1) && (it.key() != inUse);
+
+        if(unused && size <= 0) {
             qDebug()<<"medDataManager garbage collected " << data->dataIndex();
+            d->lastAccess.remove(it.key());
             it.remove();
+            d->statistics.evictions++;
+            continue;
+        }
+
+        usedBytes += size;
+        if(unused) {
+            unusedByAccess.insert(d->lastAccess.value(it.key()), it.key());
         }
     }
+
+    for(const medDataIndex& index : unusedByAccess)
+    {
+        if (usedBytes <= d->cacheMemoryBudget)
+            break;
+
+        usedBytes -= d->loadedDataObjectTracker.value(index)->memorySize();
+        qDebug()<<"medDataManager released " << index << "from the cache";
+        d->loadedDataObjectTracker.remove(index);
+        d->lastAccess.remove(index);
+        d->statistics.evictions++;
+    }
+
+    d->statistics.usedBytes = usedBytes;
+    d->statistics.loadedCount = d->loadedDataObjectTracker.count();
+
+    if (d->statistics.evictions > evictionsBefore)
+    {
+        qDebug() << "medDataManager cache:" << d->statistics.loadedCount << "data loaded,"
+                 << d->statistics.usedBytes / (1024 * 1024) << "/" << d->cacheMemoryBudget / (1024 * 1024) << "MB,"
+                 << d->statistics.hits << "hits," << d->statistics.misses << "misses,"
+                 << d->statistics.evictions << "evictions";
+    }
+}
+
+/**
+ * Returns the counters of the loaded data cache.
+ */
+medDataManager::CacheStatistics medDataManager::cacheStatistics()
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    CacheStatistics statistics = d->statistics;
+    statistics.budgetBytes = d->cacheMemoryBudget;
+    return statistics;
+}
+
+/**
+ * Sets the memory above which unused loaded data is released, and saves it in the settings.
+ */
+void medDataManager::setCacheMemoryBudget(qint64 bytes)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    d->cacheMemoryBudget = qMax<qint64>(0, bytes);
+    medSettingsManager::instance()->setValue("medDataManager", "cache_memory_budget", d->cacheMemoryBudget / (1024 * 1024));
+    evictUnusedData();
+}
+
+qint64 medDataManager::cacheMemoryBudget()
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    return d->cacheMemoryBudget;
 }
 
 QUuid medDataManager::makePersistent(medAbstractData* data)
@@ -452,6 +912,25 @@ void medDataManager::removeData(const medDataIndex& index)
     }
 }
 
+/**
+ * Drops the loaded data of a removed patient, study or series. Ids of
+ * removed series may be given again to new ones.
+ */
+void medDataManager::forgetData(const medDataIndex& index)
+{
+    Q_D(medDataManager);
+    QMutexLocker locker(&(d->mutex));
+
+    QMutableHashIterator <medDataIndex, dtkSmartPointer<medAbstractData> > it(d->loadedDataObjectTracker);
+    while(it.hasNext()) {
+        it.next();
+        if (medDataIndex::isMatch(it.key(), index)) {
+            d->lastAccess.remove(it.key());
+            it.remove();
+        }
+    }
+}
+
 void medDataManager::removeFromNonPersistent(medDataIndex indexImported, QUuid uuid)
 {
     Q_UNUSED(indexImported);
@@ -511,6 +990,7 @@ medDataManager::medDataManager() : d_ptr(new medDataManagerPrivate(this))
     for(medAbstractDbController* controller : controllers)
     {
         connect(controller, SIGNAL(dataImported(medDataIndex,QUuid)), this, SIGNAL(dataImported(medDataIndex,QUuid)));
+        connect(controller, SIGNAL(dataRemoved(medDataIndex)), this, SLOT(forgetData(medDataIndex)));
         connect(controller, SIGNAL(dataRemoved(medDataIndex)), this, SIGNAL(dataRemoved(medDataIndex)));
         connect(controller, SIGNAL(metadataModified(medDataIndex,QString,QString)), this, SIGNAL(metadataModified(medDataIndex,QString,QString)));
     }
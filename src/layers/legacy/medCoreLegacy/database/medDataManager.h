@@ -14,11 +14,13 @@
 
 #include <QObject>
 #include <QPixmap>
+#include <QSharedPointer>
 #include <QUuid>
 
 #include <medCoreLegacyExport.h>
 #include <medDatabaseExporter.h>
 #include <medDataIndex.h>
+#include <medDataRequest.h>
 
 class medDataManagerPrivate;
 class medAbstractData;
@@ -30,11 +32,33 @@ class MEDCORELEGACY_EXPORT medDataManager : public QObject
     Q_OBJECT
 
 public:
+    /**
+     * Counters of the loaded data cache, see retrieveData().
+     */
+    struct CacheStatistics
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qint64 coalesced = 0;   // requests which joined a load already in progress
+        qint64 usedBytes = 0;   // memory of all the loaded data
+        qint64 budgetBytes = 0; // memory above which unused data is released
+        int loadedCount = 0;
+    };
+
     static void initialize();
     static medDataManager * instance();
 
     medAbstractData* retrieveData(const medDataIndex& index);
 
+    QSharedPointer<medDataRequest> requestData(const medDataIndex& index,
+                                               medDataRequest::Priority priority = medDataRequest::NormalPriority);
+    QSharedPointer<medDataRequest> prefetchData(const medDataIndex& index);
+
+    CacheStatistics cacheStatistics();
+    void setCacheMemoryBudget(qint64 bytes);
+    qint64 cacheMemoryBudget();
+
     QHash<QString, dtkAbstractDataWriter*> getPossibleWriters(medAbstractData* data);
 
     QUuid importData(medAbstractData* data, bool persistent = false);
@@ -78,6 +102,9 @@ private slots:
     void garbageCollect();
     void removeFromNonPersistent(medDataIndex,QUuid);
     void setWriterPriorities();
+    void updateLoadProgress(medDataIndex index, int progress);
+    void finishLoad(medDataIndex index);
+    void forgetData(const medDataIndex& index);
 
 protected:
     medDataManagerPrivate * const d_ptr;
@@ -88,6 +115,10 @@ private:
 
     static medDataManager * s_instance;
     void launchExporter(medDatabaseExporter* exporter, const QString & filename);
+    void evictUnusedData(const medDataIndex& inUse = medDataIndex());
+    void cancelRequest(medDataRequest *request);
+
+    friend class medDataRequest;
 
     Q_DECLARE_PRIVATE(medDataManager)
 };
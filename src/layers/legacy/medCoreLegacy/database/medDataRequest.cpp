@@ -0,0 +1,105 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medDataManager.h>
+#include <medDataRequest.h>
+
+medDataRequest::medDataRequest(const medDataIndex &index, Priority priority)
+    : QObject()
+    , m_index(index)
+    , m_priority(priority)
+    , m_progress(0)
+    , m_finished(false)
+    , m_canceled(false)
+{
+}
+
+medDataRequest::~medDataRequest()
+{
+}
+
+medDataIndex medDataRequest::index() const
+{
+    return m_index;
+}
+
+medDataRequest::Priority medDataRequest::priority() const
+{
+    return m_priority;
+}
+
+int medDataRequest::progress() const
+{
+    return m_progress;
+}
+
+bool medDataRequest::isFinished() const
+{
+    return m_finished;
+}
+
+bool medDataRequest::isCanceled() const
+{
+    return m_canceled;
+}
+
+medAbstractData *medDataRequest::data() const
+{
+    return m_data;
+}
+
+/**
+ * Gives up the request. The data is still loaded if other requests wait for it.
+ */
+void medDataRequest::cancel()
+{
+    if (m_finished)
+    {
+        return;
+    }
+
+    m_canceled = true;
+    medDataManager::instance()->cancelRequest(this);
+    finish(nullptr);
+}
+
+void medDataRequest::setProgress(int progress)
+{
+    if (!m_finished && progress != m_progress)
+    {
+        m_progress = progress;
+        emit progressed(progress);
+    }
+}
+
+/**
+ * Stores the result; finished() is emitted from the event loop, so that
+ * requests answered immediately can still be connected by the caller.
+ */
+void medDataRequest::finish(medAbstractData *data)
+{
+    if (m_finished)
+    {
+        return;
+    }
+
+    m_data = data;
+    m_finished = true;
+    m_progress = 100;
+    QMetaObject::invokeMethod(this, "emitFinished", Qt::QueuedConnection);
+}
+
+void medDataRequest::emitFinished()
+{
+    emit finished(m_data);
+}
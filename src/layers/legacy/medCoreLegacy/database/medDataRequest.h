@@ -0,0 +1,82 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QObject>
+
+#include <dtkCoreSupport/dtkSmartPointer.h>
+
+#include <medAbstractData.h>
+#include <medCoreLegacyExport.h>
+#include <medDataIndex.h>
+
+/**
+ * Handle on an asynchronous data retrieval, see medDataManager::requestData().
+ * Requests live in the main thread: their signals are emitted there, and
+ * cancel() must be called from there.
+ */
+class MEDCORELEGACY_EXPORT medDataRequest : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Order in which pending requests are loaded. Prefetches never use all
+     * the loading threads, so that a visible request always starts promptly.
+     */
+    enum Priority
+    {
+        PrefetchPriority = 0,
+        NormalPriority = 1,
+        VisiblePriority = 2
+    };
+
+    ~medDataRequest();
+
+    medDataIndex index() const;
+    Priority priority() const;
+
+    int progress() const;
+    bool isFinished() const;
+    bool isCanceled() const;
+
+    /** The retrieved data, null until the request is finished or if it failed. */
+    medAbstractData *data() const;
+
+public slots:
+    void cancel();
+
+signals:
+    void progressed(int progress);
+
+    /** Emitted once, with a null data if the retrieval failed or was canceled. */
+    void finished(medAbstractData *data);
+
+private slots:
+    void setProgress(int progress);
+    void emitFinished();
+
+private:
+    medDataRequest(const medDataIndex &index, Priority priority);
+
+    void finish(medAbstractData *data);
+
+    medDataIndex m_index;
+    Priority m_priority;
+    int m_progress;
+    bool m_finished;
+    bool m_canceled;
+    dtkSmartPointer<medAbstractData> m_data;
+
+    friend class medDataManager;
+};
@@ -18,8 +18,36 @@
 #include "medStorage.h"
 
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 #include <medMessageController.h>
 
+#include <QThreadStorage>
+
+/**
+ * Connection of a thread other than the controller's, Qt connections being
+ * usable only from the thread which created them. Removed with the thread.
+ */
+class medDatabaseThreadConnection
+{
+public:
+    medDatabaseThreadConnection(const QSqlDatabase& database)
+    {
+        static QAtomicInt count;
+        name = QString("medDatabaseThread%1").arg(count.fetchAndAddRelaxed(1));
+        databaseName = database.databaseName();
+        QSqlDatabase::cloneDatabase(database, name).open();
+    }
+
+    ~medDatabaseThreadConnection()
+    {
+        QSqlDatabase::database(name, false).close();
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    QString name;
+    QString databaseName;
+};
+
 class medDatabaseControllerPrivate
 {
 public:
@@ -39,8 +67,12 @@ public:
     static const QString T_series ;
     static const QString T_study ;
     static const QString T_patient ;
+
+    static QThreadStorage<medDatabaseThreadConnection*> threadConnections;
 };
 
+QThreadStorage<medDatabaseThreadConnection*> medDatabaseControllerPrivate::threadConnections;
+
 const QString medDatabaseControllerPrivate::T_series = "series";
 const QString medDatabaseControllerPrivate::T_study = "study";
 const QString medDatabaseControllerPrivate::T_patient = "patient";
@@ -143,6 +175,27 @@ const QSqlDatabase& medDatabaseController::database(void) const
     return m_database;
 }
 
+/**
+ * Connection to the database usable from the calling thread: the controller's
+ * own in its thread, a clone opened on first use in the other threads.
+ */
+QSqlDatabase medDatabaseController::threadDatabase() const
+{
+    if (QThread::currentThread() == this->thread())
+    {
+        return m_database;
+    }
+
+    medDatabaseThreadConnection *connection = d->threadConnections.localData();
+    if (!connection || connection->databaseName != m_database.databaseName())
+    {
+        // first use in this thread, or the database moved since
+        connection = new medDatabaseThreadConnection(m_database);
+        d->threadConnections.setLocalData(connection);
+    }
+    return QSqlDatabase::database(connection->name);
+}
+
 bool medDatabaseController::createConnection(void)
 {
     medStorage::mkpath(medStorage::dataLocation() + "/");
@@ -353,7 +406,7 @@ void medDatabaseController::importPath(const QString& file, const QUuid &importU
             medMessageController::instance(),SLOT(showError(const QString&,unsigned int)));
 
     medJobManagerL::instance()->registerJobItem(importer);
-    QThreadPool::globalInstance()->start(importer);
+    medJobScheduler::instance()->start(importer, medJobScheduler::DataJob);
 }
 
 /**
@@ -374,7 +427,7 @@ void medDatabaseController::importData( medAbstractData *data, const QUuid & imp
             medMessageController::instance(),SLOT(showError(const QString&,unsigned int)));
 
     medJobManagerL::instance()->registerJobItem(importer);
-    QThreadPool::globalInstance()->start(importer);
+    medJobScheduler::instance()->start(importer, medJobScheduler::DataJob);
 }
 
 void medDatabaseController::showOpeningError(QObject *sender)
@@ -653,7 +706,7 @@ void medDatabaseController::remove( const medDataIndex& index )
     connect(remover, SIGNAL(removed(const medDataIndex &)), this, SIGNAL(dataRemoved(medDataIndex)));
 
     medJobManagerL::instance()->registerJobItem(remover);
-    QThreadPool::globalInstance()->start(remover);
+    medJobScheduler::instance()->start(remover, medJobScheduler::DataJob);
 }
 
 /**
@@ -36,6 +36,7 @@ public:
     ~medDatabaseController();
 
     const QSqlDatabase& database() const;
+    QSqlDatabase threadDatabase() const;
 
     bool createConnection();
     bool  closeConnection();
@@ -79,6 +79,7 @@ medDataIndex medDatabaseImporter::populateDatabaseAndGenerateThumbnails ( medAbs
     QSqlDatabase db = medDatabaseController::instance()->database();
 
     generateThumbnail ( medData, pathToStoreThumbnail );
+    storeStatistics ( medData, pathToStoreThumbnail );
 
     int patientDbId = getOrCreatePatient ( medData, db );
 
@@ -26,6 +26,7 @@
 #include <medMessageController.h>
 #include <medMetaDataKeys.h>
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 
 // /////////////////////////////////////////////////////////////////
 // medDatabaseNonPersitentControllerPrivate
@@ -102,7 +103,7 @@ void medDatabaseNonPersistentController::importPath(const QString& file,const QU
             medMessageController::instance(),SLOT(showError(const QString&,unsigned int)));
 
     medJobManagerL::instance()->registerJobItem(importer);
-    QThreadPool::globalInstance()->start(importer);
+    medJobScheduler::instance()->start(importer, medJobScheduler::DataJob);
 }
 
 int medDatabaseNonPersistentController::nonPersistentDataStartingIndex() const
@@ -146,7 +147,7 @@ void medDatabaseNonPersistentController::importData(medAbstractData *data,
             medMessageController::instance(),SLOT(showError(const QString&,unsigned int)));
 
     medJobManagerL::instance()->registerJobItem(importer);
-    QThreadPool::globalInstance()->start(importer);
+    medJobScheduler::instance()->start(importer, medJobScheduler::DataJob);
 }
 
 void medDatabaseNonPersistentController::removeAll()
@@ -49,7 +49,9 @@ medAbstractData* medDatabaseReader::run()
     QVariant   studyDbId = d->index.studyId();
     QVariant  seriesDbId = d->index.seriesId();
 
-    QSqlQuery query(medDatabaseController::instance()->database());
+    // readers of the loading threads query through their own connection,
+    // concurrent accesses to the database file are serialized by SQLite
+    QSqlQuery query(medDatabaseController::instance()->threadDatabase());
 
     QString patientName, birthdate, gender, patientId;
     QString studyName, studyUid, studyId;
@@ -170,6 +172,16 @@ medAbstractData* medDatabaseReader::run()
     }
     medMetaDataKeys::SeriesThumbnail.add (medData, fullThumbnailPath);
 
+    // statistics stored at import, next to the thumbnail
+    if (medAbstractImageData *imageData = dynamic_cast<medAbstractImageData*>(medData))
+    {
+        medImageStatistics statistics = medImageStatistics::load(fullThumbnailPathInfo.dir().filePath("statistics.dat"));
+        if (statistics.isValid())
+        {
+            imageData->setStatistics(statistics);
+        }
+    }
+
     medMetaDataKeys::PatientID.set ( medData, patientId );
     medMetaDataKeys::PatientName.set ( medData, patientName );
     medMetaDataKeys::BirthDate.set ( medData, birthdate );
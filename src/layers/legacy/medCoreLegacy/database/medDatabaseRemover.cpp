@@ -167,6 +167,13 @@ void medDatabaseRemover::removeSeries ( int patientDbId, int studyDbId, int seri
         {
             this->removeDataFile(path);
         }
+
+        // statistics stored next to the thumbnail at import
+        QString thumbnail = query.value(0).toString();
+        if ( !thumbnail.isEmpty() )
+        {
+            this->removeFile ( QFileInfo ( thumbnail ).path() + "/statistics.dat" );
+        }
         removeThumbnailIfNeeded(query);
     }
 
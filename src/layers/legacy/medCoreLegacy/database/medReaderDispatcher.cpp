@@ -0,0 +1,181 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medAbstractDataFactory.h>
+#include <medReaderDispatcher.h>
+
+namespace
+{
+// enough to hold the DICOM preamble and its "DICM" prefix
+const qint64 magicNumberLength = 132;
+
+enum KeyKind { DirectoryKey = 0, MagicKey, ExtensionKey };
+}
+
+class medReaderDispatcherPrivate
+{
+public:
+    mutable QMutex mutex;
+
+    // cache key (see cacheKeys()) -> reader type
+    QHash<QString, QString> decisions;
+};
+
+//-----------------------------------------------------------------------------------------------------------
+
+medReaderDispatcher::medReaderDispatcher() : d ( new medReaderDispatcherPrivate )
+{
+}
+
+medReaderDispatcher::~medReaderDispatcher()
+{
+    delete d;
+    d = nullptr;
+}
+
+/**
+* Returns a reader able to read the files, or nullptr if none is found.
+* Remembered readers are tried first, by directory, magic number then extension.
+* @param paths - Input file/s we would like to find a reader for
+**/
+dtkSmartPointer<dtkAbstractDataReader> medReaderDispatcher::reader ( const QStringList& paths )
+{
+    if ( paths.isEmpty() )
+    {
+        return nullptr;
+    }
+
+    QStringList keys = cacheKeys ( paths );
+
+    QStringList candidates;
+    {
+        QMutexLocker locker ( &d->mutex );
+        for ( const QString& key : keys )
+        {
+            QString readerType = d->decisions.value ( key );
+            if ( !readerType.isEmpty() && !candidates.contains ( readerType ) )
+            {
+                candidates << readerType;
+            }
+        }
+    }
+
+    dtkSmartPointer<dtkAbstractDataReader> dataReader;
+
+    for ( const QString& readerType : candidates )
+    {
+        if ( probe ( readerType, paths, dataReader ) )
+        {
+            QMutexLocker locker ( &d->mutex );
+            remember ( readerType, keys );
+            return dataReader;
+        }
+    }
+
+    QList<QString> readers = medAbstractDataFactory::instance()->readers();
+    for ( const QString& readerType : readers )
+    {
+        if ( candidates.contains ( readerType ) )
+        {
+            continue; // already refused these files
+        }
+
+        if ( probe ( readerType, paths, dataReader ) )
+        {
+            QMutexLocker locker ( &d->mutex );
+            remember ( readerType, keys );
+            return dataReader;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+* Forgets every decision.
+**/
+void medReaderDispatcher::clear()
+{
+    QMutexLocker locker ( &d->mutex );
+    d->decisions.clear();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+
+/**
+* Builds a new reader of the given type. Readers are never shared, the DICOM
+* readers for instance fill the same data for every file they read.
+**/
+dtkSmartPointer<dtkAbstractDataReader> medReaderDispatcher::create ( const QString& readerType )
+{
+    dtkSmartPointer<dtkAbstractDataReader> dataReader = medAbstractDataFactory::instance()->readerSmartPointer ( readerType );
+    if ( dataReader )
+    {
+        dataReader->enableDeferredDeletion ( false );
+    }
+    return dataReader;
+}
+
+bool medReaderDispatcher::probe ( const QString& readerType, const QStringList& paths, dtkSmartPointer<dtkAbstractDataReader>& dataReader )
+{
+    dataReader = create ( readerType );
+    if ( !dataReader )
+    {
+        return false;
+    }
+    return dataReader->canRead ( paths );
+}
+
+/**
+* Stores the decision for all the keys. The mutex must be locked.
+**/
+void medReaderDispatcher::remember ( const QString& readerType, const QStringList& keys )
+{
+    for ( const QString& key : keys )
+    {
+        d->decisions[key] = readerType;
+    }
+}
+
+/**
+* Builds the keys under which a decision is remembered for the files,
+* in the order of KeyKind. Keys are prefixed by their kind, so that they
+* never collide.
+**/
+QStringList medReaderDispatcher::cacheKeys ( const QStringList& paths )
+{
+    QFileInfo fileInfo ( paths[0] );
+    QString extension = fileInfo.completeSuffix().toLower();
+
+    QByteArray magicNumber;
+    QFile file ( fileInfo.filePath() );
+    if ( file.open ( QIODevice::ReadOnly ) )
+    {
+        magicNumber = file.read ( magicNumberLength );
+        // the DICOM preamble is free, only its "DICM" prefix identifies the format
+        if ( magicNumber.size() == magicNumberLength && magicNumber.endsWith ( "DICM" ) )
+        {
+            magicNumber = "DICM";
+        }
+        else
+        {
+            magicNumber.truncate ( 16 );
+        }
+    }
+
+    QStringList keys;
+    keys << QString ( "dir:%1|%2" ).arg ( fileInfo.absolutePath() ).arg ( extension );
+    keys << QString ( "magic:%1|%2" ).arg ( QString::fromLatin1 ( magicNumber.toHex() ) ).arg ( extension );
+    keys << QString ( "ext:%1" ).arg ( extension );
+    return keys;
+}
@@ -0,0 +1,58 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QtCore>
+
+#include <dtkCoreSupport/dtkAbstractDataReader.h>
+#include <dtkCoreSupport/dtkSmartPointer.h>
+
+#include <medCoreLegacyExport.h>
+
+class medReaderDispatcherPrivate;
+
+/**
+* @class medReaderDispatcher
+* @brief Selects the reader able to read files, remembering its previous decisions.
+*
+* Probing every registered reader with canRead() for every file is expensive,
+* mostly for DICOM where each probe opens the file. The dispatcher remembers
+* which reader type was selected for a directory, for a file extension and
+* for the first bytes (magic number) of a file, and tries this reader first.
+* A remembered reader is still checked with a single canRead(), so that files
+* sharing an extension but not a content (e.g. tensor and scalar NIfTI)
+* are never given to the wrong reader.
+*
+* Readers keep the data they read, so a new reader is built for every
+* request and only the selected reader types are remembered. A dispatcher is
+* meant to live for one import batch.
+**/
+class MEDCORELEGACY_EXPORT medReaderDispatcher
+{
+public:
+    medReaderDispatcher();
+    ~medReaderDispatcher();
+
+    dtkSmartPointer<dtkAbstractDataReader> reader ( const QStringList& paths );
+
+    void clear();
+
+private:
+    dtkSmartPointer<dtkAbstractDataReader> create ( const QString& readerType );
+    bool probe ( const QString& readerType, const QStringList& paths, dtkSmartPointer<dtkAbstractDataReader>& reader );
+    void remember ( const QString& readerType, const QStringList& keys );
+
+    static QStringList cacheKeys ( const QStringList& paths );
+
+    medReaderDispatcherPrivate *d;
+};
@@ -14,6 +14,7 @@
 #include <medDatabaseMetadataItemDialog.h>
 #include <medDatabaseView.h>
 #include <medDataManager.h>
+#include <medDataRequest.h>
 #include <medAbstractDatabaseItem.h>
 #include <medAbstractDbController.h>
 #include <medDatabaseEditItemDialog.h>
@@ -94,6 +95,12 @@ public:
     QAction *editAction;
     QAction *metadataAction;
     QMenu *contextMenu;
+
+    // series selected last, loaded in advance as it is likely to be opened
+    QSharedPointer<medDataRequest> prefetch;
+    // the prefetch starts once the selection rests on a series, not while browsing
+    QTimer prefetchTimer;
+    medDataIndex prefetchIndex;
 };
 
 medDatabaseView::medDatabaseView(QWidget *parent) : QTreeView(parent), d(new medDatabaseViewPrivate)
@@ -119,6 +126,10 @@ medDatabaseView::medDatabaseView(QWidget *parent) : QTreeView(parent), d(new med
     // Edit Key: F2 for instance on Linux/Windows.
     this->setEditTriggers(QAbstractItemView::SelectedClicked | QAbstractItemView::EditKeyPressed);
 
+    d->prefetchTimer.setSingleShot(true);
+    d->prefetchTimer.setInterval(500);
+    connect(&d->prefetchTimer, SIGNAL(timeout()), this, SLOT(prefetchSelectedSeries()));
+
     connect(this, SIGNAL(doubleClicked(const QModelIndex&)), this, SLOT(onItemDoubleClicked(const QModelIndex&)));
     connect(this, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(updateContextMenu(const QPoint&)));
 
@@ -331,6 +342,8 @@ void medDatabaseView::onExportSelectedItemRequested(void)
 void medDatabaseView::onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
 {
     Q_UNUSED(deselected);
+    d->prefetchTimer.stop();
+
     if (selected.count() == 0)
     {
         emit noPatientOrSeriesSelected();
@@ -368,6 +381,15 @@ void medDatabaseView::onSelectionChanged(const QItemSelection& selected, const Q
         this->setExpanded(index.parent().parent(), true);
         this->setExpanded(index.parent(), true);
         this->setExpanded(index, true);
+
+        if (d->prefetch && d->prefetch->index() != item->dataIndex())
+        {
+            d->prefetch->cancel();
+            d->prefetch.clear();
+        }
+        d->prefetchIndex = item->dataIndex();
+        d->prefetchTimer.start();
+
         emit seriesClicked(item->dataIndex());
     }
     else if (item->dataIndex().isValidForStudy())
@@ -382,6 +404,14 @@ void medDatabaseView::onSelectionChanged(const QItemSelection& selected, const Q
     }
 }
 
+void medDatabaseView::prefetchSelectedSeries()
+{
+    if (!d->prefetch || d->prefetch->index() != d->prefetchIndex)
+    {
+        d->prefetch = medDataManager::instance()->prefetchData(d->prefetchIndex);
+    }
+}
+
 medAbstractDatabaseItem* medDatabaseView::getItemFromIndex(const QModelIndex& index)
 {
     medAbstractDatabaseItem *item = nullptr;
@@ -76,6 +76,7 @@ protected slots:
     virtual void updateContextMenu(const QPoint&);
     virtual void onItemDoubleClicked(const QModelIndex& index);
     virtual void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
+    void prefetchSelectedSeries();
 
 protected:
     medAbstractDatabaseItem* getItemFromIndex(const QModelIndex& selected);
@@ -54,6 +54,20 @@ medSelectorToolBox* medSelectorWorkspace::selectorToolBox()
     return d->selectorToolBox;
 }
 
+medAbstractView *medSelectorWorkspace::inputView()
+{
+    return nullptr;
+}
+
+void medSelectorWorkspace::showProcessPreview(medAbstractData *preview)
+{
+    Q_UNUSED(preview);
+}
+
+void medSelectorWorkspace::hideProcessPreview()
+{
+}
+
 void medSelectorWorkspace::importProcessOutput()
 {
     medAbstractData *output = selectorToolBox()->currentToolBox()->processOutput();
@@ -15,6 +15,8 @@
 #include <medAbstractWorkspaceLegacy.h>
 #include <medCoreLegacyExport.h>
 
+class medAbstractData;
+class medAbstractView;
 class medSelectorWorkspacePrivate;
 class medSelectorToolBox;
 
@@ -33,6 +35,14 @@ public:
 
     medSelectorToolBox *selectorToolBox();
 
+    //! View displaying the input of the toolboxes, null if the workspace has none
+    virtual medAbstractView *inputView();
+
+    //! Shows a partial result of the current toolbox, which is not imported
+    virtual void showProcessPreview(medAbstractData *preview);
+    //! Removes the preview shown by showProcessPreview()
+    virtual void hideProcessPreview();
+
 protected slots:
     virtual void importProcessOutput();
 
@@ -16,6 +16,7 @@
 #include <QtGui>
 #include <QtCore>
 
+#include <medDataManager.h>
 #include <medStorage.h>
 #include <medSettingsManager.h>
 
@@ -38,12 +39,22 @@ medDatabaseSettingsWidget::medDatabaseSettingsWidget(QWidget *parent) :
     dbLayout->addWidget(btChooseDir);
     databaseLocation->setLayout(dbLayout);
 
+    // Memory above which the data not displayed anymore is released
+    cacheMemoryBudget = new QSpinBox(this);
+    cacheMemoryBudget->setRange(0, 1024 * 1024);
+    cacheMemoryBudget->setSingleStep(256);
+    cacheMemoryBudget->setSuffix(" MB");
+    cacheMemoryBudget->setToolTip(tr("Data not used anymore is kept loaded until this memory is reached"));
+
     QFormLayout* formLayout = new QFormLayout(this);
     formLayout->addRow(tr("Database location:"), databaseLocation);
+    formLayout->addRow(tr("Loaded data cache:"), cacheMemoryBudget);
 
     // Display the current database location
     read();
 
+    connect(cacheMemoryBudget, SIGNAL(valueChanged(int)), this, SLOT(write()));
+
     setLayout(formLayout);
 }
 
@@ -75,10 +86,25 @@ void medDatabaseSettingsWidget::read()
     // We always show the data location here,
     //the medStorage class takes care of retrieving the correct one
     dbPath->setText(medStorage::dataLocation());
+
+    if (medDataManager::instance())
+    {
+        cacheMemoryBudget->setValue(medDataManager::instance()->cacheMemoryBudget() / (1024 * 1024));
+    }
+    else
+    {
+        cacheMemoryBudget->setEnabled(false);
+    }
 }
 
 void medDatabaseSettingsWidget::write()
 {
     medSettingsManager * mnger = medSettingsManager::instance();
     mnger->setValue("medDatabaseSettingsWidget","new_database_location", dbPath->text());
+
+    if (cacheMemoryBudget->isEnabled())
+    {
+        mnger->setValue("medDataManager", "cache_memory_budget", cacheMemoryBudget->value());
+        medDataManager::instance()->setCacheMemoryBudget(static_cast<qint64>(cacheMemoryBudget->value()) * 1024 * 1024);
+    }
 }
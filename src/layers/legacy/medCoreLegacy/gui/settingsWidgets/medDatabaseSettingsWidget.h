@@ -15,6 +15,7 @@
 #include <QDialog>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QWidget>
 
 #include <medCoreLegacyExport.h>
@@ -30,14 +31,13 @@ public:
 
 public slots:
     void read();
+    void write();
 
 private slots:
     void selectDbDirectory();
 
-protected:
-    void write();
-
 private:
     QLineEdit* dbPath;
     QPushButton* btChooseDir;
+    QSpinBox* cacheMemoryBudget;
 };
@@ -345,14 +345,14 @@ medProgressionStack* medToolBox::getProgressionStack()
     return getWorkspace()->getProgressionStack();
 }
 
-void medToolBox::addConnectionsAndStartJob(medJobItemL *job)
+void medToolBox::addConnectionsAndStartJob(medJobItemL *job, medJobScheduler::Category category)
 {
     addToolBoxConnections(job);
 
     getProgressionStack()->addJobItem(job, "Progress "+this->name()+":");
 
     medJobManagerL::instance()->registerJobItem(job);
-    QThreadPool::globalInstance()->start(dynamic_cast<QRunnable*>(job));
+    medJobScheduler::instance()->start(dynamic_cast<QRunnable*>(job), category);
 }
 
 void medToolBox::addToolBoxConnections(medJobItemL *job)
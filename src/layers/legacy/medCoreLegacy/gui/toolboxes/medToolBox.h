@@ -22,6 +22,7 @@
 #include <medAbstractWorkspaceLegacy.h>
 #include <medCoreLegacyExport.h>
 #include <medJobItemL.h>
+#include <medJobScheduler.h>
 #include <medProgressionStack.h>
 
 class dtkAbstractView;
@@ -129,7 +130,7 @@ public slots:
     void setToolBoxOnReadyToUse();
 
     //! Add default connection and start a process
-    void addConnectionsAndStartJob(medJobItemL *job);
+    void addConnectionsAndStartJob(medJobItemL *job, medJobScheduler::Category category = medJobScheduler::ProcessJob);
 
     //! Default connections between a toolbox and a process (success, failure, etc)
     void addToolBoxConnections(medJobItemL *job);
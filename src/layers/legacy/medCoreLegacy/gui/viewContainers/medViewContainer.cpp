@@ -31,6 +31,7 @@
 #include <medBoolParameterL.h>
 #include <medDataIndex.h>
 #include <medDataManager.h>
+#include <medDataRequest.h>
 #include <medMessageController.h>
 #include <medPoolIndicatorL.h>
 #include <medSettingsManager.h>
@@ -65,6 +66,8 @@ public:
     bool multiLayer;
     bool userPoolable;
     QList<QUuid> expectedUuids;
+    QList<QSharedPointer<medDataRequest> > dataRequests; // data being retrieved, added in this order
+    bool importRetrieving; // importFinished() is emitted once the imported data is added
 
     QGridLayout* mainLayout;
     QHBoxLayout* toolBarLayout;
@@ -270,6 +273,7 @@ medViewContainer::medViewContainer(medViewContainerSplitter *parent): QFrame(par
     this->setUserOpenable(true);
 
     d->selected = false;
+    d->importRetrieving = false;
     this->setSelected(false);
 
     d->defaultStyleSheet = this->styleSheet();
@@ -277,6 +281,11 @@ medViewContainer::medViewContainer(medViewContainerSplitter *parent): QFrame(par
 
 medViewContainer::~medViewContainer()
 {
+    for(QSharedPointer<medDataRequest> request : d->dataRequests)
+    {
+        request->cancel();
+    }
+
     removeInternView();
     medViewContainerManager::instance()->unregisterContainer(this);
 
@@ -851,9 +860,11 @@ void medViewContainer::addData(medDataIndex index)
         return; // we're already waiting for a import to finish, don't accept other data
     }
 
+    QList<medDataIndex> seriesToAdd;
+
     if (index.isValidForSeries())
     {
-        this->addData(medDataManager::instance()->retrieveData(index));
+        seriesToAdd << index;
     }
     else if (index.isValidForStudy())
     {
@@ -870,13 +881,39 @@ void medViewContainer::addData(medDataIndex index)
 
             if (userIsOk)
             {
-                for(medDataIndex seriesIndex : seriesList)
-                {
-                    this->addData(medDataManager::instance()->retrieveData(seriesIndex));
-                }
+                seriesToAdd = seriesList;
             }
         }
     }
+
+    // read in the background, the data is added once retrieved
+    for(medDataIndex seriesIndex : seriesToAdd)
+    {
+        QSharedPointer<medDataRequest> request = medDataManager::instance()->requestData(seriesIndex, medDataRequest::VisiblePriority);
+        connect(request.data(), SIGNAL(finished(medAbstractData*)), this, SLOT(addRequestedData()));
+        d->dataRequests << request;
+    }
+}
+
+/**
+ * Adds the retrieved data in the order it was requested.
+ */
+void medViewContainer::addRequestedData()
+{
+    while (!d->dataRequests.isEmpty() && d->dataRequests.first()->isFinished())
+    {
+        QSharedPointer<medDataRequest> request = d->dataRequests.takeFirst();
+        if (request->data())
+        {
+            this->addData(request->data());
+        }
+    }
+
+    if (d->importRetrieving && d->dataRequests.isEmpty())
+    {
+        d->importRetrieving = false;
+        emit importFinished();
+    }
 }
 
 bool medViewContainer::userValidationForStudyDrop()
@@ -978,9 +1015,14 @@ void medViewContainer::open_waitForImportedSignal(medDataIndex index, QUuid uuid
                    this,SLOT(open_waitForImportedSignal(medDataIndex, QUuid)));
         if (index.isValid())
         {
+            // the data is retrieved in the background, see addRequestedData()
             this->addData(index);
+            d->importRetrieving = !d->dataRequests.isEmpty();
+        }
+        if (!d->importRetrieving)
+        {
+            emit importFinished();
         }
-        emit importFinished();
     }
 }
 
@@ -161,6 +161,7 @@ protected slots:
 
 private slots:
     void removeInternView();
+    void addRequestedData();
     DropArea computeDropArea(int x, int y);
     void popupMenu();
 
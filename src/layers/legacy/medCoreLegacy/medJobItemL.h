@@ -37,7 +37,7 @@
  *   connect (runProcess, SIGNAL (cancelled (QObject*)), this, SIGNAL (failure ()));
  *
  *   medJobManager::instance()->registerJobItem(runProcess);
- *   QThreadPool::globalInstance()->start(dynamic_cast<QRunnable*>(runProcess));
+ *   medJobScheduler::instance()->start(dynamic_cast<QRunnable*>(runProcess), medJobScheduler::ProcessJob);
  *   @endcode
  */
 class MEDCORELEGACY_EXPORT medJobItemL :  public QObject, public QRunnable
@@ -0,0 +1,276 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medJobScheduler.h>
+
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QThreadPool>
+
+#include <medSettingsManager.h>
+
+namespace
+{
+// names of the categories in the settings
+const char *categoryNames[medJobScheduler::CategoryCount] =
+{
+    "data", "process", "heavy_process"
+};
+}
+
+struct medPendingJob
+{
+    QRunnable *runnable;
+    qint64 memoryEstimate;
+};
+
+struct medJobCategory
+{
+    int priority = 0;
+    int maxRunningJobs = 1;
+    qint64 memoryBudget = 0;
+
+    int runningJobs = 0;
+    qint64 usedMemory = 0;
+    QQueue<medPendingJob> pendingJobs;
+};
+
+class medJobSchedulerPrivate
+{
+public:
+    mutable QMutex mutex;
+    medJobCategory categories[medJobScheduler::CategoryCount];
+    QThreadPool pool;
+    int runningJobs;
+    int threadsPerJob;
+};
+
+/**
+ * Runs a job, then lets the scheduler start the next ones.
+ */
+class medScheduledJob : public QRunnable
+{
+public:
+    medScheduledJob(QRunnable *job, medJobScheduler::Category category, qint64 memoryEstimate)
+        : job(job), category(category), memoryEstimate(memoryEstimate) {}
+
+    void run() override
+    {
+        job->run();
+        if (job->autoDelete())
+        {
+            delete job;
+        }
+        medJobScheduler::instance()->jobFinished(category, memoryEstimate);
+    }
+
+private:
+    QRunnable *job;
+    medJobScheduler::Category category;
+    qint64 memoryEstimate;
+};
+
+medJobScheduler *medJobScheduler::s_instance = nullptr;
+
+medJobScheduler *medJobScheduler::instance()
+{
+    if (!s_instance)
+    {
+        s_instance = new medJobScheduler;
+    }
+    return s_instance;
+}
+
+medJobScheduler::medJobScheduler() : QObject(), d(new medJobSchedulerPrivate)
+{
+    int cores = QThread::idealThreadCount();
+
+    // the scheduler decides which job runs: the pool never queues
+    d->pool.setMaxThreadCount(qMax(2, cores));
+    d->runningJobs = 0;
+    d->threadsPerJob = qMax(1, cores);
+
+    d->categories[DataJob].priority = 3;
+    d->categories[DataJob].maxRunningJobs = 2;
+    d->categories[ProcessJob].priority = 2;
+    d->categories[ProcessJob].maxRunningJobs = qMax(1, cores / 2);
+    d->categories[HeavyProcessJob].priority = 2;
+    d->categories[HeavyProcessJob].maxRunningJobs = 1;
+
+    medSettingsManager *settings = medSettingsManager::instance();
+    for (int i = 0; i < CategoryCount; ++i)
+    {
+        QString name = categoryNames[i];
+        medJobCategory &category = d->categories[i];
+        category.maxRunningJobs = settings->value("medJobScheduler", name + "_max_running_jobs", category.maxRunningJobs).toInt();
+        category.memoryBudget = settings->value("medJobScheduler", name + "_memory_budget", 0).toLongLong() * 1024 * 1024;
+    }
+}
+
+medJobScheduler::~medJobScheduler()
+{
+    delete d;
+    d = nullptr;
+}
+
+void medJobScheduler::start(QRunnable *runnable, Category category, qint64 memoryEstimate)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->categories[category].pendingJobs.enqueue({runnable, memoryEstimate});
+    }
+    schedule();
+}
+
+/**
+ * Starts pending jobs, highest priority first, while their categories and
+ * the pool have room for them. A job exceeding its category memory budget
+ * still starts when nothing else runs in the category.
+ */
+void medJobScheduler::schedule()
+{
+    QMutexLocker locker(&d->mutex);
+
+    while (d->runningJobs < d->pool.maxThreadCount())
+    {
+        int selected = -1;
+        for (int i = 0; i < CategoryCount; ++i)
+        {
+            medJobCategory &category = d->categories[i];
+            if (category.pendingJobs.isEmpty() || category.runningJobs >= category.maxRunningJobs)
+            {
+                continue;
+            }
+
+            qint64 memoryEstimate = category.pendingJobs.head().memoryEstimate;
+            if (category.memoryBudget > 0 && category.runningJobs > 0
+                    && category.usedMemory + memoryEstimate > category.memoryBudget)
+            {
+                continue;
+            }
+
+            if (selected < 0 || category.priority > d->categories[selected].priority)
+            {
+                selected = i;
+            }
+        }
+
+        if (selected < 0)
+        {
+            break;
+        }
+
+        medJobCategory &category = d->categories[selected];
+        medPendingJob job = category.pendingJobs.dequeue();
+        category.runningJobs++;
+        category.usedMemory += job.memoryEstimate;
+        d->runningJobs++;
+
+        d->pool.start(new medScheduledJob(job.runnable, static_cast<Category>(selected), job.memoryEstimate));
+    }
+
+    d->threadsPerJob = qMax(1, QThread::idealThreadCount() / qMax(1, d->runningJobs));
+}
+
+void medJobScheduler::jobFinished(Category category, qint64 memoryEstimate)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->categories[category].runningJobs--;
+        d->categories[category].usedMemory -= memoryEstimate;
+        d->runningJobs--;
+    }
+    schedule();
+}
+
+void medJobScheduler::setPriority(Category category, int priority)
+{
+    QMutexLocker locker(&d->mutex);
+    d->categories[category].priority = priority;
+}
+
+int medJobScheduler::priority(Category category) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->categories[category].priority;
+}
+
+void medJobScheduler::setMaxRunningJobs(Category category, int count)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->categories[category].maxRunningJobs = qMax(1, count);
+        medSettingsManager::instance()->setValue("medJobScheduler",
+                                                 QString(categoryNames[category]) + "_max_running_jobs",
+                                                 d->categories[category].maxRunningJobs);
+    }
+    schedule();
+}
+
+int medJobScheduler::maxRunningJobs(Category category) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->categories[category].maxRunningJobs;
+}
+
+void medJobScheduler::setMemoryBudget(Category category, qint64 bytes)
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->categories[category].memoryBudget = qMax<qint64>(0, bytes);
+        medSettingsManager::instance()->setValue("medJobScheduler",
+                                                 QString(categoryNames[category]) + "_memory_budget",
+                                                 d->categories[category].memoryBudget / (1024 * 1024));
+    }
+    schedule();
+}
+
+qint64 medJobScheduler::memoryBudget(Category category) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->categories[category].memoryBudget;
+}
+
+int medJobScheduler::runningJobs() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->runningJobs;
+}
+
+int medJobScheduler::pendingJobs() const
+{
+    QMutexLocker locker(&d->mutex);
+
+    int count = 0;
+    for (const medJobCategory &category : d->categories)
+    {
+        count += category.pendingJobs.count();
+    }
+    return count;
+}
+
+int medJobScheduler::threadsPerJob() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->threadsPerJob;
+}
+
+/**
+ * Waits for the running and pending jobs. Pending jobs always have a running
+ * job ahead of them, which starts them when it ends.
+ */
+bool medJobScheduler::waitForDone(int msecs)
+{
+    return d->pool.waitForDone(msecs);
+}
@@ -0,0 +1,85 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QObject>
+#include <QRunnable>
+
+#include <medCoreLegacyExport.h>
+
+class medJobSchedulerPrivate;
+
+/**
+ * @class medJobScheduler
+ * @brief Runs the background jobs of the application, new (medAbstractJob)
+ * and legacy (medJobItemL) ones, in a shared thread pool.
+ *
+ * Each job belongs to a category, which has a priority, a maximum number of
+ * jobs running at once and an optional memory budget. Pending jobs of the
+ * category with the highest priority start first, as soon as their category
+ * has room for them.
+ *
+ * Jobs parallelized internally (ITK filters...) should not use more threads
+ * than threadsPerJob(): the threads left to each running job are recomputed
+ * when a job starts or ends.
+ */
+class MEDCORELEGACY_EXPORT medJobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Category
+    {
+        DataJob = 0,        // import, export and removal of data
+        ProcessJob,         // filters and other processes
+        HeavyProcessJob,    // memory and cpu intensive processes, such as registrations
+        CategoryCount
+    };
+
+    static medJobScheduler *instance();
+
+    /**
+     * Queues a job. The runnable is deleted after it has run if autoDelete() is set.
+     * @param memoryEstimate - memory used by the job, in bytes, 0 if unknown
+     */
+    void start(QRunnable *runnable, Category category = ProcessJob, qint64 memoryEstimate = 0);
+
+    void setPriority(Category category, int priority);
+    int priority(Category category) const;
+
+    /** Maximum number of jobs of the category running at once. */
+    void setMaxRunningJobs(Category category, int count);
+    int maxRunningJobs(Category category) const;
+
+    /** Memory the running jobs of the category may use, in bytes, 0 for no limit. */
+    void setMemoryBudget(Category category, qint64 bytes);
+    qint64 memoryBudget(Category category) const;
+
+    int runningJobs() const;
+    int pendingJobs() const;
+    int threadsPerJob() const;
+
+    bool waitForDone(int msecs = -1);
+
+private:
+    medJobScheduler();
+    ~medJobScheduler();
+
+    void schedule();
+    void jobFinished(Category category, qint64 memoryEstimate);
+
+    static medJobScheduler *s_instance;
+    medJobSchedulerPrivate *d;
+
+    friend class medScheduledJob;
+};
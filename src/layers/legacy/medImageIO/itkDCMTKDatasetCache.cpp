@@ -0,0 +1,215 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <itkDCMTKDatasetCache.h>
+
+#ifndef WIN32
+#define HAVE_CONFIG_H
+#endif
+
+#include <dcmtk/config/osconfig.h>
+
+#include <dcmtk/dcmdata/dctk.h>
+
+#include <itksys/SystemTools.hxx>
+
+namespace itk
+{
+
+DCMTKDatasetCache& DCMTKDatasetCache::Instance()
+{
+    static DCMTKDatasetCache instance;
+    return instance;
+}
+
+DCMTKDatasetCache::DCMTKDatasetCache()
+    : m_MemoryBudget(512 * 1024 * 1024),
+      m_MemoryUsage(0),
+      m_Hits(0),
+      m_Misses(0)
+{
+}
+
+DCMTKDatasetCache::EntryPointer DCMTKDatasetCache::Acquire(const std::string& filename)
+{
+    long modifiedTime = itksys::SystemTools::ModifiedTime(filename);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    auto it = m_Entries.find(filename);
+    if (it != m_Entries.end())
+    {
+        if (it->second.entry->modifiedTime == modifiedTime)
+        {
+            m_LRU.splice(m_LRU.begin(), m_LRU, it->second.position);
+            ++m_Hits;
+            return it->second.entry;
+        }
+
+        // the file changed on disk
+        m_MemoryUsage -= it->second.entry->cost;
+        m_LRU.erase(it->second.position);
+        m_Entries.erase(it);
+    }
+
+    ++m_Misses;
+
+    EntryPointer entry = std::make_shared<Entry>();
+    entry->modifiedTime = modifiedTime;
+
+    // other threads acquiring this file wait on the entry mutex until it is loaded
+    std::unique_lock<std::mutex> entryLock(entry->mutex);
+
+    m_LRU.push_front(filename);
+    m_Entries[filename] = Slot{entry, m_LRU.begin()};
+
+    lock.unlock();
+
+    this->Load(*entry, filename);
+    entryLock.unlock();
+
+    lock.lock();
+    it = m_Entries.find(filename);
+    if (it != m_Entries.end() && it->second.entry == entry)
+    {
+        m_MemoryUsage += entry->cost;
+        this->Evict();
+    }
+
+    return entry;
+}
+
+void DCMTKDatasetCache::Release(const std::string& filename, const EntryPointer& entry)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Entries.find(filename);
+    if (it != m_Entries.end() && (!entry || it->second.entry == entry))
+    {
+        m_MemoryUsage -= it->second.entry->cost;
+        m_LRU.erase(it->second.position);
+        m_Entries.erase(it);
+    }
+}
+
+void DCMTKDatasetCache::UpdateCost(const std::string& filename, const EntryPointer& entry)
+{
+    size_t cost = ComputeCost(*entry, filename);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Entries.find(filename);
+    if (it != m_Entries.end() && it->second.entry == entry)
+    {
+        m_MemoryUsage = m_MemoryUsage - entry->cost + cost;
+        entry->cost = cost;
+        this->Evict();
+    }
+    else
+    {
+        entry->cost = cost;
+    }
+}
+
+void DCMTKDatasetCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Entries.clear();
+    m_LRU.clear();
+    m_MemoryUsage = 0;
+}
+
+void DCMTKDatasetCache::SetMemoryBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_MemoryBudget = bytes;
+    this->Evict();
+}
+
+size_t DCMTKDatasetCache::GetMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_MemoryBudget;
+}
+
+size_t DCMTKDatasetCache::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_MemoryUsage;
+}
+
+unsigned long DCMTKDatasetCache::GetHits() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Hits;
+}
+
+unsigned long DCMTKDatasetCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Misses;
+}
+
+void DCMTKDatasetCache::Load(Entry& entry, const std::string& filename)
+{
+    OFFilename dcmFileName(filename, OFTrue);
+    entry.file = std::make_shared<DcmFileFormat>();
+
+    OFCondition condition = entry.file->loadFile(dcmFileName, EXS_Unknown, EGL_noChange, DCM_MaxReadLength, ERM_autoDetect);
+    if (condition.bad())
+    {
+        entry.error = condition.text();
+        entry.file.reset();
+        entry.cost = filename.size();
+        return;
+    }
+
+    entry.cost = ComputeCost(entry, filename);
+}
+
+size_t DCMTKDatasetCache::ComputeCost(const Entry& entry, const std::string& filename)
+{
+    if (!entry.file)
+    {
+        return filename.size();
+    }
+
+    // large values (mostly the pixel data) stay on disk until they are accessed
+    size_t cost = static_cast<size_t>(itksys::SystemTools::FileLength(filename));
+    DcmElement* pixelData = nullptr;
+    if (entry.file->getDataset()->findAndGetElement(DCM_PixelData, pixelData).good() &&
+        pixelData && !pixelData->valueLoaded())
+    {
+        cost -= std::min<size_t>(cost, pixelData->getLength());
+    }
+    return cost;
+}
+
+/**
+ * Drops the least recently used entries until the budget is met. The cache
+ * mutex must be locked.
+ */
+void DCMTKDatasetCache::Evict()
+{
+    while (m_MemoryUsage > m_MemoryBudget && !m_LRU.empty())
+    {
+        auto it = m_Entries.find(m_LRU.back());
+        m_MemoryUsage -= it->second.entry->cost;
+        m_Entries.erase(it);
+        m_LRU.pop_back();
+    }
+}
+
+} // end of namespace
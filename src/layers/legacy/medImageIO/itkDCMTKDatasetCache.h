@@ -0,0 +1,110 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medImageIOExport.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class DcmFileFormat;
+
+namespace itk
+{
+
+/**
+ * @class DCMTKDatasetCache
+ * @brief Process-wide cache of parsed DICOM files, shared by all the DCMTKImageIO.
+ *
+ * A file is parsed by DCMTK at most once while it stays in the cache: CanReadFile(),
+ * ReadImageInformation() and the pixel read of the same file reuse the same
+ * DcmFileFormat, even when they are done by different DCMTKImageIO instances
+ * (e.g. the header and the full read of an import).
+ *
+ * Entries are keyed by file path and modification time, and evicted in least
+ * recently used order when the cached datasets exceed the memory budget. Pixel
+ * data is loaded lazily by DCMTK and not accounted until it is read, holders
+ * loading it call UpdateCost(). Files which are not DICOM or which cannot be
+ * read are released by the probes.
+ */
+class MEDIMAGEIO_EXPORT DCMTKDatasetCache
+{
+public:
+    struct Entry
+    {
+        std::mutex mutex; // lock it while using the dataset
+        std::shared_ptr<DcmFileFormat> file;
+        std::string error; // load error, empty if the file was parsed
+        long modifiedTime = 0;
+        size_t cost = 0;
+
+        bool IsValid() const { return error.empty(); }
+    };
+    typedef std::shared_ptr<Entry> EntryPointer;
+
+    static DCMTKDatasetCache& Instance();
+
+    /**
+     * Returns the parsed file, loading it if it is not cached or if it
+     * changed on disk since it was cached. Lock the entry mutex before use.
+     */
+    EntryPointer Acquire(const std::string& filename);
+
+    /**
+     * Removes the file from the cache, current holders keep their entry.
+     * If entry is given, the file is only removed if it is cached in this entry.
+     */
+    void Release(const std::string& filename, const EntryPointer& entry = EntryPointer());
+
+    /**
+     * Accounts the memory used by the entry again, after its pixel data was
+     * loaded. Call it with the entry mutex locked.
+     */
+    void UpdateCost(const std::string& filename, const EntryPointer& entry);
+
+    void Clear();
+
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const;
+    size_t GetMemoryUsage() const;
+
+    unsigned long GetHits() const;
+    unsigned long GetMisses() const;
+
+private:
+    DCMTKDatasetCache();
+
+    void Load(Entry& entry, const std::string& filename);
+    static size_t ComputeCost(const Entry& entry, const std::string& filename);
+    void Evict();
+
+    typedef std::list<std::string> LRUListType;
+    struct Slot
+    {
+        EntryPointer entry;
+        LRUListType::iterator position;
+    };
+
+    mutable std::mutex m_Mutex;
+    std::map<std::string, Slot> m_Entries;
+    LRUListType m_LRU; // most recently used first
+    size_t m_MemoryBudget;
+    size_t m_MemoryUsage;
+    unsigned long m_Hits;
+    unsigned long m_Misses;
+};
+
+} // end of namespace
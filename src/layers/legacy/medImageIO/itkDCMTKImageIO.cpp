@@ -12,6 +12,7 @@
 =========================================================================*/
 
 #include <itkDCMTKImageIO.h>
+#include <itkDCMTKDatasetCache.h>
 
 #ifndef WIN32
 #define HAVE_CONFIG_H
@@ -77,14 +78,24 @@ void DCMTKImageIO::PrintSelf (std::ostream& os, Indent indent) const
 
 bool DCMTKImageIO::CanReadFile(const char* filename)
 {
-    OFFilename dcmFileName(filename, OFTrue);
-    DcmFileFormat dicomFile;
-    OFCondition condition = dicomFile.loadFile(dcmFileName);
-    if ( !condition.good() )
+    DCMTKDatasetCache::EntryPointer entry = DCMTKDatasetCache::Instance().Acquire(filename);
+    bool canRead = false;
     {
-        return false;
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        canRead = entry->IsValid() && CanReadDataset(*entry->file);
     }
 
+    if (!canRead)
+    {
+        // files of other formats probed by the readers must not fill the cache
+        DCMTKDatasetCache::Instance().Release(filename, entry);
+    }
+    return canRead;
+}
+
+
+bool DCMTKImageIO::CanReadDataset(DcmFileFormat& dicomFile)
+{
     E_TransferSyntax xfer = dicomFile.getDataset()->getOriginalXfer();
 
     if( xfer == EXS_JPEG2000LosslessOnly ||
@@ -376,19 +387,17 @@ void DCMTKImageIO::DetermineNumberOfPixelComponents()
 
 void DCMTKImageIO::DeterminePixelType()
 {
-    OFFilename dcmFileName(m_FileName, OFTrue);
-    DcmFileFormat dicomFile;
-    OFCondition condition = dicomFile.loadFile(dcmFileName);
-    
-    if (condition.bad())
+    DCMTKDatasetCache::EntryPointer entry = DCMTKDatasetCache::Instance().Acquire(m_FileName);
+    std::lock_guard<std::mutex> lock(entry->mutex);
+
+    if (!entry->IsValid())
     {
         this->SetComponentType(itk::IOComponentEnum::UNKNOWNCOMPONENTTYPE);
         return;
     }
 
-    DicomImage image(&dicomFile, EXS_Unknown, CIF_UseAbsolutePixelRange, 0, 0);
-    if (condition.good())
     {
+        DicomImage image(entry->file.get(), EXS_Unknown, CIF_UseAbsolutePixelRange, 0, 0);
         if (image.getStatus() == EIS_Normal)
         {
             const DiPixel *dmp = image.getInterData();
@@ -428,6 +437,9 @@ void DCMTKImageIO::DeterminePixelType()
             this->SetComponentType (itk::IOComponentEnum::UNKNOWNCOMPONENTTYPE);
         }
     }
+
+    // DicomImage loaded the pixel data in the cached dataset
+    DCMTKDatasetCache::Instance().UpdateCost(m_FileName, entry);
 }
 
 
@@ -751,14 +763,17 @@ void DCMTKImageIO::InternalRead (void* buffer, int slice, unsigned long pixelCou
     std::string filename;
     filename = m_OrderedFileNames[slice];
 
-    OFFilename dcmFileName(filename, OFTrue);
-    DcmFileFormat dicomFile;
+    // the header pass usually parsed this file already, the pixels are only
+    // read once so the file does not need to stay in the cache afterwards
+    DCMTKDatasetCache::EntryPointer entry = DCMTKDatasetCache::Instance().Acquire(filename);
+    DCMTKDatasetCache::Instance().Release(filename);
 
-    OFCondition cond = dicomFile.loadFile(dcmFileName, EXS_Unknown, EGL_noChange, DCM_MaxReadLength, ERM_autoDetect);
-    if (cond.bad())
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (!entry->IsValid())
     {
-        itkExceptionMacro (<< cond.text() );
+        itkExceptionMacro (<< entry->error );
     }
+    DcmFileFormat& dicomFile = *entry->file;
 
     E_TransferSyntax xfer = dicomFile.getDataset()->getOriginalXfer();
 
@@ -1068,15 +1083,15 @@ DCMTKImageIO
 
 void DCMTKImageIO::ReadHeader(const std::string& name, const int& fileIndex, const int& fileCount )
 {
-    OFFilename dcmFileName(name, OFTrue);
-    DcmFileFormat dicomFile;
-    OFCondition condition = dicomFile.loadFile(dcmFileName);
+    DCMTKDatasetCache::EntryPointer entry = DCMTKDatasetCache::Instance().Acquire(name);
+    std::lock_guard<std::mutex> lock(entry->mutex);
 
     // checking that given file is available
-    if ( !condition.good() )
+    if ( !entry->IsValid() )
     {
-        itkExceptionMacro ( << condition.text() );
+        itkExceptionMacro ( << entry->error );
     }
+    DcmFileFormat& dicomFile = *entry->file;
 
     // reading meta info
     DcmMetaInfo* metaInfo = dicomFile.getMetaInfo();
@@ -28,6 +28,7 @@
 
 
 class DcmElement;
+class DcmFileFormat;
 
 class double_fuzzy_less
 {
@@ -169,6 +170,8 @@ protected:
 
     void SwapBytesIfNecessary(void* buffer, unsigned long numberOfPixels);
 
+    static bool CanReadDataset(DcmFileFormat& dicomFile);
+
     void DetermineNumberOfPixelComponents();
     void DeterminePixelType();
 
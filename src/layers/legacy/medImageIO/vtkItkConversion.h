@@ -20,6 +20,7 @@ PURPOSE.
 #include <vtkAlgorithmOutput.h>
 #include <vtkMatrix4x4.h>
 
+#include <list>
 #include <vector>
 
 class medAbstractData;
@@ -60,6 +61,8 @@ protected:
 * @class vtkItkConversion "Template class for itk to vtk converter" ServiceDescr.h
 * @brief Template for itk to vtk converter. It inherits vtkItkConversionInterface.
 * @detail It keep inside the ITK input image and provide for output an vtk port.<br>The hearth of this class is a itk::ImageToVTKImageFilter
+*         The volumes of a 4D image are exposed as images sharing the 4D buffer, nothing is copied.<br>
+*         If the 4D buffer does not hold the whole image, the displayed volume is copied and the last ones are kept in a small cache.
 */
 template <typename volumeType, unsigned int imageDim>
 class vtkItkConversion final : public vtkItkConversionInterface
@@ -77,11 +80,12 @@ private:
     // ///////////////////////////////////////////////////////////////////////
     // 4D
     typename itk::Image<volumeType, 4>::Pointer m_ItkInputImage4D;  /*!<Keep 4D ITK input image. */
-    std::vector<typename itk::Image<volumeType, 3>::Pointer> m_oVolumeVectorFrom4D; /*!<Internal vector for each 3D ITK volume extracted from 4D ITK input image. */
     unsigned int m_uiCurrentTimeIndex; /*!<Keep current index of the time line. */
     unsigned int m_uiNbVolume; /*!<Number of extracted volume. */
     float m_fTotalTime; /*!<Time line in second. */
 
+    std::list<std::pair<unsigned int, typename Image3DType::Pointer> > m_oFrameCache; /*!<Last copied volumes, most recent first, when the 4D buffer cannot be shared. */
+
 public:
     vtkItkConversion();
     virtual ~vtkItkConversion();
@@ -106,6 +110,14 @@ private:
     bool initializeImage(typename itk::ImageBase<imageDim>::Pointer &input);
     bool volumeExtraction();
     void conversion();
+
+    typename Image3DType::Pointer frame(unsigned int pi_uiTimeIndex);
+    typename Image3DType::Pointer frameView(unsigned int pi_uiTimeIndex);
+    typename Image3DType::Pointer frameCopy(unsigned int pi_uiTimeIndex) const;
+    typename Image3DType::Pointer frameGeometry() const;
+    bool isBufferComplete() const;
+
+    static const unsigned int s_uiFrameCacheSize = 3; /*!<Number of copied volumes kept. */
 };
 
 #include <vtkItkConversion.tpp>
@@ -11,6 +11,11 @@ PURPOSE.
 
 =========================================================================*/
 
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <vnl/algo/vnl_determinant.h>
+
 template <typename volumeType, unsigned int imageDim>
 vtkItkConversion<volumeType, imageDim>::vtkItkConversion() :m_ImageConverter(ConverterType::New()), m_uiCurrentTimeIndex(0), m_uiNbVolume(0), m_fTotalTime(0) {}
 
@@ -143,7 +148,8 @@ bool vtkItkConversion<volumeType, imageDim>::initializeImage(typename itk::Image
 }
 
 /**
-* @brief  This internal function process the extraction of diffrents volume from 4D image input.
+* @brief  This internal function prepares the access to the diffrents volumes of the 4D image input.
+* @details Only the first volume is provided, the others are provided by setTimeIndex.
 * @return True if succed. False in other cases.
 */
 template <typename volumeType, unsigned int imageDim>
@@ -153,58 +159,15 @@ bool vtkItkConversion<volumeType, imageDim>::volumeExtraction()
 
     auto size = m_ItkInputImage4D->GetLargestPossibleRegion().GetSize();
     m_uiNbVolume = size[3];
-    m_oVolumeVectorFrom4D.reserve(m_uiNbVolume);
-
-    // split the 4D volume into 3D volumes
-    typename Image4DType::RegionType regionToExtract = m_ItkInputImage4D->GetLargestPossibleRegion();
-    typename Image4DType::IndexType index;
-    index[0] = 0;
-    index[1] = 0;
-    index[2] = 0;
-    index[3] = 0;
-    size[3] = 0;
-
-    regionToExtract.SetSize(size);
-    regionToExtract.SetIndex(index);
+    m_oFrameCache.clear();
 
     if (m_uiNbVolume > 0)
     {
         double dTimeResolution = m_ItkInputImage4D->GetSpacing()[3];
         m_fTotalTime = dTimeResolution * (m_uiNbVolume-1);
-        m_oVolumeVectorFrom4D.resize(m_uiNbVolume);
-
-        for (unsigned int n = 0; (n < m_uiNbVolume) && bRes; n++)
-        {
-            typedef typename itk::ExtractImageFilter<Image4DType, Image3DType> ExtractImageType;
-            regionToExtract.SetIndex(3, n);
-            typename ExtractImageType::Pointer myExtractor = ExtractImageType::New();
-            myExtractor->SetExtractionRegion(regionToExtract);
-            myExtractor->SetDirectionCollapseToGuess();
-            myExtractor->SetInput(m_ItkInputImage4D);
-
-            try
-            {
-                myExtractor->Update();
-            }
-            catch (itk::ExceptionObject &e)
-            {
-                bRes = false;
-                std::cerr << "no volume into 4D image with exception : " << e << std::endl;
-            }
-
-            try
-            {
-                myExtractor->GetOutput();
-                m_oVolumeVectorFrom4D[n] = myExtractor->GetOutput();
-            }
-            catch (itk::ExceptionObject &e)
-            {
-                bRes = false;
-                std::cerr<< "error when extracting volume from 4D itk image on volume : " << n << " \n with exception" << e << std::endl;
-            }
-        }
 
-        m_ItkInputImage = m_oVolumeVectorFrom4D[0];
+        m_ItkInputImage = frame(0);
+        bRes = m_ItkInputImage.IsNotNull();
     }
     else
     {
@@ -215,6 +178,140 @@ bool vtkItkConversion<volumeType, imageDim>::volumeExtraction()
 
 }
 
+/**
+* @brief  This internal function provides a volume of the 4D image input, sharing its buffer if possible.
+* @param  pi_uiTimeIndex [in] cardinal number of the volume (0..N-1).
+* @return The 3D volume.
+*/
+template <typename volumeType, unsigned int imageDim>
+typename vtkItkConversion<volumeType, imageDim>::Image3DType::Pointer vtkItkConversion<volumeType, imageDim>::frame(unsigned int pi_uiTimeIndex)
+{
+    typename Image3DType::Pointer frameRes;
+
+    if (isBufferComplete())
+    {
+        return frameView(pi_uiTimeIndex);
+    }
+
+    // the volume must be copied, look in the recent copies first
+    for (auto it = m_oFrameCache.begin(); it != m_oFrameCache.end(); ++it)
+    {
+        if (it->first == pi_uiTimeIndex)
+        {
+            frameRes = it->second;
+            m_oFrameCache.splice(m_oFrameCache.begin(), m_oFrameCache, it);
+            return frameRes;
+        }
+    }
+
+    frameRes = frameCopy(pi_uiTimeIndex);
+
+    m_oFrameCache.push_front(std::make_pair(pi_uiTimeIndex, frameRes));
+    while (m_oFrameCache.size() > s_uiFrameCacheSize)
+    {
+        m_oFrameCache.pop_back();
+    }
+
+    return frameRes;
+}
+
+/**
+* @brief  This internal function builds a volume sharing the buffer of the 4D image input, without copy.
+* @details The 4D image input must stay alive as long as the volume is used, it is kept by m_ItkInputImage4D.
+* @param  pi_uiTimeIndex [in] cardinal number of the volume (0..N-1).
+* @return The 3D volume.
+*/
+template <typename volumeType, unsigned int imageDim>
+typename vtkItkConversion<volumeType, imageDim>::Image3DType::Pointer vtkItkConversion<volumeType, imageDim>::frameView(unsigned int pi_uiTimeIndex)
+{
+    typename Image3DType::Pointer frameRes = frameGeometry();
+
+    // the time dimension varies the slowest, each volume is a contiguous block of the 4D buffer
+    itk::SizeValueType frameSize = frameRes->GetLargestPossibleRegion().GetNumberOfPixels();
+
+    typedef typename Image3DType::PixelContainer PixelContainerType;
+    typename PixelContainerType::Pointer container = PixelContainerType::New();
+    container->SetImportPointer(m_ItkInputImage4D->GetBufferPointer() + pi_uiTimeIndex * frameSize, frameSize, false);
+    frameRes->SetPixelContainer(container);
+
+    return frameRes;
+}
+
+/**
+* @brief  This internal function copies a volume of the 4D image input.
+* @details It does not modify the 4D image input nor its pipeline, so it can be run on a background thread.
+* @param  pi_uiTimeIndex [in] cardinal number of the volume (0..N-1).
+* @return The 3D volume.
+*/
+template <typename volumeType, unsigned int imageDim>
+typename vtkItkConversion<volumeType, imageDim>::Image3DType::Pointer vtkItkConversion<volumeType, imageDim>::frameCopy(unsigned int pi_uiTimeIndex) const
+{
+    typename Image3DType::Pointer frameRes = frameGeometry();
+    frameRes->Allocate();
+
+    typename Image4DType::RegionType regionToExtract = m_ItkInputImage4D->GetLargestPossibleRegion();
+    regionToExtract.SetIndex(3, regionToExtract.GetIndex()[3] + pi_uiTimeIndex);
+    regionToExtract.SetSize(3, 1);
+
+    itk::ImageRegionConstIterator<Image4DType> inputIt(m_ItkInputImage4D, regionToExtract);
+    itk::ImageRegionIterator<Image3DType> outputIt(frameRes, frameRes->GetLargestPossibleRegion());
+    for (; !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+        outputIt.Set(inputIt.Get());
+    }
+
+    return frameRes;
+}
+
+/**
+* @brief  This internal function creates an unallocated volume with the geometry of the 4D image input.
+* @details The direction is collapsed as itk::ExtractImageFilter::SetDirectionCollapseToGuess() does.
+* @return The 3D volume, without buffer.
+*/
+template <typename volumeType, unsigned int imageDim>
+typename vtkItkConversion<volumeType, imageDim>::Image3DType::Pointer vtkItkConversion<volumeType, imageDim>::frameGeometry() const
+{
+    typename Image4DType::RegionType region4D = m_ItkInputImage4D->GetLargestPossibleRegion();
+    typename Image3DType::RegionType region3D;
+    typename Image3DType::SpacingType spacing;
+    typename Image3DType::PointType origin;
+    typename Image3DType::DirectionType direction;
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        region3D.SetIndex(i, region4D.GetIndex()[i]);
+        region3D.SetSize(i, region4D.GetSize()[i]);
+        spacing[i] = m_ItkInputImage4D->GetSpacing()[i];
+        origin[i] = m_ItkInputImage4D->GetOrigin()[i];
+        for (unsigned int j = 0; j < 3; j++)
+        {
+            direction(i, j) = m_ItkInputImage4D->GetDirection()(i, j);
+        }
+    }
+    if (vnl_determinant(direction.GetVnlMatrix()) == 0.0)
+    {
+        direction.SetIdentity();
+    }
+
+    typename Image3DType::Pointer frameRes = Image3DType::New();
+    frameRes->SetRegions(region3D);
+    frameRes->SetSpacing(spacing);
+    frameRes->SetOrigin(origin);
+    frameRes->SetDirection(direction);
+
+    return frameRes;
+}
+
+/**
+* @brief  This internal function checks that the 4D buffer holds the whole image, which is needed to share it.
+*/
+template <typename volumeType, unsigned int imageDim>
+bool vtkItkConversion<volumeType, imageDim>::isBufferComplete() const
+{
+    return m_ItkInputImage4D->GetBufferPointer() &&
+           m_ItkInputImage4D->GetBufferedRegion() == m_ItkInputImage4D->GetLargestPossibleRegion();
+}
+
 /**
 * @brief  This function change the current volume of 4D image.
 * @param  pi_uiTimeIndex [in] cardinal number of extracter volume (0..N-1).
@@ -229,7 +326,7 @@ bool vtkItkConversion<volumeType, imageDim>::setTimeIndex(unsigned int pi_uiTime
     {
         if (pi_uiTimeIndex < m_uiNbVolume)
         {
-            m_ItkInputImage = m_oVolumeVectorFrom4D[pi_uiTimeIndex];
+            m_ItkInputImage = frame(pi_uiTimeIndex);
             conversion();
             m_uiCurrentTimeIndex = pi_uiTimeIndex;
         }
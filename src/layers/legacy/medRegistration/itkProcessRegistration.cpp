@@ -18,6 +18,8 @@
 
 #include <medAbstractData.h>
 #include <medAbstractDataFactory.h>
+#include <medJobScheduler.h>
+#include <registrationPreprocessingCache.h>
 
 #include <itkCastImageFilter.h>
 
@@ -38,6 +40,13 @@
 #include <itkExtractImageFilter.h>
 
 #include <itkCommand.h>
+#include <itkDisplacementFieldTransform.h>
+#include <itkIdentityTransform.h>
+#include <itkTransformFileWriter.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent>
 
 #include <time.h>
 
@@ -56,6 +65,15 @@ public:
     itkProcessRegistration::ImageType movingImageType;
     dtkSmartPointer<medAbstractData> output;
 
+    // 4D moving image, the registered series keeps its time axis
+    itk::ImageBase<4>::Pointer movingSeries;
+    int referenceFrame;
+    int maximumConcurrentFrames;
+    int workUnits;
+    // one process per registered frame, null for the reference frame
+    QVector<itkProcessRegistration *> frameRegistrations;
+    QVector<itk::Transform<double,3,3>::Pointer> frameTransforms;
+
     template <class PixelType>
             void setInput(medAbstractData * data,int channel);
     mutable QMutex mutex;
@@ -72,6 +90,9 @@ itkProcessRegistration::itkProcessRegistration() : medAbstractRegistrationProces
     d->dimensions=3;
     d->fixedImageType = itkProcessRegistration::FLOAT;
     d->movingImageType = itkProcessRegistration::FLOAT;
+    d->referenceFrame = -1;
+    d->maximumConcurrentFrames = 0;
+    d->workUnits = 0;
     QStringList types;
 
     types << "text" << "notText";
@@ -81,6 +102,7 @@ itkProcessRegistration::itkProcessRegistration() : medAbstractRegistrationProces
 
 itkProcessRegistration::~itkProcessRegistration()
 {
+    qDeleteAll(d->frameRegistrations);
     delete d;
     d = 0;
 }
@@ -134,6 +156,7 @@ template <typename PixelType>
         if (channel==1)
         {
             movingImageType = inputType;
+            movingSeries = nullptr;
             movingImages = QVector<itk::ImageBase<3>::Pointer>(1);
             movingImages[0] =  dynamic_cast<InputImageType *>((itk::Object*)(data->data()));
 
@@ -178,6 +201,8 @@ template <typename PixelType>
         if(channel == 1)
         {
         //may work on dim > 3
+        movingImageType = inputType;
+        movingSeries = image4d.GetPointer();
         movingImages = QVector<itk::ImageBase<3>::Pointer>(frameNumber);
 
         for(unsigned int i = 0 ; i < frameNumber ; i++)
@@ -225,7 +250,7 @@ class CastFilterTemplateAdapter : public CastFilterAdapter
 public:
     CastFilterTemplateAdapter() : CastFilterAdapter() { m_CasterPointer = CastFilterType::New(); }
 
-    typedef typename itk::Image< float, 3 > RegImageType; // We always convert to float,3
+    typedef typename itk::Image< float, S > RegImageType; // We always convert to float
     typedef typename itk::Image<T, S> ImageType; // input data type
     typedef typename itk::CastImageFilter<ImageType, RegImageType> CastFilterType;
     typedef typename CastFilterType::Pointer TYPEPTR;
@@ -254,6 +279,16 @@ private:
 
 };
 
+template <class T>
+CastFilterAdapter *createCastFilterAdapter(unsigned int dimensions)
+{
+    if (dimensions == 4)
+    {
+        return new CastFilterTemplateAdapter<T, 4>;
+    }
+    return new CastFilterTemplateAdapter<T, 3>;
+}
+
 
 bool itkProcessRegistration::setInputData(medAbstractData *data, int channel)
 {
@@ -276,7 +311,8 @@ bool itkProcessRegistration::setInputData(medAbstractData *data, int channel)
 
     *last_charac = '3';
 
-    dtkSmartPointer <medAbstractData> convertedData = medAbstractDataFactory::instance()->create ("itkDataImageFloat3");
+    // 4D images are converted as a whole, their frames are extracted afterwards
+    dtkSmartPointer <medAbstractData> convertedData = medAbstractDataFactory::instance()->create (d->dimensions == 4 ? "itkDataImageFloat4" : "itkDataImageFloat3");
     for( QString metaData : data->metaDataList() )
     {
         convertedData->setMetaData ( metaData, data->metaDataValues ( metaData ) );
@@ -293,35 +329,35 @@ bool itkProcessRegistration::setInputData(medAbstractData *data, int channel)
     QScopedPointer<CastFilterAdapter> castFilterAdapterPtr;
     if (id =="itkDataImageChar3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<char>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<char>(d->dimensions));
     }
     else if (id =="itkDataImageUChar3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<unsigned char>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<unsigned char>(d->dimensions));
     }
     else if (id == "itkDataImageShort3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<short>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<short>(d->dimensions));
     }
     else if (id == "itkDataImageUShort3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<unsigned short>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<unsigned short>(d->dimensions));
     }
     else if(id == "itkDataImageInt3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<int>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<int>(d->dimensions));
     }
     else if(id == "itkDataImageUInt3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<unsigned int>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<unsigned int>(d->dimensions));
     }
     else if(id == "itkDataImageLong3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<long>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<long>(d->dimensions));
     }
     else if(id == "itkDataImageULong3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<unsigned long>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<unsigned long>(d->dimensions));
     }
     else if(id == "itkDataImageFloat3")
     {
@@ -329,16 +365,24 @@ bool itkProcessRegistration::setInputData(medAbstractData *data, int channel)
     }
     else if(id == "itkDataImageDouble3")
     {
-        castFilterAdapterPtr.reset(new CastFilterTemplateAdapter<double>);
+        castFilterAdapterPtr.reset(createCastFilterAdapter<double>(d->dimensions));
     }
 
     try
     {
         if (castFilterAdapterPtr)
         {
-            castFilterAdapterPtr->SetInput(data->data());
-            castFilterAdapterPtr->Update();
-            convertedData->setData(castFilterAdapterPtr->GetOutput());
+            registrationPreprocessingCache *cache = registrationPreprocessingCache::instance();
+            itk::DataObject::Pointer floatImage = cache->floatImage(data, d->dimensions);
+            if (floatImage.IsNull())
+            {
+                castFilterAdapterPtr->SetInput(data->data());
+                castFilterAdapterPtr->Update();
+                floatImage = static_cast<itk::DataObject *>(castFilterAdapterPtr->GetOutput());
+                floatImage->DisconnectPipeline();
+                cache->insertFloatImage(data, d->dimensions, floatImage);
+            }
+            convertedData->setData(floatImage.GetPointer());
             d->setInput<float>(convertedData,channel);
         }
     }
@@ -368,6 +412,16 @@ int itkProcessRegistration::update(itkProcessRegistration::ImageType)
 }
 
 
+bool itkProcessRegistration::supportsFrameRegistration() const
+{
+    return false;
+}
+
+itkProcessRegistration *itkProcessRegistration::createFrameRegistration()
+{
+    return nullptr;
+}
+
 int itkProcessRegistration::update()
 {
     if (!d->mutex.tryLock())
@@ -376,13 +430,185 @@ int itkProcessRegistration::update()
     }
 
     if(d->fixedImage.IsNull() || d->movingImages.empty())
+    {
+        d->mutex.unlock();
         return 1;
+    }
 
-    int retval =  update(d->fixedImageType);
+    qDeleteAll(d->frameRegistrations);
+    d->frameRegistrations.clear();
+    d->frameTransforms.clear();
+
+    int retval = 1;
+    if (d->movingImages.size() > 1 && supportsFrameRegistration())
+    {
+        retval = updateFrames();
+    }
+    else
+    {
+        retval = update(d->fixedImageType);
+    }
     d->mutex.unlock();
     return retval;
 }
 
+int itkProcessRegistration::updateFrames()
+{
+    typedef itk::Image<float, 3> FrameImageType;
+    typedef itk::Image<float, 4> SeriesImageType;
+
+    const int frameCount = d->movingImages.size();
+    const bool toReferenceFrame = d->referenceFrame >= 0 && d->referenceFrame < frameCount;
+    itk::ImageBase<3>::Pointer reference = toReferenceFrame ? d->movingImages[d->referenceFrame] : d->fixedImage;
+    FrameImageType *referenceImage = dynamic_cast<FrameImageType *>(reference.GetPointer());
+    if (!referenceImage || d->movingSeries.IsNull())
+    {
+        return 1;
+    }
+
+    // The registration job runs several frames at once, they share the threads it is given.
+    // The frames do not go through the job scheduler, the job would wait for jobs queued after it.
+    const int threadCount = std::max(1, medJobScheduler::instance()->threadsPerJob());
+    int concurrentFrames = d->maximumConcurrentFrames > 0 ? d->maximumConcurrentFrames : threadCount;
+    concurrentFrames = std::max(1, std::min(concurrentFrames, frameCount));
+
+    // Each frame process gets its own image objects on the buffers of the inputs:
+    // the buffers are only read, but pipelines change the requested region of their input.
+    d->frameRegistrations.fill(nullptr, frameCount);
+    for (int i = 0; i < frameCount; ++i)
+    {
+        if (toReferenceFrame && i == d->referenceFrame)
+        {
+            continue;
+        }
+
+        FrameImageType *movingImage = dynamic_cast<FrameImageType *>(d->movingImages[i].GetPointer());
+        itkProcessRegistration *frame = createFrameRegistration();
+        if (!movingImage || !frame)
+        {
+            delete frame;
+            return 1;
+        }
+
+        FrameImageType::Pointer fixedFrame = FrameImageType::New();
+        fixedFrame->Graft(referenceImage);
+        FrameImageType::Pointer movingFrame = FrameImageType::New();
+        movingFrame->Graft(movingImage);
+
+        frame->d->dimensions = 3;
+        frame->d->fixedImage = fixedFrame.GetPointer();
+        frame->d->fixedImageType = itkProcessRegistration::FLOAT;
+        frame->d->movingImages = QVector<itk::ImageBase<3>::Pointer>(1, itk::ImageBase<3>::Pointer(movingFrame.GetPointer()));
+        frame->d->movingImageType = itkProcessRegistration::FLOAT;
+        frame->d->output = medAbstractDataFactory::instance()->create("itkDataImageFloat3");
+        frame->d->workUnits = std::max(1, threadCount / concurrentFrames);
+        d->frameRegistrations[i] = frame;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(concurrentFrames);
+    QAtomicInt registeredFrames(0);
+    QList<QFuture<int> > results;
+    for (itkProcessRegistration *frame : d->frameRegistrations)
+    {
+        if (!frame)
+        {
+            continue;
+        }
+        results << QtConcurrent::run(&pool, [this, frame, frameCount, &registeredFrames]()
+        {
+            int result = 1;
+            try
+            {
+                result = frame->update();
+            }
+            catch (std::exception &e)
+            {
+                qDebug() << "Frame registration failed: " << e.what();
+            }
+            emit progressed(100 * (registeredFrames.fetchAndAddOrdered(1) + 1) / frameCount);
+            return result;
+        });
+    }
+    pool.waitForDone();
+
+    for (const QFuture<int> &result : results)
+    {
+        if (result.result() != 0)
+        {
+            return 1;
+        }
+    }
+
+    // The registered frames are on the grid of the reference image
+    SeriesImageType::RegionType region;
+    SeriesImageType::SpacingType spacing;
+    SeriesImageType::PointType origin;
+    SeriesImageType::DirectionType direction;
+    direction.SetIdentity();
+    const FrameImageType::RegionType &frameRegion = referenceImage->GetLargestPossibleRegion();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        region.SetIndex(i, frameRegion.GetIndex(i));
+        region.SetSize(i, frameRegion.GetSize(i));
+        spacing[i] = referenceImage->GetSpacing()[i];
+        origin[i] = referenceImage->GetOrigin()[i];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            direction[i][j] = referenceImage->GetDirection()[i][j];
+        }
+    }
+    region.SetIndex(3, d->movingSeries->GetLargestPossibleRegion().GetIndex(3));
+    region.SetSize(3, frameCount);
+    spacing[3] = d->movingSeries->GetSpacing()[3];
+    origin[3] = d->movingSeries->GetOrigin()[3];
+    direction[3][3] = d->movingSeries->GetDirection()[3][3];
+
+    SeriesImageType::Pointer series = SeriesImageType::New();
+    series->SetRegions(region);
+    series->SetSpacing(spacing);
+    series->SetOrigin(origin);
+    series->SetDirection(direction);
+    series->Allocate();
+
+    const itk::SizeValueType frameSize = frameRegion.GetNumberOfPixels();
+    for (int i = 0; i < frameCount; ++i)
+    {
+        itkProcessRegistration *frame = d->frameRegistrations[i];
+        FrameImageType *registered = nullptr;
+        itk::Transform<double,3,3>::Pointer transform;
+        if (frame)
+        {
+            registered = dynamic_cast<FrameImageType *>((itk::Object *)(frame->output()->data()));
+            transform = frame->getTransform();
+        }
+        else
+        {
+            registered = dynamic_cast<FrameImageType *>(d->movingImages[i].GetPointer());
+            transform = itk::IdentityTransform<double, 3>::New().GetPointer();
+        }
+
+        if (!registered || registered->GetBufferedRegion().GetNumberOfPixels() != frameSize)
+        {
+            qDebug() << "Frame" << i << "is not on the grid of the reference image";
+            return 1;
+        }
+        std::copy(registered->GetBufferPointer(), registered->GetBufferPointer() + frameSize,
+                  series->GetBufferPointer() + i * frameSize);
+        d->frameTransforms << transform;
+
+        // the frame processes are only kept for their transformations
+        if (frame)
+        {
+            frame->setOutput(nullptr);
+        }
+    }
+
+    d->output = medAbstractDataFactory::instance()->create("itkDataImageFloat4");
+    d->output->setData(series.GetPointer());
+    return 0;
+}
+
 medAbstractData *itkProcessRegistration::output()
 {
     return d->output;
@@ -411,6 +637,36 @@ itkProcessRegistration::ImageType itkProcessRegistration::movingImageType()
     return d->movingImageType;
 }
 
+void itkProcessRegistration::setReferenceFrame(int frame)
+{
+    d->referenceFrame = frame;
+}
+
+int itkProcessRegistration::referenceFrame() const
+{
+    return d->referenceFrame;
+}
+
+void itkProcessRegistration::setMaximumConcurrentFrames(int count)
+{
+    d->maximumConcurrentFrames = count;
+}
+
+int itkProcessRegistration::maximumConcurrentFrames() const
+{
+    return d->maximumConcurrentFrames;
+}
+
+int itkProcessRegistration::workUnits() const
+{
+    return d->workUnits;
+}
+
+QVector<itk::Transform<double,3,3>::Pointer> itkProcessRegistration::frameTransforms()
+{
+    return d->frameTransforms;
+}
+
 bool itkProcessRegistration::write(const QStringList& files)
 {
     if (files.count()!=2)
@@ -426,11 +682,83 @@ bool itkProcessRegistration::write(const QStringList& files)
 
     if(!files.at(1).isEmpty())
     {
+        if (!d->frameTransforms.isEmpty())
+        {
+            return writeFrameTransforms(files.at(1));
+        }
         return writeTransform(files.at(1));
     }
     return false;
 }
 
+bool itkProcessRegistration::writeFrameTransforms(const QString& file)
+{
+    QFileInfo fileInfo(file);
+    QString suffix = fileInfo.completeSuffix();
+    if (!suffix.isEmpty())
+    {
+        suffix.prepend('.');
+    }
+
+    for (int i = 0; i < d->frameTransforms.size(); ++i)
+    {
+        QString frameFile = fileInfo.dir().filePath(fileInfo.baseName() + QString("_frame%1").arg(i, 3, 10, QChar('0')) + suffix);
+        if (d->frameRegistrations[i])
+        {
+            if (!d->frameRegistrations[i]->writeTransform(frameFile))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // the reference frame is left as is
+        if (!writeIdentityTransform(frameFile, d->movingImages[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool itkProcessRegistration::writeIdentityTransform(const QString& file, itk::ImageBase<3> *grid)
+{
+    Q_UNUSED(grid);
+
+    itk::TransformFileWriterTemplate<double>::Pointer writer = itk::TransformFileWriterTemplate<double>::New();
+    writer->SetInput(itk::IdentityTransform<double, 3>::New());
+    writer->SetFileName(file.toStdString());
+    try
+    {
+        writer->Update();
+    }
+    catch (itk::ExceptionObject &e)
+    {
+        qDebug() << e.what();
+        return false;
+    }
+    return true;
+}
+
+itk::Transform<double,3,3>::Pointer itkProcessRegistration::identityDisplacementField(itk::ImageBase<3> *grid)
+{
+    typedef itk::DisplacementFieldTransform<double, 3> FieldTransformType;
+
+    FieldTransformType::DisplacementFieldType::Pointer field = FieldTransformType::DisplacementFieldType::New();
+    field->SetRegions(grid->GetLargestPossibleRegion());
+    field->SetOrigin(grid->GetOrigin());
+    field->SetSpacing(grid->GetSpacing());
+    field->SetDirection(grid->GetDirection());
+    field->Allocate();
+    FieldTransformType::OutputVectorType zero;
+    zero.Fill(0);
+    field->FillBuffer(zero);
+
+    FieldTransformType::Pointer transform = FieldTransformType::New();
+    transform->SetDisplacementField(field);
+    return transform.GetPointer();
+}
+
 bool itkProcessRegistration::writeTransform(const QString& file)
 {
     DTK_DEFAULT_IMPLEMENTATION;
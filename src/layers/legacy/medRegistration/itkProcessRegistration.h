@@ -30,6 +30,11 @@ class itkProcessRegistrationPrivate;
  * 2 input channels are used for the fixed and moving images.
  * The output is the registered image, not the transformation, since the for goal is to visualize images. The transformation is however reachable through the write(QStringList) function.
  *
+ * When the moving image is a 4D image and the subclass supports frame registration,
+ * every frame is registered to the fixed image, or to a reference frame of the series,
+ * in its own process run concurrently with the others. The output is then the
+ * motion-corrected 4D image and a transformation is written per frame.
+ *
  * The programmer may use at his leasure the Registration Programming Interface (RPI)
  * published there: http://gforge.inria.fr/projects/asclepiospublic/
  * to implement the registration algorithms.
@@ -141,6 +146,39 @@ public:
 
     virtual itk::Transform<double,3,3>::Pointer getTransform() = 0;
 
+    /**
+     * @brief Sets the frame of a 4D moving image the other frames are registered to.
+     *
+     * @param frame: index of the frame, -1 (the default) registers the frames to the fixed image.
+    */
+    void setReferenceFrame(int frame);
+    int referenceFrame() const;
+
+    /**
+     * @brief Sets the number of frames of a 4D moving image registered at the same time.
+     *
+     * @param count: number of frames, 0 (the default) uses one frame per core.
+    */
+    void setMaximumConcurrentFrames(int count);
+    int maximumConcurrentFrames() const;
+
+    /**
+     * @brief Gets the number of work units the ITK filters of the process are split in.
+     *
+     * Set on the processes registering the frames of a 4D moving image, so
+     * that the frames share the threads of the registration job.
+     *
+     * @return int: 0 (the default) leaves the ITK default.
+    */
+    int workUnits() const;
+
+    /**
+     * @brief Gets the transformation of each frame of a 4D moving image.
+     *
+     * @return empty if the last update did not register a 4D moving image frame by frame.
+    */
+    QVector<itk::Transform<double,3,3>::Pointer> frameTransforms();
+
     /**
     * @brief Returns a pointer on a QStringList containing the title of the algorithm and its parameters. The first element of the list is the title.
     * 
@@ -157,6 +195,8 @@ public slots:
      * @warning This function writes the image in the first file,
      * and the transformation in the second. Otheritems in the list are ignored.
      * An empty string as a first element with a path as the second only writes the transformation.
+     * When the frames of a 4D moving image were registered, one transformation is written per frame,
+     * the frame number being appended to the base name of the file (name_frame000.ext, ...).
      * A single element in the list means only the image will be written.
      *
      * This function is usualy called from the generic registration toolbox.
@@ -199,8 +239,47 @@ protected :
     */
     virtual int update(ImageType);
 
+    /**
+     * @brief Tells whether the frames of a 4D moving image can be registered one by one.
+     *
+     * Subclasses returning true implement createFrameRegistration(). The
+     * default returns false, in which case only the first frame is registered.
+    */
+    virtual bool supportsFrameRegistration() const;
+
+    /**
+     * @brief Creates the process registering one frame of a 4D moving image.
+     *
+     * Subclasses supporting the registration of 4D moving images return a new
+     * instance of themselves with the same parameters.
+     *
+     * @return itkProcessRegistration *: owned by the caller.
+    */
+    virtual itkProcessRegistration *createFrameRegistration();
+
+    /**
+     * @brief Writes the identity transformation, in the format of writeTransform().
+     *
+     * Written for the reference frame of a 4D moving image. The default writes
+     * an itk::IdentityTransform. Subclasses writing displacement fields write a
+     * null field, see identityDisplacementField().
+     *
+     * @param file: path to the file.
+     * @param grid: image the transformation is defined on.
+     * @return bool: true on successful operation, false otherwise.
+    */
+    virtual bool writeIdentityTransform(const QString& file, itk::ImageBase<3> *grid);
+
+    /**
+     * @brief Creates a displacement field transformation, null on the grid of the image.
+    */
+    static itk::Transform<double,3,3>::Pointer identityDisplacementField(itk::ImageBase<3> *grid);
+
     virtual bool setInputData(medAbstractData *data, int channel);
 
 private:
+    int updateFrames();
+    bool writeFrameTransforms(const QString& file);
+
     itkProcessRegistrationPrivate *d;
 };
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <registrationPreprocessingCache.h>
+
+#include <medAbstractData.h>
+
+#include <itkImage.h>
+
+#include <QCache>
+#include <QMutex>
+
+#include <limits>
+
+// /////////////////////////////////////////////////////////////////
+// registrationPreprocessingCachePrivate
+// /////////////////////////////////////////////////////////////////
+
+struct registrationCachedImage
+{
+    itk::DataObject::Pointer image;
+};
+
+class registrationPreprocessingCachePrivate
+{
+public:
+    // the cost of an image is its size in KB
+    QCache<QString, registrationCachedImage> images;
+    QMutex mutex;
+
+    static QString dataKey(medAbstractData *data);
+    static QString key(medAbstractData *data, unsigned int dimensions);
+    static qint64 imageSize(itk::DataObject *image);
+};
+
+QString registrationPreprocessingCachePrivate::dataKey(medAbstractData *data)
+{
+    if (data->dataIndex().isValid())
+    {
+        return data->dataIndex().asString() + "/";
+    }
+    return QString::number(reinterpret_cast<quintptr>(data), 16) + "/";
+}
+
+QString registrationPreprocessingCachePrivate::key(medAbstractData *data, unsigned int dimensions)
+{
+    itk::Object *image = static_cast<itk::Object *>(data->data());
+    if (!image)
+    {
+        return QString();
+    }
+    return dataKey(data) + QString::number(image->GetMTime()) + "/" + QString::number(dimensions);
+}
+
+qint64 registrationPreprocessingCachePrivate::imageSize(itk::DataObject *image)
+{
+    qint64 pixels = 0;
+    if (itk::ImageBase<3> *image3 = dynamic_cast<itk::ImageBase<3> *>(image))
+    {
+        pixels = image3->GetBufferedRegion().GetNumberOfPixels();
+    }
+    else if (itk::ImageBase<4> *image4 = dynamic_cast<itk::ImageBase<4> *>(image))
+    {
+        pixels = image4->GetBufferedRegion().GetNumberOfPixels();
+    }
+    return pixels * static_cast<qint64>(sizeof(float));
+}
+
+// /////////////////////////////////////////////////////////////////
+// registrationPreprocessingCache
+// /////////////////////////////////////////////////////////////////
+
+registrationPreprocessingCache * registrationPreprocessingCache::instance()
+{
+    if(!s_instance)
+        s_instance = new registrationPreprocessingCache();
+
+    return s_instance;
+}
+
+registrationPreprocessingCache::registrationPreprocessingCache() : d(new registrationPreprocessingCachePrivate)
+{
+    setMemoryBudget(Q_INT64_C(1) << 30);
+}
+
+registrationPreprocessingCache::~registrationPreprocessingCache()
+{
+    delete d;
+    d = nullptr;
+}
+
+itk::DataObject::Pointer registrationPreprocessingCache::floatImage(medAbstractData *data, unsigned int dimensions)
+{
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&d->mutex);
+    registrationCachedImage *cached = d->images.object(d->key(data, dimensions));
+    if (!cached)
+    {
+        return nullptr;
+    }
+
+    itk::LightObject::Pointer another = cached->image->CreateAnother();
+    itk::DataObject::Pointer image = dynamic_cast<itk::DataObject *>(another.GetPointer());
+    image->Graft(cached->image);
+    return image;
+}
+
+void registrationPreprocessingCache::insertFloatImage(medAbstractData *data, unsigned int dimensions, itk::DataObject *image)
+{
+    if (!data || !image)
+    {
+        return;
+    }
+
+    QString key = d->key(data, dimensions);
+    if (key.isEmpty())
+    {
+        return;
+    }
+
+    registrationCachedImage *cached = new registrationCachedImage;
+    cached->image = image;
+    int cost = static_cast<int>(qMax<qint64>(1, d->imageSize(image) / 1024));
+    {
+        QMutexLocker locker(&d->mutex);
+        // the cache takes the image, or deletes it when it is above the budget
+        d->images.insert(key, cached, cost);
+    }
+
+    connect(data, SIGNAL(dataModified(medAbstractData*)), this, SLOT(forget(medAbstractData*)), Qt::UniqueConnection);
+}
+
+void registrationPreprocessingCache::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&d->mutex);
+    d->images.setMaxCost(static_cast<int>(qBound<qint64>(1, bytes / 1024, std::numeric_limits<int>::max())));
+}
+
+qint64 registrationPreprocessingCache::memoryBudget()
+{
+    QMutexLocker locker(&d->mutex);
+    return static_cast<qint64>(d->images.maxCost()) * 1024;
+}
+
+void registrationPreprocessingCache::clear()
+{
+    QMutexLocker locker(&d->mutex);
+    d->images.clear();
+}
+
+void registrationPreprocessingCache::forget(medAbstractData *data)
+{
+    QString prefix = d->dataKey(data);
+
+    QMutexLocker locker(&d->mutex);
+    for (const QString &key : d->images.keys())
+    {
+        if (key.startsWith(prefix))
+        {
+            d->images.remove(key);
+        }
+    }
+}
+
+registrationPreprocessingCache *registrationPreprocessingCache::s_instance = nullptr;
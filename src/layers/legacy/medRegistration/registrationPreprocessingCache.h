@@ -0,0 +1,77 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QObject>
+
+#include <itkDataObject.h>
+
+#include <medRegistrationExport.h>
+
+class medAbstractData;
+class registrationPreprocessingCachePrivate;
+
+/**
+ * @brief Inputs of the registrations converted to float, kept for the next runs.
+ *
+ * Running a registration again on the same images, with other parameters,
+ * does not convert them again. A converted image is keyed by the index of
+ * the data (or the data itself when it has no index), the modification time
+ * of its image and the number of dimensions. The entries of a data are
+ * dropped when the data is modified.
+ *
+ * The least recently used images are evicted when the memory budget
+ * (1 GB by default) is exceeded.
+ */
+class MEDREGISTRATIONFACTORY_EXPORT registrationPreprocessingCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static registrationPreprocessingCache * instance();
+
+    /**
+    * @brief Gets the float image converted from a data.
+    *
+    * The image returned shares the buffer of the cached one, it may be used
+    * by a registration while another one uses the same cached image.
+    *
+    * @return itk::DataObject::Pointer: a float itk::Image, null if not cached.
+    */
+    itk::DataObject::Pointer floatImage(medAbstractData *data, unsigned int dimensions);
+
+    void insertFloatImage(medAbstractData *data, unsigned int dimensions, itk::DataObject *image);
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget();
+
+public slots:
+    void clear();
+
+private slots:
+    void forget(medAbstractData *data);
+
+protected:
+    /**
+    * @brief Constructor, not to be used by users.
+    *
+    * Use the instance() method instead to get a singleton.
+    */
+    registrationPreprocessingCache();
+    ~registrationPreprocessingCache();
+
+private:
+    static registrationPreprocessingCache* s_instance;
+
+    registrationPreprocessingCachePrivate * d;
+};
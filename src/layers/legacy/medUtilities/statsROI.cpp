@@ -192,6 +192,19 @@ public:
 
     template <class ImageType> int runMinMax()
     {
+        // reuse the statistics cached on the data when it provides them
+        medAbstractImageData *imageData = dynamic_cast<medAbstractImageData*>(composite->input0.data());
+        if (imageData)
+        {
+            medImageStatistics statistics = imageData->statistics();
+            if (statistics.isValid())
+            {
+                composite->computedOutput.push_back(statistics.minimum);
+                composite->computedOutput.push_back(statistics.maximum);
+                return DTK_SUCCEED;
+            }
+        }
+
         typedef itk::MinimumMaximumImageCalculator <ImageType> ImageCalculatorFilterType;
         typename ImageCalculatorFilterType::Pointer imageCalculatorFilter
                 = ImageCalculatorFilterType::New ();
@@ -171,16 +171,30 @@ void medClutEditorToolBox::setData(medAbstractData *data)
 
         d->histogram = new medClutEditorHistogram();
         this->getScene()->addItem( d->histogram );
-        int min_range = image->minRangeValue();
-        int max_range = image->maxRangeValue();
         QMap<qreal, qreal> bins;
 
-        for ( int i = min_range; i <= max_range; ++i )
+        medImageStatistics statistics = image->statistics();
+        if ( statistics.isValid() )
         {
-            qreal count = static_cast< qreal >(
-                        image->scalarValueCount( i - min_range ) ); //the histogram (calculated in itkDataImage)'s first value is 0
-            //otherwise shift of this histogram
-            bins.insert( static_cast< qreal >( i ), count );
+            // cached on the data, one entry per bin rather than per value
+            for ( int i = 0; i < statistics.histogram.size(); ++i )
+            {
+                bins.insert( statistics.histogramOrigin + i * statistics.binWidth,
+                             static_cast< qreal >( statistics.histogram[i] ) );
+            }
+        }
+        else
+        {
+            int min_range = image->minRangeValue();
+            int max_range = image->maxRangeValue();
+
+            for ( int i = min_range; i <= max_range; ++i )
+            {
+                qreal count = static_cast< qreal >(
+                            image->scalarValueCount( i - min_range ) ); //the histogram (calculated in itkDataImage)'s first value is 0
+                //otherwise shift of this histogram
+                bins.insert( static_cast< qreal >( i ), count );
+            }
         }
         d->histogram->setValues( bins );
 
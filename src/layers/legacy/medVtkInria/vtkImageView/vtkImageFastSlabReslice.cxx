@@ -0,0 +1,484 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include "vtkImageFastSlabReslice.h"
+
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+vtkStandardNewMacro(vtkImageFastSlabReslice);
+
+namespace
+{
+
+// Voxels on each side of the continuous index c along an axis of n voxels
+inline bool locate(double c, int n, int &i0, int &i1, float &weight)
+{
+    const double tolerance = 1e-3;
+    if (c < -tolerance || c > n - 1 + tolerance)
+    {
+        return false;
+    }
+    if (c <= 0 || n == 1)
+    {
+        i0 = i1 = 0;
+        weight = 0;
+    }
+    else if (c >= n - 1)
+    {
+        i0 = i1 = n - 1;
+        weight = 0;
+    }
+    else
+    {
+        i0 = static_cast<int>(c);
+        i1 = i0 + 1;
+        weight = static_cast<float>(c - i0);
+    }
+    return true;
+}
+
+template <typename T>
+void interpolateRow(const T *buffer, const int size[3], const vtkIdType increments[3],
+                    double point[3], const double step[3], int count, bool nearest,
+                    float outside, float *row)
+{
+    for (int x = 0; x < count; ++x)
+    {
+        int i0[3], i1[3];
+        float w[3];
+        if (!locate(point[0], size[0], i0[0], i1[0], w[0])
+                || !locate(point[1], size[1], i0[1], i1[1], w[1])
+                || !locate(point[2], size[2], i0[2], i1[2], w[2]))
+        {
+            row[x] = outside;
+        }
+        else if (nearest)
+        {
+            const vtkIdType offset = (w[0] < 0.5f ? i0[0] : i1[0]) * increments[0]
+                    + (w[1] < 0.5f ? i0[1] : i1[1]) * increments[1]
+                    + (w[2] < 0.5f ? i0[2] : i1[2]) * increments[2];
+            row[x] = static_cast<float>(buffer[offset]);
+        }
+        else
+        {
+            const T *p00 = buffer + i0[1] * increments[1] + i0[2] * increments[2];
+            const T *p10 = buffer + i1[1] * increments[1] + i0[2] * increments[2];
+            const T *p01 = buffer + i0[1] * increments[1] + i1[2] * increments[2];
+            const T *p11 = buffer + i1[1] * increments[1] + i1[2] * increments[2];
+            const vtkIdType x0 = i0[0] * increments[0];
+            const vtkIdType x1 = i1[0] * increments[0];
+
+            const float v00 = p00[x0] + w[0] * (static_cast<float>(p00[x1]) - p00[x0]);
+            const float v10 = p10[x0] + w[0] * (static_cast<float>(p10[x1]) - p10[x0]);
+            const float v01 = p01[x0] + w[0] * (static_cast<float>(p01[x1]) - p01[x0]);
+            const float v11 = p11[x0] + w[0] * (static_cast<float>(p11[x1]) - p11[x0]);
+            const float v0 = v00 + w[1] * (v10 - v00);
+            const float v1 = v01 + w[1] * (v11 - v01);
+            row[x] = v0 + w[2] * (v1 - v0);
+        }
+
+        point[0] += step[0];
+        point[1] += step[1];
+        point[2] += step[2];
+    }
+}
+
+void foldRow(float *projection, const float *values, int count, int blendMode)
+{
+    switch (blendMode)
+    {
+        case VTK_IMAGE_SLAB_MIN:
+            for (int x = 0; x < count; ++x)
+            {
+                projection[x] = values[x] < projection[x] ? values[x] : projection[x];
+            }
+            break;
+        case VTK_IMAGE_SLAB_MAX:
+            for (int x = 0; x < count; ++x)
+            {
+                projection[x] = values[x] > projection[x] ? values[x] : projection[x];
+            }
+            break;
+        default:
+            for (int x = 0; x < count; ++x)
+            {
+                projection[x] += values[x];
+            }
+            break;
+    }
+}
+
+template <typename T>
+void writeRow(const float *projection, int count, float scale, T *row)
+{
+    if (std::is_integral<T>::value)
+    {
+        const float lowest = static_cast<float>(std::numeric_limits<T>::lowest());
+        const float highest = static_cast<float>(std::numeric_limits<T>::max());
+        for (int x = 0; x < count; ++x)
+        {
+            const float value = std::floor(projection[x] * scale + 0.5f);
+            row[x] = static_cast<T>(std::min(std::max(value, lowest), highest));
+        }
+    }
+    else
+    {
+        for (int x = 0; x < count; ++x)
+        {
+            row[x] = static_cast<T>(projection[x] * scale);
+        }
+    }
+}
+
+bool sameKey(const std::vector<double> &a, const std::vector<double> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (std::fabs(a[i] - b[i]) > 1e-6 * (1.0 + std::fabs(a[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+//----------------------------------------------------------------------------
+vtkImageFastSlabReslice::vtkImageFastSlabReslice()
+{
+    this->MaximumCacheSize = 256;
+    this->CachedInput = nullptr;
+    this->CachedInputTime = 0;
+    this->UseSlabKernel = false;
+    this->SlicesComputed = false;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFastSlabReslice::~vtkImageFastSlabReslice()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFastSlabReslice::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+    os << indent << "MaximumCacheSize: " << this->MaximumCacheSize << "\n";
+    os << indent << "Cached planes: " << this->Planes.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFastSlabReslice::ReleaseCache()
+{
+    this->Planes.clear();
+    this->CacheKey.clear();
+    this->CachedInput = nullptr;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFastSlabReslice::RequestUpdateExtent(vtkInformation *request,
+                                                 vtkInformationVector **inputVector,
+                                                 vtkInformationVector *outputVector)
+{
+    int result = this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
+
+    // The samples of a thick oblique slab may reach any part of the input
+    vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFastSlabReslice::RequestData(vtkInformation *request,
+                                         vtkInformationVector **inputVector,
+                                         vtkInformationVector *outputVector)
+{
+    this->UseSlabKernel = this->PrepareSlices(vtkImageData::GetData(inputVector[0]),
+                                              outputVector->GetInformationObject(0));
+    this->SlicesComputed = false;
+
+    int result = this->Superclass::RequestData(request, inputVector, outputVector);
+
+    if (this->UseSlabKernel)
+    {
+        if (this->SlicesComputed)
+        {
+            for (auto &plane : this->Planes)
+            {
+                plane.second.Ready = true;
+            }
+        }
+        this->Slices.clear();
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageFastSlabReslice::PrepareSlices(vtkImageData *input, vtkInformation *outInfo)
+{
+    const int interpolation = this->GetInterpolationMode();
+    const int blendMode = this->GetBlendMode();
+    if (!input || !input->GetPointData()->GetScalars()
+            || input->GetNumberOfScalarComponents() != 1
+            || this->GetResliceTransform() || this->GetWrap() || this->GetMirror()
+            || this->GetGenerateStencilOutput()
+            || (interpolation != VTK_RESLICE_NEAREST && interpolation != VTK_RESLICE_LINEAR)
+            || (blendMode != VTK_IMAGE_SLAB_MIN && blendMode != VTK_IMAGE_SLAB_MAX
+                && blendMode != VTK_IMAGE_SLAB_MEAN))
+    {
+        this->ReleaseCache();
+        return false;
+    }
+
+    // Thin slabs are plain reslices
+    const double resolution = this->GetSlabResolution();
+    const double thickness = this->GetSlabThickness();
+    int extent[6];
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), extent);
+    if (!(resolution > 0) || thickness < resolution || extent[4] != extent[5])
+    {
+        this->ReleaseCache();
+        return false;
+    }
+
+    double matrix[4][4];
+    vtkMatrix4x4 *axes = this->GetResliceAxes();
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            matrix[i][j] = axes ? axes->GetElement(i, j) : (i == j);
+        }
+    }
+    if (matrix[3][0] != 0 || matrix[3][1] != 0 || matrix[3][2] != 0 || matrix[3][3] != 1)
+    {
+        this->ReleaseCache();
+        return false;
+    }
+
+    // The samples stay on planes along the normal only if the output rows
+    // and columns are orthogonal to it
+    double columns[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            columns[j][i] = matrix[i][j];
+        }
+    }
+    double normal[3] = {columns[2][0], columns[2][1], columns[2][2]};
+    if (vtkMath::Normalize(normal) == 0
+            || std::fabs(vtkMath::Dot(columns[0], normal)) > 1e-6 * vtkMath::Norm(columns[0])
+            || std::fabs(vtkMath::Dot(columns[1], normal)) > 1e-6 * vtkMath::Norm(columns[1]))
+    {
+        this->ReleaseCache();
+        return false;
+    }
+
+    double origin[3], spacing[3];
+    outInfo->Get(vtkDataObject::ORIGIN(), origin);
+    outInfo->Get(vtkDataObject::SPACING(), spacing);
+
+    // Position of the output voxel (0, 0) on the center plane of the slab,
+    // and of its projection on the plane of index 0 along the normal
+    const double outputPoint[3] = {origin[0], origin[1], origin[2] + extent[4] * spacing[2]};
+    double center[3], base[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        center[i] = matrix[i][3] + vtkMath::Dot(matrix[i], outputPoint);
+    }
+    const double position = vtkMath::Dot(center, normal);
+    for (int i = 0; i < 3; ++i)
+    {
+        base[i] = center[i] - position * normal[i];
+    }
+
+    const int first = static_cast<int>(std::ceil((position - 0.5 * thickness) / resolution - 1e-6));
+    const int last = static_cast<int>(std::floor((position + 0.5 * thickness) / resolution + 1e-6));
+    if (last < first)
+    {
+        this->ReleaseCache();
+        return false;
+    }
+
+    int inputExtent[6];
+    double inputOrigin[3], inputSpacing[3];
+    input->GetExtent(inputExtent);
+    input->GetOrigin(inputOrigin);
+    input->GetSpacing(inputSpacing);
+    for (int i = 0; i < 3; ++i)
+    {
+        this->Base[i] = (base[i] - inputOrigin[i]) / inputSpacing[i] - inputExtent[2 * i];
+        this->Steps[0][i] = columns[0][i] * spacing[0] / inputSpacing[i];
+        this->Steps[1][i] = columns[1][i] * spacing[1] / inputSpacing[i];
+        this->Steps[2][i] = normal[i] * resolution / inputSpacing[i];
+    }
+    std::copy(extent, extent + 4, this->PlaneExtent);
+
+    // The planes only depend on the geometry of the samples and on the input
+    std::vector<double> key(this->Base, this->Base + 3);
+    key.insert(key.end(), &this->Steps[0][0], &this->Steps[0][0] + 9);
+    key.insert(key.end(), extent, extent + 4);
+    key.insert(key.end(), inputExtent, inputExtent + 6);
+    key.push_back(interpolation);
+    key.push_back(this->GetBackgroundLevel());
+    if (input != this->CachedInput || input->GetMTime() != this->CachedInputTime
+            || !sameKey(key, this->CacheKey))
+    {
+        this->Planes.clear();
+        this->CacheKey = key;
+        this->CachedInput = input;
+        this->CachedInputTime = input->GetMTime();
+    }
+
+    for (auto it = this->Planes.begin(); it != this->Planes.end(); )
+    {
+        if (it->first < first || it->first > last)
+        {
+            it = this->Planes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    const size_t planeSize = static_cast<size_t>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1);
+    const double slabSize = static_cast<double>(planeSize) * (last - first + 1) * sizeof(float);
+    const bool cached = slabSize <= this->MaximumCacheSize * 1024.0 * 1024.0;
+    if (!cached)
+    {
+        this->Planes.clear();
+    }
+
+    this->Slices.clear();
+    for (int k = first; k <= last; ++k)
+    {
+        Slice slice;
+        slice.Index = k;
+        slice.Values = nullptr;
+        slice.Ready = false;
+        if (cached)
+        {
+            Plane &plane = this->Planes[k];
+            if (plane.Values.size() != planeSize)
+            {
+                plane.Values.resize(planeSize);
+                plane.Ready = false;
+            }
+            slice.Values = plane.Values.data();
+            slice.Ready = plane.Ready;
+        }
+        this->Slices.push_back(slice);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFastSlabReslice::ThreadedRequestData(vtkInformation *request,
+                                                  vtkInformationVector **inputVector,
+                                                  vtkInformationVector *outputVector,
+                                                  vtkImageData ***inData,
+                                                  vtkImageData **outData,
+                                                  int outExt[6], int threadId)
+{
+    if (!this->UseSlabKernel)
+    {
+        this->Superclass::ThreadedRequestData(request, inputVector, outputVector,
+                                              inData, outData, outExt, threadId);
+        return;
+    }
+
+    vtkImageData *input = inData[0][0];
+    vtkImageData *output = outData[0];
+
+    int inputExtent[6], inputSize[3];
+    vtkIdType inputIncrements[3];
+    input->GetExtent(inputExtent);
+    for (int i = 0; i < 3; ++i)
+    {
+        inputSize[i] = inputExtent[2 * i + 1] - inputExtent[2 * i] + 1;
+        inputIncrements[i] = i ? inputIncrements[i - 1] * inputSize[i - 1] : 1;
+    }
+    void *inputBuffer = input->GetScalarPointer();
+
+    const bool nearest = this->GetInterpolationMode() == VTK_RESLICE_NEAREST;
+    const int blendMode = this->GetBlendMode();
+    const float outside = static_cast<float>(this->GetBackgroundLevel());
+    const float scale = blendMode == VTK_IMAGE_SLAB_MEAN ? 1.0f / this->Slices.size() : 1.0f;
+
+    const int count = outExt[1] - outExt[0] + 1;
+    const vtkIdType planeRow = this->PlaneExtent[1] - this->PlaneExtent[0] + 1;
+    std::vector<float> projection(count), scratch(count);
+
+    for (int y = outExt[2]; y <= outExt[3]; ++y)
+    {
+        const vtkIdType offset = (y - this->PlaneExtent[2]) * planeRow + (outExt[0] - this->PlaneExtent[0]);
+
+        for (size_t k = 0; k < this->Slices.size(); ++k)
+        {
+            const Slice &slice = this->Slices[k];
+            float *values = slice.Values ? slice.Values + offset : scratch.data();
+
+            if (!slice.Ready)
+            {
+                double point[3];
+                for (int i = 0; i < 3; ++i)
+                {
+                    point[i] = this->Base[i] + outExt[0] * this->Steps[0][i]
+                            + y * this->Steps[1][i] + slice.Index * this->Steps[2][i];
+                }
+                switch (input->GetScalarType())
+                {
+                    vtkTemplateMacro(interpolateRow(static_cast<const VTK_TT *>(inputBuffer),
+                                                    inputSize, inputIncrements, point, this->Steps[0],
+                                                    count, nearest, outside, values));
+                }
+            }
+
+            if (k == 0)
+            {
+                std::copy(values, values + count, projection.begin());
+            }
+            else
+            {
+                foldRow(projection.data(), values, count, blendMode);
+            }
+        }
+
+        void *row = output->GetScalarPointer(outExt[0], y, outExt[4]);
+        switch (output->GetScalarType())
+        {
+            vtkTemplateMacro(writeRow(projection.data(), count, scale, static_cast<VTK_TT *>(row)));
+        }
+    }
+
+    this->SlicesComputed = true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medVtkInriaExport.h>
+
+#include <vtkImageSlabReslice.h>
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+/**
+   Thick slab reslice computing the maximum, minimum and mean intensity
+   projections with its own kernel.
+
+   The samples of a slab lie on planes at multiples of the slab resolution
+   along the slab normal, whatever the position of the slab. Each plane is
+   interpolated once in a float buffer kept between updates: when the slab
+   only moves along its normal, as when scrolling, the planes still inside
+   the slab are not interpolated again, only folded in the projection.
+   Changing the blend mode reuses all of them.
+
+   Planes and projection are computed by output rows, which are shared
+   between the threads of the filter, and folded with contiguous loops the
+   compiler vectorizes.
+
+   Single component inputs resliced with nearest or linear interpolation by
+   an affine reslice axes use this kernel, the other cases are left to
+   vtkImageSlabReslice.
+ */
+class MEDVTKINRIA_EXPORT vtkImageFastSlabReslice : public vtkImageSlabReslice
+{
+public:
+    static vtkImageFastSlabReslice *New();
+    vtkTypeMacro(vtkImageFastSlabReslice, vtkImageSlabReslice)
+    void PrintSelf(ostream& os, vtkIndent indent) override;
+
+    // Description:
+    // Memory in MB the planes of a slab may use to be kept between updates.
+    // Larger slabs are projected without keeping their planes.
+    vtkSetMacro(MaximumCacheSize, int)
+    vtkGetMacro(MaximumCacheSize, int)
+
+    // Description:
+    // Release the planes kept from the last update.
+    void ReleaseCache();
+
+protected:
+    vtkImageFastSlabReslice();
+    ~vtkImageFastSlabReslice();
+
+    int RequestUpdateExtent(vtkInformation *request, vtkInformationVector **inputVector,
+                            vtkInformationVector *outputVector) override;
+    int RequestData(vtkInformation *request, vtkInformationVector **inputVector,
+                    vtkInformationVector *outputVector) override;
+    void ThreadedRequestData(vtkInformation *request, vtkInformationVector **inputVector,
+                             vtkInformationVector *outputVector, vtkImageData ***inData,
+                             vtkImageData **outData, int outExt[6], int threadId) override;
+
+    bool PrepareSlices(vtkImageData *input, vtkInformation *outInfo);
+
+private:
+    vtkImageFastSlabReslice(const vtkImageFastSlabReslice&);  // Not implemented.
+    void operator=(const vtkImageFastSlabReslice&);  // Not implemented.
+
+    struct Plane
+    {
+        Plane() : Ready(false) {}
+        std::vector<float> Values;
+        bool Ready;
+    };
+
+    struct Slice
+    {
+        // position along the normal, in slab resolution units
+        int Index;
+        // row values of the cached plane, null when the slab is not cached
+        float *Values;
+        bool Ready;
+    };
+
+    int MaximumCacheSize;
+
+    // planes by index along the normal, for the geometry of CacheKey
+    std::map<int, Plane> Planes;
+    std::vector<double> CacheKey;
+    vtkImageData *CachedInput;
+    vtkMTimeType CachedInputTime;
+
+    // state of the current update, read by the threads
+    bool UseSlabKernel;
+    std::atomic<bool> SlicesComputed;
+    std::vector<Slice> Slices;
+    int PlaneExtent[4];
+    // continuous input index of the sample of output voxel (x, y) on
+    // slice k: Base + x * Steps[0] + y * Steps[1] + k * Steps[2]
+    double Base[3];
+    double Steps[3][3];
+};
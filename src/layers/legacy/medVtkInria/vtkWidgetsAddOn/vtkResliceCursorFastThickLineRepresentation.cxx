@@ -0,0 +1,49 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include "vtkResliceCursorFastThickLineRepresentation.h"
+
+#include "vtkImageFastSlabReslice.h"
+#include "vtkImageMapToColors.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkResliceCursorFastThickLineRepresentation);
+
+//----------------------------------------------------------------------------
+vtkResliceCursorFastThickLineRepresentation::vtkResliceCursorFastThickLineRepresentation()
+{
+    // The superclass constructors only call their own reslice factories
+    this->CreateDefaultResliceAlgorithm();
+    this->GetColorMap()->SetInputConnection(this->Reslice->GetOutputPort());
+}
+
+//----------------------------------------------------------------------------
+vtkResliceCursorFastThickLineRepresentation::~vtkResliceCursorFastThickLineRepresentation()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkResliceCursorFastThickLineRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+    this->Superclass::PrintSelf(os, indent);
+}
+
+//----------------------------------------------------------------------------
+void vtkResliceCursorFastThickLineRepresentation::CreateDefaultResliceAlgorithm()
+{
+    if (this->Reslice)
+    {
+        this->Reslice->Delete();
+    }
+    this->Reslice = vtkImageFastSlabReslice::New();
+}
@@ -0,0 +1,39 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medVtkInriaExport.h>
+
+#include <vtkResliceCursorThickLineRepresentation.h>
+
+/**
+   Thick line representation of a reslice cursor whose slabs are projected
+   by a vtkImageFastSlabReslice.
+ */
+class MEDVTKINRIA_EXPORT vtkResliceCursorFastThickLineRepresentation : public vtkResliceCursorThickLineRepresentation
+{
+public:
+    static vtkResliceCursorFastThickLineRepresentation *New();
+    vtkTypeMacro(vtkResliceCursorFastThickLineRepresentation, vtkResliceCursorThickLineRepresentation)
+    void PrintSelf(ostream& os, vtkIndent indent) override;
+
+    void CreateDefaultResliceAlgorithm() override;
+
+protected:
+    vtkResliceCursorFastThickLineRepresentation();
+    ~vtkResliceCursorFastThickLineRepresentation();
+
+private:
+    vtkResliceCursorFastThickLineRepresentation(const vtkResliceCursorFastThickLineRepresentation&);  // Not implemented.
+    void operator=(const vtkResliceCursorFastThickLineRepresentation&);  // Not implemented.
+};
@@ -0,0 +1,529 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medComposerBatchRunner.h>
+#include <medComposerExtension.h>
+#include <medComposerNodeCache.h>
+
+#include <dtkComposer/dtkComposerEvaluator.h>
+#include <dtkComposer/dtkComposerGraph.h>
+#include <dtkComposer/dtkComposerNodeFactory.h>
+#include <dtkComposer/dtkComposerReader.h>
+#include <dtkComposer/dtkComposerScene.h>
+#include <dtkComposer/dtkComposerStack.h>
+
+#include <QtCore>
+
+#include <algorithm>
+#include <exception>
+
+// /////////////////////////////////////////////////////////////////
+// medComposerBatchRunnerPrivate
+// /////////////////////////////////////////////////////////////////
+
+class medComposerBatchRunnerPrivate
+{
+public:
+    static QList<QStringList> parseCsv(const QString &text);
+    QString subjectComposition(int index) const;
+
+public:
+    QString composition;
+    QStringList columns;
+    QList<QStringList> values;   // one row per subject, the subject name first
+    QDir workingDirectory;
+
+    int maximumJobs;
+    qint64 memoryBudget;
+    qint64 subjectMemory;
+    bool resume;
+
+    int jobs;
+    int next;
+    int finished;
+    int failures;
+    bool cancelled;
+    QVector<medComposerBatchRunner::SubjectStatus> status;
+    QHash<QProcess *, int> running;
+    QHash<int, QByteArray> hashes;
+    QHash<int, QElapsedTimer> timers;
+};
+
+/**
+ * Splits CSV text in rows of fields. Quoted fields may hold commas, line
+ * breaks and doubled quotes; the other fields are trimmed. Empty lines and
+ * lines starting with '#' are skipped.
+ */
+QList<QStringList> medComposerBatchRunnerPrivate::parseCsv(const QString &text)
+{
+    QList<QStringList> rows;
+    QStringList row;
+    QString field;
+    bool quoted = false;      // inside a quoted field
+    bool wasQuoted = false;   // the current field was quoted, it is kept as is
+    bool comment = false;
+
+    auto endField = [&]()
+    {
+        row << (wasQuoted ? field : field.trimmed());
+        field.clear();
+        wasQuoted = false;
+    };
+    auto endRow = [&]()
+    {
+        endField();
+        if (!comment && !(row.size() == 1 && row[0].isEmpty()))
+        {
+            rows << row;
+        }
+        row.clear();
+        comment = false;
+    };
+
+    for (int i = 0; i < text.size(); ++i)
+    {
+        const QChar c = text[i];
+        if (quoted)
+        {
+            if (c != '"')
+            {
+                field += c;
+            }
+            else if (i + 1 < text.size() && text[i + 1] == '"')
+            {
+                field += c;
+                ++i;
+            }
+            else
+            {
+                quoted = false;
+            }
+        }
+        else if (comment && c != '\n')
+        {
+            continue;
+        }
+        else if (wasQuoted && c != ',' && c != '\n')
+        {
+            // characters after the closing quote are dropped
+            continue;
+        }
+        else if (c == '"' && field.trimmed().isEmpty())
+        {
+            field.clear();
+            quoted = wasQuoted = true;
+        }
+        else if (c == '#' && row.isEmpty() && field.trimmed().isEmpty())
+        {
+            comment = true;
+        }
+        else if (c == ',')
+        {
+            endField();
+        }
+        else if (c == '\n')
+        {
+            endRow();
+        }
+        else if (c != '\r')
+        {
+            field += c;
+        }
+    }
+    if (!field.isEmpty() || !row.isEmpty() || wasQuoted)
+    {
+        endRow();
+    }
+
+    return rows;
+}
+
+QString medComposerBatchRunnerPrivate::subjectComposition(int index) const
+{
+    const QStringList &row = values[index];
+
+    // the composition is XML, the values are escaped
+    QString result = composition;
+    result.replace("${subject}", row[0].toHtmlEscaped());
+    result.replace("${workdir}", QDir(workingDirectory.filePath(row[0])).absolutePath().toHtmlEscaped());
+    for (int column = 0; column < columns.size(); ++column)
+    {
+        result.replace("${" + columns[column] + "}", row.value(column).toHtmlEscaped());
+    }
+    return result;
+}
+
+// /////////////////////////////////////////////////////////////////
+// medComposerBatchRunner
+// /////////////////////////////////////////////////////////////////
+
+medComposerBatchRunner::medComposerBatchRunner(QObject *parent) : QObject(parent), d(new medComposerBatchRunnerPrivate)
+{
+    d->workingDirectory = QDir::current();
+    // the ITK filters of each evaluation already use several threads
+    d->maximumJobs = std::max(1, QThread::idealThreadCount() / 4);
+    d->memoryBudget = 0;
+    d->subjectMemory = 0;
+    d->resume = false;
+
+    d->jobs = 0;
+    d->next = 0;
+    d->finished = 0;
+    d->failures = 0;
+    d->cancelled = false;
+}
+
+medComposerBatchRunner::~medComposerBatchRunner(void)
+{
+    for (QProcess *process : d->running.keys())
+    {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+    }
+    delete d;
+}
+
+/**
+ * Reads the composition, compressed or not.
+ */
+bool medComposerBatchRunner::setComposition(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << Q_FUNC_INFO << "cannot read" << fileName;
+        return false;
+    }
+
+    QByteArray content = file.readAll();
+    if (!content.trimmed().startsWith('<'))
+    {
+        content = qUncompress(content);
+    }
+    if (content.isEmpty())
+    {
+        qWarning() << Q_FUNC_INFO << fileName << "is not a composition";
+        return false;
+    }
+
+    d->composition = QString::fromUtf8(content);
+    return true;
+}
+
+bool medComposerBatchRunner::setManifest(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qWarning() << Q_FUNC_INFO << "cannot read" << fileName;
+        return false;
+    }
+
+    d->columns.clear();
+    d->values.clear();
+
+    QSet<QString> names;
+    QTextStream stream(&file);
+    for (const QStringList &row : medComposerBatchRunnerPrivate::parseCsv(stream.readAll()))
+    {
+        if (d->columns.isEmpty())
+        {
+            d->columns = row;
+            continue;
+        }
+
+        const QString &subject = row[0];
+        if (subject.isEmpty() || subject.contains('/') || subject.contains('\\') || subject == "." || subject == "..")
+        {
+            qWarning() << Q_FUNC_INFO << "invalid subject name" << subject;
+            return false;
+        }
+        if (names.contains(subject))
+        {
+            qWarning() << Q_FUNC_INFO << "subject" << subject << "is listed twice";
+            return false;
+        }
+        names.insert(subject);
+        d->values.append(row);
+    }
+
+    return !d->values.isEmpty();
+}
+
+void medComposerBatchRunner::setWorkingDirectory(const QString &path)
+{
+    d->workingDirectory = QDir(path);
+}
+
+void medComposerBatchRunner::setMaximumJobs(int jobs)
+{
+    d->maximumJobs = std::max(1, jobs);
+}
+
+void medComposerBatchRunner::setMemoryBudget(qint64 totalBytes, qint64 subjectBytes)
+{
+    d->memoryBudget = totalBytes;
+    d->subjectMemory = subjectBytes;
+}
+
+void medComposerBatchRunner::setResume(bool resume)
+{
+    d->resume = resume;
+}
+
+QStringList medComposerBatchRunner::subjects(void) const
+{
+    QStringList result;
+    for (const QStringList &row : d->values)
+    {
+        result << row[0];
+    }
+    return result;
+}
+
+medComposerBatchRunner::SubjectStatus medComposerBatchRunner::status(const QString &subject) const
+{
+    int index = this->subjects().indexOf(subject);
+    return (index >= 0 && index < d->status.size()) ? d->status[index] : Pending;
+}
+
+QString medComposerBatchRunner::subjectDirectory(const QString &subject) const
+{
+    return QDir(d->workingDirectory.filePath(subject)).absolutePath();
+}
+
+bool medComposerBatchRunner::start(void)
+{
+    if (d->composition.isEmpty() || d->values.isEmpty() || !d->running.isEmpty())
+    {
+        return false;
+    }
+    if (!d->workingDirectory.mkpath("."))
+    {
+        qWarning() << Q_FUNC_INFO << "cannot create" << d->workingDirectory.absolutePath();
+        return false;
+    }
+
+    d->jobs = d->maximumJobs;
+    if (d->memoryBudget > 0 && d->subjectMemory > 0)
+    {
+        d->jobs = static_cast<int>(qBound<qint64>(1, d->memoryBudget / d->subjectMemory, d->jobs));
+    }
+
+    d->next = 0;
+    d->finished = 0;
+    d->failures = 0;
+    d->cancelled = false;
+    d->status.fill(Pending, d->values.size());
+    d->hashes.clear();
+    d->timers.clear();
+
+    QMetaObject::invokeMethod(this, "startPending", Qt::QueuedConnection);
+    return true;
+}
+
+void medComposerBatchRunner::cancel(void)
+{
+    d->cancelled = true;
+    for (QProcess *process : d->running.keys())
+    {
+        process->kill();
+    }
+}
+
+void medComposerBatchRunner::startPending(void)
+{
+    while (!d->cancelled && d->running.size() < d->jobs && d->next < d->values.size())
+    {
+        const int index = d->next++;
+        const QString subject = d->values[index][0];
+
+        QDir directory(this->subjectDirectory(subject));
+        if (!directory.mkpath("."))
+        {
+            this->finishSubject(index, Failed, tr("cannot create %1").arg(directory.absolutePath()));
+            continue;
+        }
+
+        const QString composition = d->subjectComposition(index);
+        const QByteArray hash = QCryptographicHash::hash(composition.toUtf8(), QCryptographicHash::Sha1).toHex();
+
+        QFile marker(directory.filePath("succeeded"));
+        if (d->resume && marker.open(QIODevice::ReadOnly) && marker.readAll() == hash)
+        {
+            this->finishSubject(index, Skipped, tr("already done"));
+            continue;
+        }
+        marker.close();
+        marker.remove();
+
+        QFile compositionFile(directory.filePath("composition.dtk"));
+        if (!compositionFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || compositionFile.write(composition.toUtf8()) < 0)
+        {
+            this->finishSubject(index, Failed, tr("cannot write %1").arg(compositionFile.fileName()));
+            continue;
+        }
+        compositionFile.close();
+
+        // the jobs share the cores
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS",
+                           QString::number(std::max(1, QThread::idealThreadCount() / d->jobs)));
+        // a failed subject restarts from the results of its completed nodes
+        environment.insert("MEDINRIA_COMPOSER_CACHE_DIR", directory.filePath("cache"));
+
+        QProcess *process = new QProcess(this);
+        process->setProcessEnvironment(environment);
+        process->setWorkingDirectory(directory.absolutePath());
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        process->setStandardOutputFile(directory.filePath("evaluation.log"));
+        connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onProcessFinished(int, QProcess::ExitStatus)));
+        connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(onProcessError(QProcess::ProcessError)));
+
+        d->running.insert(process, index);
+        d->hashes.insert(index, hash);
+        d->timers[index].start();
+        d->status[index] = Running;
+        emit subjectStarted(subject);
+
+        process->start(QCoreApplication::applicationFilePath(),
+                       QStringList() << "--composer-evaluate=" + compositionFile.fileName());
+    }
+
+    if (d->running.isEmpty() && (d->cancelled || d->next >= d->values.size()))
+    {
+        emit finished(d->failures);
+    }
+}
+
+void medComposerBatchRunner::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *process = qobject_cast<QProcess *>(this->sender());
+    if (!process || !d->running.contains(process))
+    {
+        return;
+    }
+
+    const int index = d->running.take(process);
+    process->deleteLater();
+
+    if (exitStatus == QProcess::NormalExit && exitCode == 0)
+    {
+        QFile marker(QDir(this->subjectDirectory(d->values[index][0])).filePath("succeeded"));
+        if (marker.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            marker.write(d->hashes.value(index));
+        }
+        this->finishSubject(index, Succeeded, tr("done in %1 s").arg(d->timers[index].elapsed() / 1000));
+    }
+    else if (exitStatus == QProcess::CrashExit)
+    {
+        this->finishSubject(index, Failed, d->cancelled ? tr("cancelled") : tr("crashed"));
+    }
+    else
+    {
+        this->finishSubject(index, Failed, tr("exited with code %1").arg(exitCode));
+    }
+
+    this->startPending();
+}
+
+void medComposerBatchRunner::onProcessError(QProcess::ProcessError error)
+{
+    // the other errors are followed by finished()
+    if (error != QProcess::FailedToStart)
+    {
+        return;
+    }
+
+    QProcess *process = qobject_cast<QProcess *>(this->sender());
+    if (!process || !d->running.contains(process))
+    {
+        return;
+    }
+
+    const int index = d->running.take(process);
+    process->deleteLater();
+    this->finishSubject(index, Failed, process->errorString());
+
+    this->startPending();
+}
+
+void medComposerBatchRunner::finishSubject(int index, SubjectStatus status, const QString &message)
+{
+    d->status[index] = status;
+    d->finished++;
+    if (status == Failed)
+    {
+        d->failures++;
+    }
+
+    emit subjectFinished(d->values[index][0], status != Failed, message);
+    emit progress(d->finished, d->values.size());
+}
+
+int medComposerBatchRunner::evaluate(const QString &fileName)
+{
+    dtkComposerNodeFactory factory;
+    medComposerExtension::initializeFactory(&factory);
+
+    dtkComposerGraph graph;
+    dtkComposerStack stack;
+    dtkComposerScene scene;
+    scene.setFactory(&factory);
+    scene.setStack(&stack);
+    scene.setGraph(&graph);
+
+    dtkComposerReader reader;
+    reader.setFactory(&factory);
+    reader.setScene(&scene);
+    reader.setGraph(&graph);
+    if (!reader.read(fileName))
+    {
+        qCritical() << Q_FUNC_INFO << "cannot read the composition" << fileName;
+        return 2;
+    }
+
+    // the nodes report their errors without stopping the evaluation
+    QStringList failedNodes;
+    medComposerNodeCache *cache = medComposerNodeCache::instance();
+    QObject::connect(cache, &medComposerNodeCache::failed, [&failedNodes](const QString &node)
+    {
+        failedNodes << node;
+    });
+    cache->startEvaluation();
+
+    dtkComposerEvaluator evaluator;
+    evaluator.setGraph(&graph);
+    try
+    {
+        evaluator.run_static();
+    }
+    catch (const std::exception &e)
+    {
+        qCritical() << Q_FUNC_INFO << "evaluation failed:" << e.what();
+        return 1;
+    }
+
+    if (!failedNodes.isEmpty())
+    {
+        qCritical() << Q_FUNC_INFO << "evaluation failed in" << failedNodes.join(", ");
+        return 1;
+    }
+
+    return 0;
+}
+
+//
+// medComposerBatchRunner.cpp ends here
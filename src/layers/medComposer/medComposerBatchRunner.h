@@ -0,0 +1,100 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <medComposerExport.h>
+
+class medComposerBatchRunnerPrivate;
+
+/**
+ * @class medComposerBatchRunner
+ * @brief Runs a composition once per subject of a manifest, without GUI.
+ *
+ * The manifest is a CSV file, whose values may be quoted to hold commas or
+ * line breaks. Its first line names the columns, the first column holds the
+ * subject names. In the composition, ${column} is replaced
+ * by the value of the column for the subject, ${subject} by the subject name
+ * and ${workdir} by the directory of the subject in the working directory.
+ *
+ * Each subject is evaluated by its own medInria process, so that a crash
+ * only fails its subject. The output of the process is kept in the
+ * evaluation.log file of the subject directory, the results of its nodes in
+ * the cache directory, where a new evaluation of the subject finds them.
+ */
+class MEDCOMPOSER_EXPORT medComposerBatchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SubjectStatus
+    {
+        Pending,
+        Running,
+        Succeeded,
+        Failed,
+        Skipped    //! already succeeded in a previous run
+    };
+
+     medComposerBatchRunner(QObject *parent = nullptr);
+    ~medComposerBatchRunner(void);
+
+public:
+    bool setComposition(const QString &fileName);
+    bool setManifest(const QString &fileName);
+    void setWorkingDirectory(const QString &path);
+
+    //! Upper bound of the subjects evaluated at the same time
+    void setMaximumJobs(int jobs);
+
+    //! Lowers the number of jobs to fit the expected memory use of a subject in the budget
+    void setMemoryBudget(qint64 totalBytes, qint64 subjectBytes);
+
+    //! Skips the subjects which succeeded with the same composition and values
+    void setResume(bool resume);
+
+    QStringList subjects(void) const;
+    SubjectStatus status(const QString &subject) const;
+    QString subjectDirectory(const QString &subject) const;
+
+public:
+    //! Runs a composition in the current process, returns the exit code for the batch, not 0 when a node failed
+    static int evaluate(const QString &fileName);
+
+public slots:
+    bool start(void);
+    void cancel(void);
+
+signals:
+    void subjectStarted(const QString &subject);
+    void subjectFinished(const QString &subject, bool success, const QString &message);
+    void progress(int finished, int total);
+    void finished(int failures);
+
+private slots:
+    void startPending(void);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessError(QProcess::ProcessError error);
+
+private:
+    void finishSubject(int index, SubjectStatus status, const QString &message);
+
+private:
+    medComposerBatchRunnerPrivate *d;
+};
+
+//
+// medComposerBatchRunner.h ends here
@@ -45,6 +45,10 @@
 #include <medReaderNodeBase.h>
 #include <medWriterNodeBase.h>
 
+#include <dtkComposer/dtkComposer.h>
+
+#include <QtCore>
+
 medComposerExtension::medComposerExtension(void) : dtkComposerExtension()
 {
 
@@ -115,3 +119,33 @@ void medComposerExtension::extend(dtkComposerNodeFactory *factory)
     factory->record(":/process/medMeshReaderNode.json", dtkComposerNodeCreator<medMeshReaderNode>);
     factory->record(":/process/medGenericWriterNode.json", dtkComposerNodeCreator<medWriterNodeBase>);
 }
+
+void medComposerExtension::initializeFactory(dtkComposerNodeFactory *factory)
+{
+    dtkComposer::node::initialize();
+
+    medComposerExtension extension;
+    factory->extend(&extension);
+
+    QString pluginsPath = getenv("MEDINRIA_PLUGINS_DIR");
+    QString defaultPath;
+    QDir plugins_dir;
+#ifdef Q_OS_MAC
+    plugins_dir = qApp->applicationDirPath() + "/../PlugIns";
+#else
+    plugins_dir = qApp->applicationDirPath() + "/../plugins";
+#endif
+    defaultPath = plugins_dir.absolutePath();
+
+    if ( !pluginsPath.isEmpty() )
+        dtkComposer::extension::initialize(pluginsPath);
+    else
+        dtkComposer::extension::initialize(defaultPath);
+
+    QStringList exts = dtkComposer::extension::pluginFactory().keys();
+    for(QString extKey : exts)
+    {
+        dtkComposerExtension* ext=dtkComposer::extension::pluginFactory().create(extKey);
+        factory->extend(ext);
+    }
+}
@@ -25,6 +25,10 @@ public:
 
 public:
     void extend(dtkComposerNodeFactory *factory);
+
+public:
+    //! Records the medInria nodes and the nodes of the composer extension plugins
+    static void initializeFactory(dtkComposerNodeFactory *factory);
 };
 
 //
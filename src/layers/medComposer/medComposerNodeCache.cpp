@@ -0,0 +1,364 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medComposerNodeCache.h>
+
+#include <dtkCoreSupport/dtkSmartPointer.h>
+#include <dtkLog>
+
+#include <medAbstractData.h>
+#include <medAbstractImageData.h>
+#include <medAbstractProcess.h>
+#include <medBoolParameter.h>
+#include <medDataReaderWriter.h>
+#include <medDoubleParameter.h>
+#include <medIntParameter.h>
+#include <medStringParameter.h>
+
+#include <QtCore>
+
+// /////////////////////////////////////////////////////////////////
+// medComposerNodeCachePrivate
+// /////////////////////////////////////////////////////////////////
+
+class medComposerNodeCachePrivate
+{
+public:
+    // the results deleted on eviction are forgotten under the lock
+    medComposerNodeCachePrivate(void) : mutex(QMutex::Recursive) {}
+
+public:
+    medAbstractData *load(const QByteArray &key);
+    void store(const QByteArray &key, medAbstractData *data);
+    void setDataKey(medAbstractData *data, const QByteArray &key);
+    void use(const QByteArray &key);
+    void evict(void);
+
+public:
+    QMutex mutex;
+
+    // least recently used first
+    QList<QByteArray> order;
+    QHash<QByteArray, dtkSmartPointer<medAbstractData> > results;
+    QHash<QByteArray, int> evaluations;
+    int maximumEntries;
+    int evaluation;
+
+    QHash<const QObject *, QByteArray> dataKeys;
+    QDir directory;
+    bool useDirectory;
+
+    medComposerNodeCache *q;
+};
+
+/**
+ * Reads a result from the directory, the file of the data is next to a file
+ * holding its identifier.
+ */
+medAbstractData *medComposerNodeCachePrivate::load(const QByteArray &key)
+{
+    QFile identifierFile(directory.filePath(key + ".id"));
+    if (!identifierFile.open(QIODevice::ReadOnly))
+    {
+        return nullptr;
+    }
+    const QString identifier = QString::fromUtf8(identifierFile.readAll());
+
+    const QStringList files = directory.entryList(QStringList() << key + ".data.*", QDir::Files);
+    if (files.isEmpty())
+    {
+        return nullptr;
+    }
+
+    medAbstractData *data = medDataReaderWriter::read(directory.filePath(files.first()));
+    if (!data || data->identifier() != identifier)
+    {
+        dtkDebug() << Q_FUNC_INFO << "cached" << files.first() << "is not a" << identifier;
+        return nullptr;
+    }
+    return data;
+}
+
+void medComposerNodeCachePrivate::store(const QByteArray &key, medAbstractData *data)
+{
+    const QString extension = dynamic_cast<medAbstractImageData *>(data) ? "mha" : "vtk";
+    if (!directory.mkpath(".")
+        || !medDataReaderWriter::write(directory.filePath(key + ".data." + extension), data))
+    {
+        dtkDebug() << Q_FUNC_INFO << "cannot write" << data->identifier() << "in" << directory.absolutePath();
+        return;
+    }
+
+    // written last, the result is only found once complete
+    QFile identifierFile(directory.filePath(key + ".id"));
+    if (identifierFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        identifierFile.write(data->identifier().toUtf8());
+    }
+}
+
+void medComposerNodeCachePrivate::setDataKey(medAbstractData *data, const QByteArray &key)
+{
+    if (!dataKeys.contains(data))
+    {
+        QObject::connect(data, SIGNAL(destroyed(QObject*)), q, SLOT(forget(QObject*)), Qt::DirectConnection);
+        QObject::connect(data, SIGNAL(dataModified(medAbstractData*)), q, SLOT(onDataModified(medAbstractData*)), Qt::DirectConnection);
+    }
+    dataKeys.insert(data, key);
+}
+
+void medComposerNodeCachePrivate::use(const QByteArray &key)
+{
+    order.removeOne(key);
+    order.append(key);
+    evaluations.insert(key, evaluation);
+}
+
+/**
+ * The results used by the current evaluation may still be read by the nodes
+ * downstream, they are kept even above the maximum.
+ */
+void medComposerNodeCachePrivate::evict(void)
+{
+    for (int i = 0; i < order.size() && order.size() > maximumEntries; )
+    {
+        if (evaluations.value(order[i]) < evaluation)
+        {
+            results.remove(order[i]);
+            evaluations.remove(order[i]);
+            order.removeAt(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+// /////////////////////////////////////////////////////////////////
+// medComposerNodeCache
+// /////////////////////////////////////////////////////////////////
+
+medComposerNodeCache *medComposerNodeCache::instance(void)
+{
+    static medComposerNodeCache *cache = new medComposerNodeCache;
+    return cache;
+}
+
+medComposerNodeCache::medComposerNodeCache(void) : QObject(), d(new medComposerNodeCachePrivate)
+{
+    d->q = this;
+    d->maximumEntries = 16;
+    d->evaluation = 0;
+    d->useDirectory = false;
+
+    // the nodes run in the thread of the evaluator
+    if (qApp)
+    {
+        this->moveToThread(qApp->thread());
+    }
+
+    const QString path = QString::fromLocal8Bit(qgetenv("MEDINRIA_COMPOSER_CACHE_DIR"));
+    if (!path.isEmpty())
+    {
+        this->setDirectory(path);
+    }
+}
+
+medComposerNodeCache::~medComposerNodeCache(void)
+{
+    delete d;
+}
+
+QByteArray medComposerNodeCache::key(medAbstractProcess *process, const QList<medAbstractData *> &inputs, const QStringList &extra)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(process->metaObject()->className());
+
+    for (medAbstractParameter *parameter : process->findChildren<medAbstractParameter *>())
+    {
+        QString value;
+        switch (parameter->type())
+        {
+            case MED_PARAMETER_INT:
+                value = QString::number(static_cast<medIntParameter *>(parameter)->value());
+                break;
+            case MED_PARAMETER_DOUBLE:
+                value = QString::number(static_cast<medDoubleParameter *>(parameter)->value(), 'g', 17);
+                break;
+            case MED_PARAMETER_BOOL:
+                value = static_cast<medBoolParameter *>(parameter)->value() ? "true" : "false";
+                break;
+            case MED_PARAMETER_STRING:
+                value = static_cast<medStringParameter *>(parameter)->value();
+                break;
+        }
+        hash.addData(QString("\n%1=%2").arg(parameter->id(), value).toUtf8());
+    }
+
+    for (medAbstractData *input : inputs)
+    {
+        hash.addData("\ninput=");
+        hash.addData(input ? this->dataKey(input) : QByteArray("none"));
+    }
+    for (const QString &value : extra)
+    {
+        hash.addData("\nextra=");
+        hash.addData(value.toUtf8());
+    }
+
+    return hash.result().toHex();
+}
+
+QByteArray medComposerNodeCache::dataKey(medAbstractData *data)
+{
+    QMutexLocker locker(&d->mutex);
+
+    QByteArray key = d->dataKeys.value(data);
+    if (key.isEmpty())
+    {
+        // only equal to itself
+        key = QUuid::createUuid().toRfc4122().toHex();
+        d->setDataKey(data, key);
+    }
+    return key;
+}
+
+QString medComposerNodeCache::fileKey(const QString &path)
+{
+    QFileInfo info(path);
+    return QString("%1:%2:%3").arg(info.absoluteFilePath())
+                              .arg(info.size())
+                              .arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+void medComposerNodeCache::setSourceFile(medAbstractData *data, const QString &path)
+{
+    QMutexLocker locker(&d->mutex);
+    d->setDataKey(data, QCryptographicHash::hash(fileKey(path).toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+medAbstractData *medComposerNodeCache::find(const QByteArray &key, const QString &node)
+{
+    QMutexLocker locker(&d->mutex);
+
+    medAbstractData *data = d->results.value(key);
+    if (!data && d->useDirectory)
+    {
+        data = d->load(key);
+        if (data)
+        {
+            d->setDataKey(data, key);
+            d->results.insert(key, data);
+        }
+    }
+    if (data)
+    {
+        d->use(key);
+        d->evict();
+    }
+    locker.unlock();
+
+    emit lookedUp(node, data != nullptr);
+    return data;
+}
+
+void medComposerNodeCache::insert(const QByteArray &key, medAbstractData *output)
+{
+    if (!output)
+    {
+        return;
+    }
+
+    QMutexLocker locker(&d->mutex);
+
+    d->setDataKey(output, key);
+    d->results.insert(key, output);
+    d->use(key);
+    d->evict();
+
+    if (d->useDirectory)
+    {
+        d->store(key, output);
+    }
+}
+
+void medComposerNodeCache::reportFailure(const QString &node)
+{
+    dtkWarn() << node << ": failed";
+    emit failed(node);
+}
+
+void medComposerNodeCache::setMaximumEntries(int entries)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maximumEntries = std::max(0, entries);
+    d->evict();
+}
+
+void medComposerNodeCache::setDirectory(const QString &path)
+{
+    QMutexLocker locker(&d->mutex);
+    d->useDirectory = !path.isEmpty();
+    d->directory = QDir(path);
+}
+
+QString medComposerNodeCache::directory(void) const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->useDirectory ? d->directory.absolutePath() : QString();
+}
+
+void medComposerNodeCache::startEvaluation(void)
+{
+    QMutexLocker locker(&d->mutex);
+    d->evaluation++;
+    d->evict();
+}
+
+/**
+ * Forgets the results kept in memory, those in the directory stay.
+ */
+void medComposerNodeCache::clear(void)
+{
+    QMutexLocker locker(&d->mutex);
+    d->results.clear();
+    d->evaluations.clear();
+    d->order.clear();
+}
+
+void medComposerNodeCache::forget(QObject *data)
+{
+    QMutexLocker locker(&d->mutex);
+    d->dataKeys.remove(data);
+}
+
+/**
+ * A modified data is no longer what its key describes.
+ */
+void medComposerNodeCache::onDataModified(medAbstractData *data)
+{
+    QMutexLocker locker(&d->mutex);
+
+    const QByteArray key = d->dataKeys.value(data);
+    if (d->results.value(key) == data)
+    {
+        d->results.remove(key);
+        d->evaluations.remove(key);
+        d->order.removeOne(key);
+    }
+    d->dataKeys.insert(data, QUuid::createUuid().toRfc4122().toHex());
+}
+
+//
+// medComposerNodeCache.cpp ends here
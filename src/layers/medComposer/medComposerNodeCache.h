@@ -0,0 +1,134 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QObject>
+#include <QStringList>
+
+#include <medAbstractJob.h>
+#include <medComposerExport.h>
+
+#include <type_traits>
+
+class medAbstractData;
+class medAbstractProcess;
+class medComposerNodeCachePrivate;
+
+/**
+ * @class medComposerNodeCache
+ * @brief Outputs of the composer process nodes, reused when a node runs
+ * again on the same inputs with the same parameters.
+ *
+ * A result is keyed by the process implementation, the values of its
+ * parameters and the keys of its inputs. The key of an output is the key of
+ * the run which produced it, the key of a data read from a file depends on
+ * the file and its modification date, any other data gets a key of its own
+ * until it is modified. Changing a parameter thus only misses the cache for
+ * the node and the nodes downstream.
+ *
+ * The cache owns the results. It keeps in memory those of the current
+ * evaluation and, up to a maximum, the most recently used others. They are
+ * also written in a directory when one is set. The
+ * MEDINRIA_COMPOSER_CACHE_DIR environment variable sets the directory at
+ * startup.
+ */
+class MEDCOMPOSER_EXPORT medComposerNodeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static medComposerNodeCache *instance(void);
+
+public:
+    //! Key of a run of the process on the inputs, extra holds values which are not process parameters
+    QByteArray key(medAbstractProcess *process, const QList<medAbstractData *> &inputs, const QStringList &extra = QStringList());
+    QByteArray dataKey(medAbstractData *data);
+
+    //! Key of a file, changed when the file is written
+    static QString fileKey(const QString &path);
+    //! Gives to the data read from a file the key of the file
+    void setSourceFile(medAbstractData *data, const QString &path);
+
+    /**
+     * Result of a previous run, nullptr when there is none.
+     * @param node - title of the node shown in the notifications
+     */
+    medAbstractData *find(const QByteArray &key, const QString &node = QString());
+    void insert(const QByteArray &key, medAbstractData *output);
+
+    template <typename T> T *find(const QByteArray &key, const QString &node = QString())
+    {
+        return dynamic_cast<T *>(find(key, node));
+    }
+
+    /**
+     * Output of the process on its inputs: the result of a previous run when
+     * there is one, otherwise the process runs and its output is inserted.
+     * Returns nullptr when the process fails or is cancelled, its output is
+     * then left out of the cache.
+     * @param node - title of the node shown in the notifications
+     */
+    template <typename Process>
+    auto runProcess(Process *process, const QList<medAbstractData *> &inputs, const QString &node,
+                    const QStringList &extra = QStringList()) -> decltype(process->output())
+    {
+        typedef typename std::remove_pointer<decltype(process->output())>::type OutputType;
+
+        const QByteArray runKey = key(process, inputs, extra);
+        if (OutputType *cached = find<OutputType>(runKey, node))
+        {
+            return cached;
+        }
+
+        if (process->run() != medAbstractJob::MED_JOB_EXIT_SUCCESS)
+        {
+            reportFailure(node);
+            return nullptr;
+        }
+
+        insert(runKey, process->output());
+        return process->output();
+    }
+
+    //! A node could not compute its output
+    void reportFailure(const QString &node);
+
+public:
+    //! Upper bound of the results kept in memory
+    void setMaximumEntries(int entries);
+    void setDirectory(const QString &path);
+    QString directory(void) const;
+
+public slots:
+    //! The results of the previous evaluations may be evicted from memory
+    void startEvaluation(void);
+    void clear(void);
+
+signals:
+    void lookedUp(const QString &node, bool hit);
+    void failed(const QString &node);
+
+protected:
+     medComposerNodeCache(void);
+    ~medComposerNodeCache(void);
+
+private slots:
+    void forget(QObject *data);
+    void onDataModified(medAbstractData *data);
+
+private:
+    medComposerNodeCachePrivate *d;
+};
+
+//
+// medComposerNodeCache.h ends here
@@ -18,6 +18,7 @@
 #include <dtkLog>
 
 #include <medAbstractImageData.h>
+#include <medComposerNodeCache.h>
 #include <medDoubleParameter.h>
 
 class medArithmeticOperationProcessNodePrivate
@@ -59,8 +60,8 @@ void medArithmeticOperationProcessNode<T>::run(void)
         {
             filter->setInput1(d->input1.data());
             filter->setInput2(d->input2.data());
-            filter->run();
-            d->output.setData(filter->output());
+
+            d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input1.data() << d->input2.data(), this->titleHint()));
             qDebug()<<"filtering done";
         }
     }
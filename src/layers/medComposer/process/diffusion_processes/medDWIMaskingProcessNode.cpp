@@ -16,6 +16,7 @@
 #include <dtkLog>
 
 #include <medAbstractImageData.h>
+#include <medComposerNodeCache.h>
 #include <medCore.h>
 #include <medWidgets.h>
 
@@ -50,8 +51,8 @@ void medDWIMaskingProcessNode::run()
     if (this->object())
     {
         filter->setInput(d->input.data());
-        filter->run();
-        d->output.setData(filter->output());
+
+        d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input.data(), this->titleHint()));
     }
 }
 
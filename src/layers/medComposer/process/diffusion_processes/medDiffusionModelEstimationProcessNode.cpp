@@ -17,6 +17,7 @@
 
 #include <medAbstractDiffusionModelImageData.h>
 #include <medBoolParameter.h>
+#include <medComposerNodeCache.h>
 #include <medCore.h>
 #include <medWidgets.h>
 
@@ -63,8 +64,12 @@ void medDiffusionModelEstimationProcessNode::run()
         filter->gradientsInImageCoordinates()->setValue(d->gradientsInImageCoordinates.data());
         filter->setBValues(d->bvalues.data());
 
-        filter->run();
-        d->output.setData(filter->output());
+        // the gradients and b-values are given as files
+        const QStringList extra = QStringList() << medComposerNodeCache::fileKey(d->gradients.data())
+                                                << medComposerNodeCache::fileKey(d->bvalues.data())
+                                                << QString::number(d->gradientsInImageCoordinates.data());
+        d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input.data(),
+                                                                       this->titleHint(), extra));
     }
 }
 
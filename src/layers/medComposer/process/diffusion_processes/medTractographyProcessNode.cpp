@@ -17,6 +17,7 @@
 
 #include <medAbstractDiffusionModelImageData.h>
 #include <medAbstractFibersData.h>
+#include <medComposerNodeCache.h>
 #include <medCore.h>
 #include <medWidgets.h>
 
@@ -52,8 +53,8 @@ void medTractographyProcessNode::run()
     if (this->object())
     {
         filter->setInput(d->input.data());
-        filter->run();
-        d->output.setData(filter->output());
+
+        d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input.data(), this->titleHint()));
     }
 }
 
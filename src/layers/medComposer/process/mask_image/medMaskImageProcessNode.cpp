@@ -16,6 +16,7 @@
 #include <dtkLog>
 
 #include <medAbstractImageData.h>
+#include <medComposerNodeCache.h>
 #include <medCore.h>
 #include <medWidgets.h>
 
@@ -54,8 +55,8 @@ void medMaskImageProcessNode::run()
     {
         filter->setInput(d->input.data());
         filter->setMask(d->mask.data());
-        filter->run();
-        d->output.setData(filter->output());
+
+        d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input.data() << d->mask.data(), this->titleHint()));
     }
 }
 
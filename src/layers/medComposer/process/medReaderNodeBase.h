@@ -14,6 +14,7 @@
 
 #include <dtkComposer>
 
+#include "medComposerNodeCache.h"
 #include "medDataReaderWriter.h"
 #include "medAbstractData.h"
 #include "medAbstractImageData.h"
@@ -78,14 +79,19 @@ template <typename T> inline void medReaderNodeBase<T>::run(void)
         if(!data)
         {
             qWarning()<<"no data found";
+            medComposerNodeCache::instance()->reportFailure(this->titleHint());
             return;
         }
+        medComposerNodeCache::instance()->setSourceFile(data, d->pathRecv.data());
 
         T* specificData=dynamic_cast<T*>(data);
         if(specificData)
             d->outTypeEmt.setData(specificData);
         else
+        {
             qWarning()<<"the data does not match the expected type";
+            medComposerNodeCache::instance()->reportFailure(this->titleHint());
+        }
     }
 }
 
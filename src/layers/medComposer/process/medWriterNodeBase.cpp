@@ -15,6 +15,7 @@
 
 #include "medWriterNodeBase.h"
 
+#include "medComposerNodeCache.h"
 #include "medDataReaderWriter.h"
 #include "medAbstractData.h"
 #include "medAbstractImageData.h"
@@ -50,11 +51,16 @@ void medWriterNodeBase::run(void)
         if(!d->dataRecv.data())
         {
             qWarning()<<Q_FUNC_INFO<<"no data to write";
+            medComposerNodeCache::instance()->reportFailure(this->titleHint());
+            return;
         }
         if(medDataReaderWriter::write(d->pathRecv.data(),d->dataRecv.data()))
             qDebug()<<"wrote data successfully at "<<d->pathRecv.data();
         else
-            qDebug()<<"couldn't write: "<<d->pathRecv.data()<<d->dataRecv.data()->identifier();
+        {
+            qWarning()<<"couldn't write: "<<d->pathRecv.data()<<d->dataRecv.data()->identifier();
+            medComposerNodeCache::instance()->reportFailure(this->titleHint());
+        }
     }
 }
 
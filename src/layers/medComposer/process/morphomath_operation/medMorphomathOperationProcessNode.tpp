@@ -18,6 +18,7 @@
 #include <dtkLog>
 
 #include <medAbstractImageData.h>
+#include <medComposerNodeCache.h>
 #include <medIntParameter.h>
 
 class medMorphomathOperationProcessNodePrivate
@@ -58,8 +59,8 @@ void medMorphomathOperationProcessNode<T>::run(void)
         {
             filter->setInput(d->input.data());
             filter->kernelRadius()->setValue(d->radius.data());
-            filter->run();
-            d->output.setData(filter->output());
+
+            d->output.setData(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input.data(), this->titleHint()));
             qDebug()<<"filtering done";
         }
     }
@@ -29,7 +29,8 @@ public:
 public:
     void run(void);
     virtual bool prepareInput(void);
-    virtual void prepareOutput(void);
+    //! Emits the output of the filter, computed or taken from the cache
+    virtual void prepareOutput(medAbstractImageData *output);
 
 private:
     const QScopedPointer<medSingleFilterOperationProcessNodePrivate> d;
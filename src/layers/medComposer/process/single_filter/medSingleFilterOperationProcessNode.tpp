@@ -18,6 +18,7 @@
 #include <dtkLog>
 
 #include <medAbstractImageData.h>
+#include <medComposerNodeCache.h>
 #include <medDoubleParameter.h>
 
 class medSingleFilterOperationProcessNodePrivate
@@ -64,10 +65,9 @@ bool medSingleFilterOperationProcessNode<T>::prepareInput(void)
 }
 
 template <typename T>
-void medSingleFilterOperationProcessNode<T>::prepareOutput(void)
+void medSingleFilterOperationProcessNode<T>::prepareOutput(medAbstractImageData *output)
 {
-    medAbstractSingleFilterOperationProcess* const filter = this->object();
-    d->output.setData(filter->output());
+    d->output.setData(output);
 }
 
 template <typename T>
@@ -78,8 +78,7 @@ void medSingleFilterOperationProcessNode<T>::run(void)
     if (!filter || !this->prepareInput())
         return;
 
-    filter->run();
-    this->prepareOutput();
+    this->prepareOutput(medComposerNodeCache::instance()->runProcess(filter, QList<medAbstractData *>() << d->input1.data(), this->titleHint()));
 
     qDebug()<<"filtering done";
 }
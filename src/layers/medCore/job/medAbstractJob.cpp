@@ -44,6 +44,11 @@ medAbstractJob::~medAbstractJob()
     medJobManager::instance()->unregisterJob(this);
 }
 
+medJobScheduler::Category medAbstractJob::schedulingCategory() const
+{
+    return medJobScheduler::ProcessJob;
+}
+
 bool medAbstractJob::isRunning() const
 {
     return d->running;
@@ -15,6 +15,7 @@
 #include <QObject>
 
 #include <medCoreExport.h>
+#include <medJobScheduler.h>
 
 class medIntParameter;
 
@@ -38,6 +39,9 @@ public:
 
     virtual QString caption() const = 0;
 
+    /** Category of the job in the medJobScheduler, ProcessJob by default. */
+    virtual medJobScheduler::Category schedulingCategory() const;
+
 public:
     virtual medJobExitStatus run() = 0;
     virtual void cancel() = 0;
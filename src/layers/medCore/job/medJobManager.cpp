@@ -14,11 +14,11 @@
 #include <medJobManager.h>
 
 #include <QApplication>
-#include <QThreadPool>
 
 #include <dtkLog>
 
 #include <medAbstractJob.h>
+#include <medJobScheduler.h>
 
 medJobManager* medJobManager::s_instance = nullptr;
 
@@ -71,7 +71,7 @@ QList<medAbstractJob *> medJobManager::jobs() const
 
 void medJobManager::startJobInThread(medAbstractJob *job)
 {
-    QThreadPool::globalInstance()->start(new medJobRunner(job));
+    medJobScheduler::instance()->start(new medJobRunner(job), job->schedulingCategory());
 }
 
 medJobRunner::medJobRunner(medAbstractJob *job)
@@ -14,19 +14,28 @@
 #include <medAbstractTractographyProcess.h>
 #include <medAbstractFibersData.h>
 #include <medAbstractDiffusionModelImageData.h>
+#include <medAbstractImageData.h>
 #include <medMetaDataKeys.h>
 
+#include <QMutex>
+
 class medAbstractTractographyProcessPrivate
 {
 public:
     medAbstractDiffusionModelImageData *input;
+    medAbstractImageData *seedMask;
     medAbstractFibersData *output;
+
+    // set by the running process, read by the GUI
+    mutable QMutex partialOutputMutex;
+    dtkSmartPointer<medAbstractFibersData> partialOutput;
 };
 
 medAbstractTractographyProcess::medAbstractTractographyProcess(QObject *parent)
     : medAbstractProcess(parent), d(new medAbstractTractographyProcessPrivate)
 {
     d->input = nullptr;
+    d->seedMask = nullptr;
     d->output = nullptr;
 }
 
@@ -45,11 +54,27 @@ medAbstractDiffusionModelImageData* medAbstractTractographyProcess::input() cons
     return d->input;
 }
 
+void medAbstractTractographyProcess::setSeedMask(medAbstractImageData *mask)
+{
+    d->seedMask = mask;
+}
+
+medAbstractImageData* medAbstractTractographyProcess::seedMask() const
+{
+    return d->seedMask;
+}
+
 medAbstractFibersData* medAbstractTractographyProcess::output() const
 {
     return d->output;
 }
 
+dtkSmartPointer<medAbstractFibersData> medAbstractTractographyProcess::partialOutput() const
+{
+    QMutexLocker locker(&d->partialOutputMutex);
+    return d->partialOutput;
+}
+
 void medAbstractTractographyProcess::setOutput(medAbstractFibersData *data)
 {
     d->output = data;
@@ -70,3 +95,20 @@ void medAbstractTractographyProcess::setOutput(medAbstractFibersData *data)
         d->output->addProperty ( property,d->input->propertyValues ( property ) );
     }
 }
+
+void medAbstractTractographyProcess::setPartialOutput(medAbstractFibersData *data)
+{
+    if (data && d->input)
+    {
+        QString newSeriesDescription = d->input->metadata ( medMetaDataKeys::SeriesDescription.key() );
+        newSeriesDescription += " " + this->outputNameAddon() + " (tracking)";
+        data->setMetaData ( medMetaDataKeys::SeriesDescription.key(), newSeriesDescription );
+    }
+
+    {
+        QMutexLocker locker(&d->partialOutputMutex);
+        d->partialOutput = data;
+    }
+
+    emit partialOutputChanged();
+}
@@ -16,9 +16,11 @@
 #include <medCoreExport.h>
 
 #include <dtkCore>
+#include <dtkCoreSupport/dtkSmartPointer.h>
 
 class medAbstractFibersData;
 class medAbstractDiffusionModelImageData;
+class medAbstractImageData;
 class medAbstractTractographyProcessPrivate;
 
 class MEDCORE_EXPORT medAbstractTractographyProcess : public medAbstractProcess
@@ -32,10 +34,23 @@ public:
     void setInput(medAbstractDiffusionModelImageData* data);
     medAbstractDiffusionModelImageData* input() const;
 
+    //! Fibers are only seeded in the non-zero voxels of the mask, when one is set
+    void setSeedMask(medAbstractImageData* mask);
+    medAbstractImageData* seedMask() const;
+
     medAbstractFibersData* output() const;
 
+    //! Fibers tracked so far while the process is running, may be called from any thread.
+    //! The reference keeps them alive when the process replaces them meanwhile.
+    dtkSmartPointer<medAbstractFibersData> partialOutput() const;
+
+signals:
+    void partialOutputChanged();
+
 protected:
     void setOutput(medAbstractFibersData* data);
+    //! Each partial output is a new data, holding all the fibers tracked so far
+    void setPartialOutput(medAbstractFibersData* data);
     virtual QString outputNameAddon() const {return "fibers";}
 
 private:
@@ -45,6 +45,9 @@ public:
     QComboBox *chooseInput;
     QMap <QString, medAbstractImageData *> inputsMap;
 
+    QComboBox *chooseSeedMask;
+    QMap <QString, medAbstractImageData *> seedMasksMap;
+
     QWidget *currentToolBox;
 
     dtkSmartPointer <medAbstractData> processOutput;
@@ -57,6 +60,7 @@ medDiffusionSelectorToolBox::medDiffusionSelectorToolBox(QWidget *parent, Select
     d->currentToolBox = nullptr;
     d->processOutput = nullptr;
     d->methodCombo = nullptr;
+    d->chooseSeedMask = nullptr;
     d->selectorType = type;
 
     // /////////////////////////////////////////////////////////////////
@@ -86,6 +90,21 @@ medDiffusionSelectorToolBox::medDiffusionSelectorToolBox(QWidget *parent, Select
     inputLayout->addWidget(d->chooseInput);
     d->mainLayout->addLayout(inputLayout);
 
+    if (d->selectorType == Tractography)
+    {
+        QHBoxLayout *seedMaskLayout = new QHBoxLayout;
+        QLabel *seedMaskLabel = new QLabel(tr("Seed mask"), mainPage);
+        seedMaskLayout->addWidget(seedMaskLabel);
+
+        d->chooseSeedMask = new QComboBox(mainPage);
+        d->chooseSeedMask->addItem(tr("None (whole volume)"));
+        d->chooseSeedMask->setToolTip(tr("Only seed fibers in the voxels of a mask"));
+        d->chooseSeedMask->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Expanding);
+        connect(d->chooseSeedMask,SIGNAL(currentIndexChanged(int)),this,SLOT(updateCurrentProcessSeedMask(int)));
+        seedMaskLayout->addWidget(d->chooseSeedMask);
+        d->mainLayout->addLayout(seedMaskLayout);
+    }
+
     switch(d->selectorType)
     {
         case Estimation:
@@ -192,9 +211,11 @@ void medDiffusionSelectorToolBox::chooseProcess(int id)
                 medAbstractDiffusionModelImageData *image = dynamic_cast <medAbstractDiffusionModelImageData *> (d->inputsMap[inputId]);
                 process->setInput(image);
             }
+            process->setSeedMask(d->seedMasksMap.value(d->chooseSeedMask->itemData(d->chooseSeedMask->currentIndex()).toString()));
 
             connect(process, &medAbstractJob::finished, this, &medDiffusionSelectorToolBox::jobFinished);
             connect(process,SIGNAL(running(bool)),this,SIGNAL(jobRunning(bool)));
+            connect(process, &medAbstractTractographyProcess::partialOutputChanged, this, &medDiffusionSelectorToolBox::partialOutputChanged);
 
             d->currentProcessPresenter = medWidgets::tractography::presenterFactory().create(process);
             break;
@@ -246,6 +267,15 @@ medAbstractData *medDiffusionSelectorToolBox::processOutput()
     return d->processOutput;
 }
 
+dtkSmartPointer<medAbstractData> medDiffusionSelectorToolBox::processPartialOutput()
+{
+    medAbstractTractographyProcess *process = qobject_cast <medAbstractTractographyProcess *> (d->currentProcess);
+    if (!process)
+        return nullptr;
+
+    return process->partialOutput().data();
+}
+
 void medDiffusionSelectorToolBox::updateCurrentProcessInput(int index)
 {
     if (!d->currentProcess)
@@ -282,14 +312,30 @@ void medDiffusionSelectorToolBox::updateCurrentProcessInput(int index)
     }    
 }
 
+void medDiffusionSelectorToolBox::updateCurrentProcessSeedMask(int index)
+{
+    medAbstractTractographyProcess *process = qobject_cast <medAbstractTractographyProcess *> (d->currentProcess);
+    if (!process)
+        return;
+
+    process->setSeedMask(d->seedMasksMap.value(d->chooseSeedMask->itemData(index).toString()));
+}
+
 void medDiffusionSelectorToolBox::addInputImage(medAbstractImageData *data)
 {
     if (!data)
         return;
-    
-    QUuid dataId = QUuid::createUuid();
-    if ((d->chooseInput->count() == 1)&&(d->chooseInput->itemData(0) == QVariant()))
-        d->chooseInput->removeItem(0);
+
+    if (d->chooseSeedMask && data->identifier() == "itkDataImageUChar3")
+    {
+        if (d->seedMasksMap.values().contains(data))
+            return;
+
+        QString maskId = QUuid::createUuid().toString();
+        d->seedMasksMap[maskId] = data;
+        d->chooseSeedMask->addItem(data->metadata(medMetaDataKeys::SeriesDescription.key()), maskId);
+        return;
+    }
     
     bool dataUsable = (qobject_cast <medAbstractDiffusionModelImageData *> (data) != 0);
     if (d->selectorType == Estimation)
@@ -298,6 +344,10 @@ void medDiffusionSelectorToolBox::addInputImage(medAbstractImageData *data)
     if (!dataUsable)
         return;
 
+    QUuid dataId = QUuid::createUuid();
+    if ((d->chooseInput->count() == 1)&&(d->chooseInput->itemData(0) == QVariant()))
+        d->chooseInput->removeItem(0);
+
     this->setEnabled(true);
 
     d->inputsMap[dataId.toString()] = data;
@@ -313,6 +363,17 @@ void medDiffusionSelectorToolBox::clearInputs()
 	d->chooseInput->setToolTip(tr("Browse available images for processing"));
     
     d->inputsMap.clear();
+
+    if (d->chooseSeedMask)
+    {
+        d->chooseSeedMask->blockSignals(true);
+        d->chooseSeedMask->clear();
+        d->chooseSeedMask->addItem(tr("None (whole volume)"));
+        d->chooseSeedMask->blockSignals(false);
+        d->seedMasksMap.clear();
+        this->updateCurrentProcessSeedMask(0);
+    }
+
     this->setEnabled(false);
 }
 
@@ -16,6 +16,8 @@
 #include <medWidgetsExport.h>
 #include <medAbstractJob.h>
 
+#include <dtkCoreSupport/dtkSmartPointer.h>
+
 class medAbstractDiffusionModelEstimationProcess;
 class medAbstractDiffusionScalarMapsProcess;
 class medAbstractTractographyProcess;
@@ -42,15 +44,19 @@ public:
     void clearInputs();
 
     medAbstractData *processOutput();
+    //! Fibers tracked so far by the running tractography
+    dtkSmartPointer<medAbstractData> processPartialOutput();
 
 public slots:
     void clear();
     void chooseProcess(int id);
     void updateCurrentProcessInput(int index);
+    void updateCurrentProcessSeedMask(int index);
 
 signals:
     void jobFinished(medAbstractJob::medJobExitStatus);
     void jobRunning(bool);
+    void partialOutputChanged();
 
 private:
     medDiffusionSelectorToolBoxPrivate *d;
@@ -225,6 +225,10 @@ int LCCLogDemonsPrivate::update()
     resampler->SetOutputSpacing( proc->fixedImage()->GetSpacing() );
     resampler->SetOutputDirection( proc->fixedImage()->GetDirection() );
     resampler->SetDefaultPixelValue( 0 );
+    if (proc->workUnits() > 0)
+    {
+        resampler->SetNumberOfWorkUnits( proc->workUnits() );
+    }
     
     // Set the image interpolator
     switch(interpolatorType)
@@ -331,6 +335,34 @@ itk::Transform<double,3,3>::Pointer LCCLogDemons::getTransform()
     return nullptr;
 }
 
+bool LCCLogDemons::supportsFrameRegistration() const
+{
+    return true;
+}
+
+bool LCCLogDemons::writeIdentityTransform(const QString& file, itk::ImageBase<3> *grid)
+{
+    try
+    {
+        rpi::writeDisplacementFieldTransformation<double, 3>(identityDisplacementField(grid), file.toStdString());
+    }
+    catch (std::exception& err)
+    {
+        qDebug() << "ExceptionObject caught (writeIdentityTransform): " << err.what();
+        return false;
+    }
+    return true;
+}
+
+itkProcessRegistration *LCCLogDemons::createFrameRegistration()
+{
+    LCCLogDemons *frame = new LCCLogDemons;
+    *frame->d = *d;
+    frame->d->proc = frame;
+    frame->d->registrationMethod = nullptr;
+    return frame;
+}
+
 QString LCCLogDemons::getTitleAndParameters()
 {
     auto registration = d->registrationMethod;
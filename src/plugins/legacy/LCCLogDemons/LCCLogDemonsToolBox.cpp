@@ -43,6 +43,7 @@ public:
     QLineEdit * iterationsLine;
     QComboBox * updateRuleComboBox, * gradientTypeComboBox, * interpolatorTypeComboBox;
     QSpinBox * bchExpansionSpinBox;
+    QSpinBox * referenceFrameBox;
     QDoubleSpinBox *sigmaISpinBox, *similaritySigmaSpinBox, *updateFieldSigmaSpinBox,
         *velocityFieldSigmaSpinBox, *maxStepLengthSpinBox;
     QCheckBox * boundaryCheckBox, *histoMatchingCheckBox;
@@ -160,6 +161,17 @@ LCCLogDemonsToolBox::LCCLogDemonsToolBox(QWidget *parent) : medAbstractSelectabl
     interpolatorTypeLayout->addWidget(d->interpolatorTypeComboBox);
     d->interpolatorTypeComboBox->setCurrentIndex(1);
 
+    QLabel * referenceFrameLabel = new QLabel("4D Reference Frame");
+    d->referenceFrameBox = new QSpinBox();
+    d->referenceFrameBox->setMinimum(-1);
+    d->referenceFrameBox->setMaximum(9999);
+    d->referenceFrameBox->setValue(-1);
+    d->referenceFrameBox->setSpecialValueText(tr("Fixed image"));
+    d->referenceFrameBox->setToolTip(tr("Frame of a 4D moving image the other frames are registered to"));
+    QHBoxLayout * referenceFrameLayout = new QHBoxLayout();
+    referenceFrameLayout->addWidget(referenceFrameLabel);
+    referenceFrameLayout->addWidget(d->referenceFrameBox);
+
     QPushButton *runButton = new QPushButton(tr("Run"), this);
 
     // Layouts
@@ -183,6 +195,7 @@ LCCLogDemonsToolBox::LCCLogDemonsToolBox(QWidget *parent) : medAbstractSelectabl
     commonLayout->addLayout(velocityFieldSigmaLayout);
     commonLayout->addLayout(bchExpansionLayout);
     commonLayout->addLayout(interpolatorTypeLayout);
+    commonLayout->addLayout(referenceFrameLayout);
     d->commonWidget = new QWidget(this);
     d->commonWidget->setLayout(commonLayout);
 
@@ -296,6 +309,7 @@ void LCCLogDemonsToolBox::run()
                         static_cast<unsigned int>(d->bchExpansionSpinBox->value()));
             process_Registration->useMask(false); // LCC-LogDemons crashs if set to true
             process_Registration->setInterpolatorType(d->interpolatorTypeComboBox->currentIndex());
+            process_Registration->setReferenceFrame(d->referenceFrameBox->value());
 
             try
             {
@@ -316,7 +330,7 @@ void LCCLogDemonsToolBox::run()
 
             medRunnableProcess *runProcess = new medRunnableProcess;
             runProcess->setProcess (d->process);
-            this->addConnectionsAndStartJob(runProcess);
+            this->addConnectionsAndStartJob(runProcess, medJobScheduler::HeavyProcessJob);
             enableOnProcessSuccessImportOutput(runProcess, false);
         }
     }
@@ -190,6 +190,10 @@ int diffeomorphicDemonsPrivate::update()
     resampler->SetOutputSpacing( proc->fixedImage()->GetSpacing() );
     resampler->SetOutputDirection( proc->fixedImage()->GetDirection() );
     resampler->SetDefaultPixelValue( 0 );
+    if (proc->workUnits() > 0)
+    {
+        resampler->SetNumberOfWorkUnits( proc->workUnits() );
+    }
 
     try
     {
@@ -254,6 +258,34 @@ itk::Transform<double,3,3>::Pointer diffeomorphicDemons::getTransform()
     return nullptr;
 }
 
+bool diffeomorphicDemons::supportsFrameRegistration() const
+{
+    return true;
+}
+
+bool diffeomorphicDemons::writeIdentityTransform(const QString& file, itk::ImageBase<3> *grid)
+{
+    try
+    {
+        rpi::writeDisplacementFieldTransformation<double, 3>(identityDisplacementField(grid), file.toStdString());
+    }
+    catch (std::exception& err)
+    {
+        qDebug() << "ExceptionObject caught (writeIdentityTransform): " << err.what();
+        return false;
+    }
+    return true;
+}
+
+itkProcessRegistration *diffeomorphicDemons::createFrameRegistration()
+{
+    diffeomorphicDemons *frame = new diffeomorphicDemons;
+    *frame->d = *d;
+    frame->d->proc = frame;
+    frame->d->registrationMethod = nullptr;
+    return frame;
+}
+
 QString diffeomorphicDemons::getTitleAndParameters()
 {
     typedef float PixelType;
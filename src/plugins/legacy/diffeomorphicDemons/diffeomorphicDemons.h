@@ -154,6 +154,18 @@ protected :
     */
     virtual bool writeTransform(const QString& file);
 
+    virtual bool supportsFrameRegistration() const;
+
+    /**
+     * @brief Creates a process with the same parameters, to register a frame of a 4D image.
+    */
+    virtual itkProcessRegistration *createFrameRegistration();
+
+    /**
+     * @brief Writes a null displacement field, for the reference frame of a 4D image.
+    */
+    virtual bool writeIdentityTransform(const QString& file, itk::ImageBase<3> *grid);
+
 private:
     diffeomorphicDemonsPrivate *d;
     friend class diffeomorphicDemonsPrivate;
@@ -35,6 +35,7 @@ public:
     QDoubleSpinBox *updateFieldStdDevBox;
     QCheckBox *useHistogramBox;
     QLineEdit *iterationsBox;
+    QSpinBox *referenceFrameBox;
     medAbstractRegistrationProcess *process;
 };
 
@@ -107,6 +108,13 @@ diffeomorphicDemonsToolBox::diffeomorphicDemonsToolBox(QWidget *parent)
     d->useHistogramBox->setToolTip(tr(
                                        "Use histogram matching before processing?"));
 
+    d->referenceFrameBox = new QSpinBox();
+    d->referenceFrameBox->setMinimum(-1);
+    d->referenceFrameBox->setMaximum(9999);
+    d->referenceFrameBox->setValue(-1);
+    d->referenceFrameBox->setSpecialValueText(tr("Fixed image"));
+    d->referenceFrameBox->setToolTip(tr("Frame of a 4D moving image the other frames are registered to"));
+
     QFormLayout* formLayout = new QFormLayout();
     formLayout->setRowWrapPolicy(QFormLayout::WrapAllRows);
     formLayout->addRow(new QLabel(tr("Iterations per level of res."),this), d->iterationsBox);
@@ -116,6 +124,7 @@ diffeomorphicDemonsToolBox::diffeomorphicDemonsToolBox(QWidget *parent)
     formLayout->addRow(new QLabel(tr("Update Field Std. Deviation"),this),  d->updateFieldStdDevBox);
     formLayout->addRow(new QLabel(tr("Displ. Field Std. Deviation"),this),  d->disFieldStdDevBox);
     formLayout->addRow(new QLabel(tr("Histogram Matching"),this),           d->useHistogramBox);
+    formLayout->addRow(new QLabel(tr("4D Reference Frame"),this),           d->referenceFrameBox);
     layout->addLayout(formLayout);
 
     // Run button
@@ -177,6 +186,7 @@ void diffeomorphicDemonsToolBox::run()
             process_Registration->setUpdateFieldStandardDeviation(d->updateFieldStdDevBox->value());
             process_Registration->setMaximumUpdateLength(d->maxStepLengthBox->value());
             process_Registration->setUseHistogramMatching(d->useHistogramBox->isChecked());
+            process_Registration->setReferenceFrame(d->referenceFrameBox->value());
 
             try
             {
@@ -197,7 +207,7 @@ void diffeomorphicDemonsToolBox::run()
 
             medRunnableProcess *runProcess = new medRunnableProcess;
             runProcess->setProcess (d->process);
-            this->addConnectionsAndStartJob(runProcess);
+            this->addConnectionsAndStartJob(runProcess, medJobScheduler::HeavyProcessJob);
             enableOnProcessSuccessImportOutput(runProcess, false);
         }
     }
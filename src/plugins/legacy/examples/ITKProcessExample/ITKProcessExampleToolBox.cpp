@@ -28,6 +28,7 @@
 
 #include <medRunnableProcess.h>
 #include <medJobManagerL.h>
+#include <medJobScheduler.h>
 #include <medPluginManager.h>
 
 #include <medToolBoxFactory.h>
@@ -124,7 +125,7 @@ void ITKProcessExampleToolBox::run()
     connect (runProcess, SIGNAL (failure  (QObject*)),  this, SIGNAL (failure ()));
 
     medJobManagerL::instance()->registerJobItem(runProcess);
-    QThreadPool::globalInstance()->start(dynamic_cast<QRunnable*>(runProcess));
+    medJobScheduler::instance()->start(dynamic_cast<QRunnable*>(runProcess));
 
 }
 
@@ -66,8 +66,8 @@ public:
     typedef T PixelType;
     enum { Dimension=DIM };
 
-    itkDataImage(): medAbstractTypedImageData<DIM,T>(),d(new PrivateMember) { }
-    itkDataImage(const itkDataImage& other): medAbstractTypedImageData<DIM,T>(), d(new PrivateMember(*(other.d))) { }
+    itkDataImage(): medAbstractTypedImageData<DIM,T>(),d(new PrivateMember) { resetOnModification(); }
+    itkDataImage(const itkDataImage& other): medAbstractTypedImageData<DIM,T>(), d(new PrivateMember(*(other.d))) { resetOnModification(); }
     ~itkDataImage()
     {
         delete d;
@@ -159,6 +159,12 @@ public:
             return d->image->GetLargestPossibleRegion().GetSize()[3];
     }
 
+    qint64 memorySize() {
+        if (d->image.IsNull() || !d->image->GetPixelContainer())
+            return 0;
+        return static_cast<qint64>(d->image->GetPixelContainer()->Size()) * sizeof(T);
+    }
+
     int minRangeValue() { return d->minRangeValue(); }
     int maxRangeValue() { return d->maxRangeValue(); }
 
@@ -166,7 +172,17 @@ public:
     int scalarValueMinCount() { return d->scalarValueMinCount(); }
     int scalarValueMaxCount() { return d->scalarValueMaxCount(); }
 
+    medImageStatistics statistics() { return d->statistics(); }
+    void setStatistics(const medImageStatistics& statistics) { d->setStatistics(statistics); }
+
+    QImage renderThumbnail(QSize size) { return d->thumbnail(size); }
+
 private:
 
+    //! cached statistics no longer match the voxels once the image was edited
+    void resetOnModification() {
+        QObject::connect(this, &medAbstractData::dataModified, this, [this](medAbstractData*) { d->reset(); });
+    }
+
     PrivateMember* d;
 };
@@ -12,9 +12,14 @@
 
 =========================================================================*/
 
-#include <itkMinimumMaximumImageCalculator.h>
-#include <itkScalarImageToHistogramGenerator.h>
 #include <itkImageDuplicator.h>
+#include <itkMultiThreaderBase.h>
+
+#include <medImageStatistics.h>
+#include <medThumbnailRenderer.h>
+
+#include <algorithm>
+#include <limits>
 
 template <unsigned DIM,typename T>
 struct itkDataImagePrivateTypeBase {
@@ -50,6 +55,11 @@ public:
     int scalarValueCount(int) const { return -1; }
     int scalarValueMinCount() const { return -1; }
     int scalarValueMaxCount() const { return -1; }
+
+    medImageStatistics statistics() const { return medImageStatistics(); }
+    void setStatistics(const medImageStatistics&) { }
+
+    QImage thumbnail(const QSize&) const { return QImage(); }
 };
 
 template <unsigned DIM,typename T>
@@ -59,136 +69,140 @@ class itkDataScalarImagePrivateType: public itkDataImagePrivateTypeBase<DIM,T> {
 
 public:
 
-    typedef T                                                                    PixelType;
-    typedef typename base::ImageType                                             ImageType;
-    typedef typename itk::Statistics::ScalarImageToHistogramGenerator<ImageType> HistogramGeneratorType;
-    typedef typename HistogramGeneratorType::HistogramType                       HistogramType;
+    typedef T                        PixelType;
+    typedef typename base::ImageType ImageType;
 
-    itkDataScalarImagePrivateType(): itkDataImagePrivateTypeBase<DIM,T>(), histogram(nullptr),range_min(0),range_max(0),histogram_min(0),histogram_max(0) {
+    itkDataScalarImagePrivateType(): itkDataImagePrivateTypeBase<DIM,T>() {
         reset();
     }
     itkDataScalarImagePrivateType(const itkDataScalarImagePrivateType<DIM,T>& other): itkDataImagePrivateTypeBase<DIM,T>(other)
     {
-        this->histogram = other.histogram;
-        this->range_computed = other.range_computed;
-        this->range_min = other.range_min;
-        this->range_max = other.range_max;
-        this->histogram_min = other.histogram_min;
-        this->histogram_min = other.histogram_min;
-        if (other.histogram)
-        {
-            this->histogram = dynamic_cast<HistogramType*>(other.histogram->CreateAnother().GetPointer());
-        }
-        else
-        {
-            this->histogram = nullptr;
-        }
+        this->stats = other.stats;
+        this->statistics_computed = other.statistics_computed;
     }
 
-    void reset() { range_computed = false; }
+    void reset() {
+        statistics_computed = false;
+        stats = medImageStatistics();
+    }
 
     int minRangeValue() {
-        computeRange();
-        if (!range_computed)
+        computeStatistics();
+        if (!stats.isValid())
         {
             qDebug() << "Cannot compute range";
         }
-        return range_min;
+        return static_cast<int>(std::floor(stats.minimum));
     }
 
     int maxRangeValue() {
-        computeRange();
-        return range_max;
+        computeStatistics();
+        return static_cast<int>(std::ceil(stats.maximum));
     }
 
+    //! count of the histogram bin containing minRangeValue()+value
     int scalarValueCount(int value) {
-        computeValueCounts();
-        return histogram->GetFrequency((PixelType)value);
+        computeStatistics();
+        const int bin = static_cast<int>(std::floor((minRangeValue() + value - stats.histogramOrigin) / stats.binWidth));
+        if (bin < 0 || bin >= stats.histogram.size())
+            return 0;
+        return static_cast<int>(stats.histogram[bin]);
     }
 
     int scalarValueMinCount() {
-        computeValueCounts();
-        return histogram_min;
+        computeStatistics();
+        if (stats.histogram.isEmpty())
+            return 0;
+        return static_cast<int>(*std::min_element(stats.histogram.constBegin(), stats.histogram.constEnd()));
     }
 
     int scalarValueMaxCount() {
-        computeValueCounts();
-        return histogram_max;
+        computeStatistics();
+        if (stats.histogram.isEmpty())
+            return 0;
+        return static_cast<int>(*std::max_element(stats.histogram.constBegin(), stats.histogram.constEnd()));
+    }
+
+    medImageStatistics statistics() {
+        computeStatistics();
+        return stats;
+    }
+
+    void setStatistics(const medImageStatistics& statistics) {
+        if (!statistics.isValid() || base::image.IsNull()
+                || statistics.count > static_cast<qint64>(base::image->GetLargestPossibleRegion().GetNumberOfPixels()))
+            return;
+        stats = statistics;
+        statistics_computed = true;
     }
 
+    QImage thumbnail(const QSize& size) const;
+
 private:
 
-    typename HistogramType::Pointer histogram;
-    bool                            range_computed;
-    PixelType                       range_min;
-    PixelType                       range_max;
-    int                             histogram_min;
-    int                             histogram_max;
+    medImageStatistics stats;
+    bool               statistics_computed;
 
-    void computeRange();
-    void computeValueCounts();
+    void computeStatistics();
 };
 
+//! Min, max, moments and histogram in a single pass over the buffer, split
+//! in chunks accumulated in parallel and merged afterwards.
 template <unsigned DIM,typename T>
-void itkDataScalarImagePrivateType<DIM,T>::computeRange() {
-    if (range_computed)
+void itkDataScalarImagePrivateType<DIM,T>::computeStatistics() {
+    if (statistics_computed)
         return;
 
-    if (base::image->GetLargestPossibleRegion().GetNumberOfPixels()==0)
+    if (base::image.IsNull() || !base::image->GetBufferPointer())
         return;
 
-    typedef itk::MinimumMaximumImageCalculator<ImageType> MinMaxCalculatorType;
-
-    typename MinMaxCalculatorType::Pointer calculator = MinMaxCalculatorType::New();
-    calculator->SetImage(base::image);
-    calculator->SetRegion(base::image->GetLargestPossibleRegion());
-    try {
-        calculator->Compute();
-    } catch (itk::ExceptionObject &e) {
-        std::cerr << e;
+    const itk::SizeValueType pixelCount = base::image->GetBufferedRegion().GetNumberOfPixels();
+    if (pixelCount == 0)
         return;
-    }
-    range_min = calculator->GetMinimum();
-    range_max = calculator->GetMaximum();
-    range_computed = true;
-}
 
-template <unsigned DIM,typename T>
-void itkDataScalarImagePrivateType<DIM,T>::computeValueCounts() {
-    if (histogram.IsNull()) {
-        computeRange();
-
-        typename HistogramGeneratorType::Pointer histogramGenerator = HistogramGeneratorType::New();
-        histogramGenerator->SetInput(base::image);
-        histogramGenerator->SetNumberOfBins(range_max-range_min+1);
-        histogramGenerator->SetMarginalScale(1.0);
-        histogramGenerator->SetHistogramMin(range_min);
-        histogramGenerator->SetHistogramMax(range_max);
-
-        try {
-            std::cerr << "calculating histogram...";
-            histogramGenerator->Compute();
-            std::cerr << "done" << std::endl;
-        } catch (itk::ExceptionObject &e) {
-            std::cerr << e;
-            return;
-        }
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    const itk::SizeValueType chunkCount = std::min<itk::SizeValueType>(pixelCount / 65536 + 1,
+                                                                       4 * threader->GetNumberOfWorkUnits());
+    const itk::SizeValueType chunkSize = (pixelCount + chunkCount - 1) / chunkCount;
 
-        typedef typename HistogramGeneratorType::HistogramType HistogramType;
-        typedef typename HistogramType::AbsoluteFrequencyType FrequencyType;
+    const PixelType *pixels = base::image->GetBufferPointer();
+    medImageStatistics::Accumulator pixelTypeAccumulator(std::numeric_limits<PixelType>::is_integer);
+    pixelTypeAccumulator.setValueRange(static_cast<double>(std::numeric_limits<PixelType>::lowest()),
+                                       static_cast<double>(std::numeric_limits<PixelType>::max()));
+    std::vector<medImageStatistics::Accumulator> accumulators(chunkCount, pixelTypeAccumulator);
 
-        histogram = const_cast<HistogramType*>(histogramGenerator->GetOutput());
+    threader->ParallelizeArray(0, chunkCount, [&](itk::SizeValueType chunk)
+    {
+        medImageStatistics::Accumulator &accumulator = accumulators[chunk];
+        const itk::SizeValueType end = std::min(pixelCount, (chunk + 1) * chunkSize);
+        for (itk::SizeValueType i = chunk * chunkSize; i < end; ++i)
+            accumulator.add(static_cast<double>(pixels[i]));
+    }, nullptr);
 
-        FrequencyType min = itk::NumericTraits< FrequencyType >::max();
-        FrequencyType max = itk::NumericTraits< FrequencyType >::min();
+    for (itk::SizeValueType chunk = 1; chunk < chunkCount; ++chunk)
+        accumulators[0].merge(accumulators[chunk]);
 
-        typedef typename HistogramType::Iterator Iterator;
-        for (Iterator it=histogram->Begin(),end=histogram->End();it!=end;++it) {
-            FrequencyType c = it.GetFrequency();
-            if (min>c) min = c;
-            if (max<c) max = c;
-        }
-        histogram_min = static_cast<int>(min);
-        histogram_max = static_cast<int>(max);
-    }
+    stats = accumulators[0].statistics();
+    statistics_computed = true;
+}
+
+template <unsigned DIM,typename T>
+QImage itkDataScalarImagePrivateType<DIM,T>::thumbnail(const QSize& size) const {
+    if (base::image.IsNull() || !base::image->GetBufferPointer())
+        return QImage();
+
+    // middle slice of the first volume
+    const typename ImageType::SizeType imageSize = base::image->GetBufferedRegion().GetSize();
+    const int width  = imageSize[0];
+    const int height = (DIM > 1) ? imageSize[1] : 1;
+    const qint64 offset = (DIM > 2) ? static_cast<qint64>(imageSize[2] / 2) * width * height : 0;
+
+    QVector<float> values(width * height);
+    const PixelType *pixels = base::image->GetBufferPointer() + offset;
+    for (int i = 0; i < values.size(); ++i)
+        values[i] = static_cast<float>(pixels[i]);
+
+    const typename ImageType::SpacingType spacing = base::image->GetSpacing();
+    return medThumbnailRenderer::renderSlice(values, width, height,
+                                             spacing[0], (DIM > 1) ? spacing[1] : spacing[0], size);
 }
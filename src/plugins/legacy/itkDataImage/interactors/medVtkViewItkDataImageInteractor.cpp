@@ -71,6 +71,26 @@ public:
 
     bool isFloatImage;
     double intensityStep;
+
+    /**
+     * Range of the voxel values, from the statistics cached on the data when
+     * available rather than from a scan of the VTK image.
+     */
+    void scalarRange(int layer, double range[2])
+    {
+        medImageStatistics statistics = imageData ? imageData->statistics() : medImageStatistics();
+        if (statistics.isValid())
+        {
+            range[0] = statistics.minimum;
+            range[1] = statistics.maximum;
+        }
+        else
+        {
+            double *viewRange = view2d->GetScalarRange(layer);
+            range[0] = viewRange[0];
+            range[1] = viewRange[1];
+        }
+    }
 };
 
 
@@ -186,7 +206,8 @@ void medVtkViewItkDataImageInteractor::setInputData(medAbstractData *data)
 
         initParameters(d->imageData);
 
-        double* range = d->view2d->GetScalarRange(getCurrentImageDataLayer());
+        double range[2];
+        d->scalarRange(getCurrentImageDataLayer(), range);
         this->initWindowLevelParameters(range);
     }
 }
@@ -429,7 +450,8 @@ void medVtkViewItkDataImageInteractor::setPreset(QString preset)
 
     if ( preset == "None" )
     {
-        double *range = d->view2d->GetScalarRange(getCurrentImageDataLayer());
+        double range[2];
+        d->scalarRange(getCurrentImageDataLayer(), range);
         wl["Window"] = QVariant(range[1]-range[0]);
         wl["Level"] = QVariant(0.5*(range[1]+range[0]));
         setWindowLevel(wl);
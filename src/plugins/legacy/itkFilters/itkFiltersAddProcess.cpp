@@ -84,21 +84,29 @@ int itkFiltersAddProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersAddProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersAddProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::AddImageFilter<ImageType, itk::Image<double, ImageType::ImageDimension>, ImageType> AddFilterType;
     typename AddFilterType::Pointer addFilter = AddFilterType::New();
 
     addFilter->SetInput(inputImage);
     addFilter->SetConstant ( d->addValue );
 
+    return addFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersAddProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer addFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     addFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(addFilter);
     addFilter->Update();
 
     getOutputData()->setData(addFilter->GetOutput());
@@ -109,6 +117,11 @@ int itkFiltersAddProcess::updateProcess(medAbstractData* inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersAddProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersAddProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
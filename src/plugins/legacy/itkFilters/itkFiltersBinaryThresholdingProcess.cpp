@@ -104,10 +104,8 @@ int itkFiltersBinaryThresholdingProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersBinaryThresholdingProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersBinaryThresholdingProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::BinaryThresholdImageFilter < ImageType, ImageType>  BinaryThresholdImageFilterType;
     typename BinaryThresholdImageFilterType::Pointer thresholdFilter = BinaryThresholdImageFilterType::New();
     thresholdFilter->SetInput(inputImage);
@@ -116,11 +114,21 @@ int itkFiltersBinaryThresholdingProcess::updateProcess(medAbstractData* inputDat
     thresholdFilter->SetInsideValue(d->insideValue);
     thresholdFilter->SetOutsideValue(d->outsideValue);
 
+    return thresholdFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersBinaryThresholdingProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer thresholdFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     thresholdFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(thresholdFilter);
     thresholdFilter->Update();
 
     getOutputData()->setData(thresholdFilter->GetOutput());
@@ -130,6 +138,11 @@ int itkFiltersBinaryThresholdingProcess::updateProcess(medAbstractData* inputDat
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersBinaryThresholdingProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersBinaryThresholdingProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
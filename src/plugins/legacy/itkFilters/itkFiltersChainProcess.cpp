@@ -0,0 +1,181 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <dtkCoreSupport/dtkAbstractProcessFactory.h>
+
+#include <itkFiltersChainProcess.h>
+#include <itkImage.h>
+#include <itkStreamingImageFilter.h>
+
+#include <medUtilities.h>
+#include <medUtilitiesITK.h>
+
+class itkFiltersChainProcessPrivate
+{
+public:
+    QList< dtkSmartPointer<itkFiltersProcessBase> > processes;
+    qint64 slabMemory;
+};
+
+const qint64 itkFiltersChainProcess::defaultSlabMemory = 64 * 1024 * 1024;
+
+itkFiltersChainProcess::itkFiltersChainProcess(itkFiltersChainProcess *parent)
+    : itkFiltersProcessBase(parent), d(new itkFiltersChainProcessPrivate)
+{
+    d->slabMemory = defaultSlabMemory;
+}
+
+//-------------------------------------------------------------------------------------------
+
+itkFiltersChainProcess::~itkFiltersChainProcess()
+{
+    delete d;
+}
+
+//-------------------------------------------------------------------------------------------
+
+bool itkFiltersChainProcess::registered()
+{
+    return dtkAbstractProcessFactory::instance()->registerProcessType("itkChainProcess", createitkFiltersChainProcess);
+}
+
+//-------------------------------------------------------------------------------------------
+
+QString itkFiltersChainProcess::description() const
+{
+    return tr("Filter chain");
+}
+
+//-------------------------------------------------------------------------------------------
+
+void itkFiltersChainProcess::appendProcess(dtkSmartPointer<itkFiltersProcessBase> process)
+{
+    if (process)
+    {
+        d->processes.append(process);
+    }
+}
+
+void itkFiltersChainProcess::clearProcesses()
+{
+    d->processes.clear();
+}
+
+//-------------------------------------------------------------------------------------------
+
+void itkFiltersChainProcess::setParameter(double data)
+{
+    d->slabMemory = std::max<qint64>(1, static_cast<qint64>(data));
+}
+
+//-------------------------------------------------------------------------------------------
+
+int itkFiltersChainProcess::tryUpdate()
+{
+    int res = medAbstractProcessLegacy::FAILURE;
+
+    if (getInputData() && !d->processes.isEmpty())
+    {
+        res = DISPATCH_ON_3D_PIXEL_TYPE(&itkFiltersChainProcess::updateProcess, this, getInputData());
+    }
+
+    return res;
+}
+
+template <class ImageType>
+int itkFiltersChainProcess::updateProcess(medAbstractData *inputData)
+{
+    QList<itk::ProcessObject::Pointer> pipeline;
+    QStringList descriptions;
+    int streamedFilters = 0; // first filter of the streamed part of the pipeline
+
+    for (dtkSmartPointer<itkFiltersProcessBase> process : d->processes)
+    {
+        if (process->appendToPipeline(inputData, &pipeline) != medAbstractProcessLegacy::SUCCESS)
+        {
+            qWarning() << "itkFiltersChainProcess:" << process->description() << "cannot be chained";
+            return medAbstractProcessLegacy::FAILURE;
+        }
+        if (!process->isStreamable())
+        {
+            streamedFilters = pipeline.size();
+        }
+        descriptions << process->description();
+    }
+
+    // intermediate slabs are released as soon as the next filter used them
+    for (itk::ProcessObject::Pointer filter : pipeline)
+    {
+        filter->ReleaseDataFlagOn();
+        setWorkUnits(filter);
+    }
+
+    itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
+    callback->SetClientData(( void * ) this);
+    callback->SetCallback(itkFiltersProcessBase::eventCallback);
+
+    if (streamedFilters > 0)
+    {
+        // filters requesting their whole input would run again for every slab:
+        // the chain up to the last of them runs at once, its output is kept
+        // for the streamed filters
+        itk::ProcessObject *head = pipeline[streamedFilters - 1];
+        head->AddObserver(itk::ProgressEvent(), callback);
+        head->Update();
+
+        typename ImageType::Pointer headOutput = dynamic_cast<ImageType*>(head->GetPrimaryOutput());
+        headOutput->DisconnectPipeline();
+        headOutput->ReleaseDataFlagOff();
+
+        if (streamedFilters == pipeline.size())
+        {
+            getOutputData()->setData(headOutput);
+            medUtilities::setDerivedMetaData(getOutputData(), inputData, descriptions.join(", "));
+            return medAbstractProcessLegacy::SUCCESS;
+        }
+    }
+
+    ImageType *pipelineOutput = pipelineEnd<ImageType>(inputData, pipeline);
+    pipelineOutput->UpdateOutputInformation();
+
+    // each streamed filter holds a slab, the number of slabs bounds their total size
+    const qint64 outputBytes = static_cast<qint64>(pipelineOutput->GetLargestPossibleRegion().GetNumberOfPixels())
+            * sizeof(typename ImageType::PixelType);
+    const qint64 streamedCount = pipeline.size() - streamedFilters;
+    const qint64 slabCount = std::max<qint64>(1, (outputBytes * streamedCount + d->slabMemory - 1) / d->slabMemory);
+
+    typedef itk::StreamingImageFilter<ImageType, ImageType> StreamingFilterType;
+    typename StreamingFilterType::Pointer streamingFilter = StreamingFilterType::New();
+    streamingFilter->SetInput(pipelineOutput);
+    streamingFilter->SetNumberOfStreamDivisions(static_cast<unsigned int>(slabCount));
+    streamingFilter->AddObserver(itk::ProgressEvent(), callback);
+
+    setWorkUnits(streamingFilter);
+    streamingFilter->Update();
+
+    getOutputData()->setData(streamingFilter->GetOutput());
+
+    QString newSeriesDescription = descriptions.join(", ");
+    medUtilities::setDerivedMetaData(getOutputData(), inputData, newSeriesDescription);
+
+    return medAbstractProcessLegacy::SUCCESS;
+}
+
+// /////////////////////////////////////////////////////////////////
+// Type instanciation
+// /////////////////////////////////////////////////////////////////
+
+dtkAbstractProcess * createitkFiltersChainProcess()
+{
+    return new itkFiltersChainProcess;
+}
@@ -0,0 +1,56 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <itkFiltersProcessBase.h>
+
+class itkFiltersChainProcessPrivate;
+class medAbstractData;
+
+/**
+ * Runs several itkFilters processes as a single pipeline, streamed over
+ * slabs of the image: only the final output is allocated, the intermediate
+ * images only hold the current slab (enlarged by the neighborhood of the
+ * filters that need one). Filters requesting their whole input, as the
+ * recursive Gaussian, are not streamed: the pipeline up to the last of them
+ * runs at once and only the following filters are streamed.
+ */
+class ITKFILTERSPLUGIN_EXPORT itkFiltersChainProcess : public itkFiltersProcessBase
+{
+    Q_OBJECT
+
+public:
+    static const qint64 defaultSlabMemory;
+
+    itkFiltersChainProcess(itkFiltersChainProcess *parent = nullptr);
+    virtual ~itkFiltersChainProcess();
+    static bool registered();
+    virtual QString description() const;
+
+    //! Processes are run in the order they are appended, their input is ignored
+    void appendProcess(dtkSmartPointer<itkFiltersProcessBase> process);
+    void clearProcesses();
+
+public slots:
+    //! Upper bound in bytes of an image slab
+    void setParameter(double data);
+    int tryUpdate();
+
+protected:
+    template <class ImageType> int updateProcess(medAbstractData *inputData);
+
+private:
+    itkFiltersChainProcessPrivate *d;
+};
+
+dtkAbstractProcess * createitkFiltersChainProcess();
@@ -114,6 +114,7 @@ dtkSmartPointer<medAbstractData> itkFiltersComponentSizeThresholdProcess::castTo
     typename CastFilterType::Pointer  caster = CastFilterType::New();
     typename InputImageType::Pointer im = static_cast<InputImageType*>(inputData->data());
     caster->SetInput(im);
+    setWorkUnits(caster);
     caster->Update();
 
     dtkSmartPointer<medAbstractData> outputData = medAbstractDataFactory::instance()->createSmartPointer(medUtilitiesITK::itkDataImageId<OutputImageType>());
@@ -147,6 +148,7 @@ int itkFiltersComponentSizeThresholdProcess::updateProcess(medAbstractData *inpu
         windowingFilter->SetWindowMaximum(maxValueImage);
         windowingFilter->SetOutputMinimum(0);
         windowingFilter->SetOutputMaximum(1);
+        setWorkUnits(windowingFilter);
         windowingFilter->Update();
         inputImage = windowingFilter->GetOutput();
     }
@@ -154,6 +156,7 @@ int itkFiltersComponentSizeThresholdProcess::updateProcess(medAbstractData *inpu
     typedef itk::ConnectedComponentImageFilter <InputImageType, OutputImageType> ConnectedComponentFilterType;
     typename ConnectedComponentFilterType::Pointer connectedComponentFilter = ConnectedComponentFilterType::New();
     connectedComponentFilter->SetInput(inputImage);
+    setWorkUnits(connectedComponentFilter);
     connectedComponentFilter->Update();
 
     // RELABEL COMPONENTS according to their sizes (0:largest(background))
@@ -161,6 +164,7 @@ int itkFiltersComponentSizeThresholdProcess::updateProcess(medAbstractData *inpu
     typename FilterType::Pointer relabelFilter = FilterType::New();
     relabelFilter->SetInput(connectedComponentFilter->GetOutput());
     relabelFilter->SetMinimumObjectSize(d->minimumSize);
+    setWorkUnits(relabelFilter);
     relabelFilter->Update();
 
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
@@ -181,6 +185,7 @@ int itkFiltersComponentSizeThresholdProcess::updateProcess(medAbstractData *inpu
         thresholdFilter->SetInsideValue(0);
         thresholdFilter->SetOutsideValue(1);
 
+        setWorkUnits(thresholdFilter);
         thresholdFilter->Update();
         getOutputData()->setData(thresholdFilter->GetOutput());
     }
@@ -84,21 +84,29 @@ int itkFiltersDivideProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersDivideProcess::updateProcess(medAbstractData *inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersDivideProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::DivideImageFilter< ImageType, itk::Image<double, ImageType::ImageDimension>, ImageType >  DivideFilterType;
     typename DivideFilterType::Pointer divideFilter = DivideFilterType::New();
 
     divideFilter->SetInput(inputImage);
     divideFilter->SetConstant(d->divideFactor);
 
+    return divideFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersDivideProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer divideFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     divideFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(divideFilter);
     divideFilter->Update();
 
     getOutputData()->setData(divideFilter->GetOutput());
@@ -109,6 +117,11 @@ int itkFiltersDivideProcess::updateProcess(medAbstractData *inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersDivideProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersDivideProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
@@ -82,21 +82,29 @@ int itkFiltersGaussianProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersGaussianProcess::updateProcess(medAbstractData *inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersGaussianProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::SmoothingRecursiveGaussianImageFilter< ImageType, ImageType >  GaussianFilterType;
     typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
 
     gaussianFilter->SetInput(inputImage);
     gaussianFilter->SetSigma(d->sigma);
 
+    return gaussianFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersGaussianProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer gaussianFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     gaussianFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(gaussianFilter);
     gaussianFilter->Update();
 
     getOutputData()->setData(gaussianFilter->GetOutput());
@@ -107,6 +115,23 @@ int itkFiltersGaussianProcess::updateProcess(medAbstractData *inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersGaussianProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersGaussianProcess>(inputData, pipeline);
+}
+
+bool itkFiltersGaussianProcess::isStreamable() const
+{
+    // the recursive Gaussian requests its whole input
+    return false;
+}
+
+double itkFiltersGaussianProcess::kernelRadius() const
+{
+    // the Gaussian weighs less than 1e-3 of its peak beyond 4 sigmas
+    return 4 * d->sigma;
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
@@ -29,6 +29,11 @@ public:
     virtual ~itkFiltersGaussianProcess();
     static bool registered();
     virtual QString description() const;
+
+    int appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline);
+    bool isStreamable() const;
+    double kernelRadius() const;
+    template <class ImageType> typename itk::ImageSource<ImageType>::Pointer createFilter(ImageType *inputImage);
     
 public slots:
     void setParameter(double data);
@@ -85,6 +85,7 @@ int itkFiltersInvertProcess::updateProcess(medAbstractData* inputData)
         callback->SetCallback(itkFiltersProcessBase::eventCallback);
         invertFilter->AddObserver(itk::ProgressEvent(), callback);
 
+        setWorkUnits(invertFilter);
         invertFilter->Update();
 
         getOutputData()->setData(invertFilter->GetOutput());
@@ -72,10 +72,8 @@ int itkFiltersMedianProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersMedianProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersMedianProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::MedianImageFilter< ImageType, ImageType >  MedianFilterType;
     typename MedianFilterType::Pointer medianFilter = MedianFilterType::New();
     typename MedianFilterType::InputSizeType radius;
@@ -85,11 +83,21 @@ int itkFiltersMedianProcess::updateProcess(medAbstractData* inputData)
     medianFilter->SetRadius(radius);
     medianFilter->SetInput(inputImage);
 
+    return medianFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersMedianProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer medianFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     medianFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(medianFilter);
     medianFilter->Update();
 
     getOutputData()->setData(medianFilter->GetOutput());
@@ -101,6 +109,11 @@ int itkFiltersMedianProcess::updateProcess(medAbstractData* inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersMedianProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersMedianProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
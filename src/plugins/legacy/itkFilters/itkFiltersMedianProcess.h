@@ -28,6 +28,9 @@ public:
 
     static bool registered();
     virtual QString description() const;
+
+    int appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline);
+    template <class ImageType> typename itk::ImageSource<ImageType>::Pointer createFilter(ImageType *inputImage);
     
 public slots:
     void setParameter(double data);
@@ -84,21 +84,29 @@ int itkFiltersMultiplyProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersMultiplyProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersMultiplyProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::MultiplyImageFilter< ImageType, itk::Image<double, ImageType::ImageDimension>, ImageType >  MultiplyFilterType;
     typename MultiplyFilterType::Pointer multiplyFilter = MultiplyFilterType::New();
 
     multiplyFilter->SetInput(inputImage);
     multiplyFilter->SetConstant(d->multiplyFactor);
 
+    return multiplyFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersMultiplyProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer multiplyFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     multiplyFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(multiplyFilter);
     multiplyFilter->Update();
 
     getOutputData()->setData(multiplyFilter->GetOutput());
@@ -110,6 +118,11 @@ int itkFiltersMultiplyProcess::updateProcess(medAbstractData* inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersMultiplyProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersMultiplyProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
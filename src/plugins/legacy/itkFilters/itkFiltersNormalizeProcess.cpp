@@ -70,6 +70,7 @@ int itkFiltersNormalizeProcess::updateProcess(medAbstractData* inputData)
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     normalizeFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(normalizeFilter);
     normalizeFilter->Update();
 
     getOutputData()->setData(normalizeFilter->GetOutput());
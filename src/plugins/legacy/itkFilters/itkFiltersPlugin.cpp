@@ -15,6 +15,7 @@
 #include <itkFiltersBinaryCloseProcess.h>
 #include <itkFiltersBinaryOpenProcess.h>
 #include <itkFiltersBinaryThresholdingProcess.h>
+#include <itkFiltersChainProcess.h>
 #include <itkFiltersComponentSizeThresholdProcess.h>
 #include <itkFiltersDilateProcess.h>
 #include <itkFiltersDivideProcess.h>
@@ -48,6 +49,10 @@ bool itkFiltersPlugin::initialize()
     {
         qWarning() << "Unable to register itkFilters binary thresholding filter process type";
     }
+    if ( !itkFiltersChainProcess::registered() )
+    {
+        qWarning() << "Unable to register itkFilters chain process type";
+    }
     if ( !itkFiltersSubtractProcess::registered() )
     {
         qWarning() << "Unable to register itkFilters subtract process type";
@@ -15,6 +15,7 @@
 #include <itkProcessObject.h>
 
 #include <medAbstractDataFactory.h>
+#include <medJobScheduler.h>
 
 class itkFiltersProcessBasePrivate
 {
@@ -80,6 +81,24 @@ int itkFiltersProcessBase::update()
     return res;
 }
 
+int itkFiltersProcessBase::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    Q_UNUSED(inputData);
+    Q_UNUSED(pipeline);
+
+    return medAbstractProcessLegacy::FAILURE;
+}
+
+bool itkFiltersProcessBase::isStreamable() const
+{
+    return true;
+}
+
+double itkFiltersProcessBase::kernelRadius() const
+{
+    return 0;
+}
+
 void itkFiltersProcessBase::eventCallback ( itk::Object *caller, const itk::EventObject& event, void *clientData)
 {
     itkFiltersProcessBase * source = reinterpret_cast<itkFiltersProcessBase *> ( clientData );
@@ -93,6 +112,11 @@ void itkFiltersProcessBase::eventCallback ( itk::Object *caller, const itk::Even
     source->emitProgress(static_cast<int>((processObject->GetProgress() * 100)));
 }
 
+void itkFiltersProcessBase::setWorkUnits(itk::ProcessObject *filter)
+{
+    filter->SetNumberOfWorkUnits(medJobScheduler::instance()->threadsPerJob());
+}
+
 dtkSmartPointer<medAbstractImageData> itkFiltersProcessBase::getInputData()
 {
     return d->inputData;
@@ -16,9 +16,11 @@
 
 #include <itkCommand.h>
 #include <itkFiltersPluginExport.h>
+#include <itkImageSource.h>
 
 #include <medAbstractImageData.h>
 #include <medAbstractProcessLegacy.h>
+#include <medUtilitiesITK.h>
 
 class itkFiltersProcessBasePrivate;
 
@@ -43,14 +45,81 @@ public:
     }
     int update();
 
+    /**
+     * Appends the filter of the process to a pipeline, without running it,
+     * so that several processes can be streamed together by
+     * itkFiltersChainProcess.
+     * @param inputData - image at the head of the pipeline
+     * @param pipeline - filters already appended, the last one is the end of the pipeline
+     * @return medAbstractProcessLegacy::SUCCESS, or FAILURE when the process
+     * cannot be chained
+     */
+    virtual int appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline);
+
+    /**
+     * False when the filters appended by the process request their whole
+     * input whatever their output region, as the recursive Gaussian does:
+     * streaming would run them again for every slab.
+     */
+    virtual bool isStreamable() const;
+
+    /**
+     * Distance, in physical units, from which the input still weighs on an
+     * output voxel. Filters that are not streamable only need this margin
+     * around the region they compute.
+     */
+    virtual double kernelRadius() const;
+
     static void eventCallback ( itk::Object *caller, const itk::EventObject& event, void *clientData);
 
+    //! Splits the work of the filter over the threads the job scheduler leaves to each job
+    static void setWorkUnits(itk::ProcessObject *filter);
+
 protected:
     dtkSmartPointer<medAbstractImageData> getInputData();
     void setInputData(dtkSmartPointer<medAbstractImageData> inputData);
     dtkSmartPointer<medAbstractImageData> getOutputData();
     void setOutputData(dtkSmartPointer<medAbstractImageData> outputData);
 
+    //! Output of the last filter of a pipeline, or the input image if it is empty
+    template <class ImageType>
+    static ImageType* pipelineEnd(medAbstractData *inputData, const QList<itk::ProcessObject::Pointer> &pipeline)
+    {
+        if (pipeline.isEmpty())
+        {
+            return static_cast<ImageType*>(inputData->data());
+        }
+        return dynamic_cast<ImageType*>(pipeline.last()->GetPrimaryOutput());
+    }
+
+    //! appendToPipeline() of the processes made of the single filter returned
+    //! by ProcessType::createFilter<ImageType>(ImageType *inputImage)
+    template <class ProcessType>
+    int appendCreatedFilter(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+    {
+        return medUtilitiesITK::dispatchOn3DPixelType(
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageChar3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageUChar3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageShort3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageUShort3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageInt3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageUInt3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageLong3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageULong3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageFloat3>,
+                    &itkFiltersProcessBase::appendFilter<ProcessType, medUtilitiesITK::itkImageDouble3>,
+                    this, inputData, pipeline);
+    }
+
 private:
+    template <class ProcessType, class ImageType>
+    int appendFilter(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+    {
+        ImageType *input = pipelineEnd<ImageType>(inputData, *pipeline);
+        pipeline->append(static_cast<ProcessType*>(this)->template createFilter<ImageType>(input).GetPointer());
+
+        return medAbstractProcessLegacy::SUCCESS;
+    }
+
     itkFiltersProcessBasePrivate *d;
 };
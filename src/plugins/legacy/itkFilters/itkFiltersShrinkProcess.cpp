@@ -99,21 +99,29 @@ int itkFiltersShrinkProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersShrinkProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersShrinkProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::ShrinkImageFilter< ImageType, ImageType >  ShrinkFilterType;
     typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
 
     shrinkFilter->SetInput(inputImage);
     shrinkFilter->SetShrinkFactors(d->shrinkFactors);
 
+    return shrinkFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersShrinkProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer shrinkFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     shrinkFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(shrinkFilter);
     shrinkFilter->Update();
 
     getOutputData()->setData(shrinkFilter->GetOutput());
@@ -125,6 +133,11 @@ int itkFiltersShrinkProcess::updateProcess(medAbstractData* inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersShrinkProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersShrinkProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
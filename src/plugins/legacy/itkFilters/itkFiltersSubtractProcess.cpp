@@ -84,10 +84,8 @@ int itkFiltersSubtractProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersSubtractProcess::updateProcess(medAbstractData *inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersSubtractProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     using ShiftScaleFilterType = itk::ShiftScaleImageFilter<ImageType, ImageType >;
     typename ShiftScaleFilterType::Pointer shiftFilter = ShiftScaleFilterType::New();
     shiftFilter->SetInput(inputImage);
@@ -96,11 +94,21 @@ int itkFiltersSubtractProcess::updateProcess(medAbstractData *inputData)
     double negValue = -1.0 * d->subtractValue;
     shiftFilter->SetShift(negValue);
 
+    return shiftFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersSubtractProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer shiftFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     shiftFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(shiftFilter);
     shiftFilter->Update();
 
     getOutputData()->setData(shiftFilter->GetOutput());
@@ -112,6 +120,11 @@ int itkFiltersSubtractProcess::updateProcess(medAbstractData *inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersSubtractProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersSubtractProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
@@ -113,10 +113,8 @@ int itkFiltersThresholdingProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersThresholdingProcess::updateProcess(medAbstractData *inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersThresholdingProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::ThresholdImageFilter < ImageType>  ThresholdImageFilterType;
     typename ThresholdImageFilterType::Pointer thresholdFilter = ThresholdImageFilterType::New();
     thresholdFilter->SetInput(inputImage);
@@ -135,11 +133,21 @@ int itkFiltersThresholdingProcess::updateProcess(medAbstractData *inputData)
     }
     thresholdFilter->SetOutsideValue( d->outsideValue );
 
+    return thresholdFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersThresholdingProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer thresholdFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     thresholdFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(thresholdFilter);
     thresholdFilter->Update();
 
     getOutputData()->setData(thresholdFilter->GetOutput());
@@ -150,6 +158,11 @@ int itkFiltersThresholdingProcess::updateProcess(medAbstractData *inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersThresholdingProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersThresholdingProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
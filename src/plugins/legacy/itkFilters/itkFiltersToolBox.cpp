@@ -18,6 +18,7 @@
 #include <itkFiltersProcessBase.h>
 #include <itkFiltersAddProcess.h>
 #include <itkFiltersBinaryThresholdingProcess.h>
+#include <itkFiltersChainProcess.h>
 #include <itkFiltersComponentSizeThresholdProcess.h>
 #include <itkFiltersDivideProcess.h>
 #include <itkFiltersGaussianProcess.h>
@@ -27,15 +28,21 @@
 #include <itkFiltersSubtractProcess.h>
 #include <itkFiltersThresholdingProcess.h>
 #include <itkFiltersWindowingProcess.h>
+#include <itkExtractImageFilter.h>
+#include <itkImageRegionIterator.h>
 #include <itkMinimumMaximumImageCalculator.h>
 
+#include <medAbstractDataFactory.h>
+#include <medAbstractImageView.h>
 #include <medClutEditorToolBox.h>
 #include <medComboBox.h>
 #include <medDoubleParameterL.h>
 #include <medIntParameterL.h>
+#include <medMetaDataKeys.h>
 #include <medPluginManager.h>
 #include <medRunnableProcess.h>
 #include <medSelectorToolBox.h>
+#include <medSelectorWorkspace.h>
 #include <medTabbedViewContainers.h>
 #include <medToolBoxFactory.h>
 #include <medUtilitiesITK.h>
@@ -43,9 +50,28 @@
 
 #include <statsROI.h>
 
+#include <QtConcurrent>
+
 class itkFiltersToolBoxPrivate
 {
 public:
+    // filters of the combo box, in their order
+    enum Filter
+    {
+        AddFilter = 0,
+        SubtractFilter,
+        MultiplyFilter,
+        DivideFilter,
+        GaussianFilter,
+        NormalizeFilter,
+        MedianFilter,
+        InvertFilter,
+        ShrinkFilter,
+        WindowingFilter,
+        ThresholdingFilter,
+        ComponentSizeThresholdFilter
+    };
+
     QWidget *addFilterWidget;
     QWidget *subtractFilterWidget;
     QWidget *multiplyFilterWidget;
@@ -96,6 +122,25 @@ public:
     QColor minColor, maxColor, thresholdColor;
     medComboBox *filters;
     dtkSmartPointer <itkFiltersProcessBase> process;
+
+    // filters streamed together by the chain mode
+    QList< dtkSmartPointer<itkFiltersProcessBase> > chain;
+    QListWidget *chainList;
+    QPushButton *addToChainButton;
+    QPushButton *runChainButton;
+
+    // filter computed on the slice displayed in the input view
+    QCheckBox *preview;
+    QTimer *previewTimer;
+    QPointer<medAbstractImageView> previewView;
+    dtkSmartPointer<medAbstractData> previewData;
+
+    // the preview is computed in the background, one at a time
+    QFutureWatcher<int> *previewWatcher;
+    bool previewPending;
+    itk::DataObject::Pointer previewImage;
+    // input the running preview is computed on
+    dtkSmartPointer<medAbstractData> previewInput;
 };
 
 itkFiltersToolBox::itkFiltersToolBox(QWidget *parent)
@@ -426,6 +471,65 @@ itkFiltersToolBox::itkFiltersToolBox(QWidget *parent)
     runButton->setFocusPolicy ( Qt::NoFocus );
     runButton->setToolTip(tr("Launch the selected filter"));
 
+    // Preview:
+    d->preview = new QCheckBox(tr("Preview on current slice"), this);
+    d->preview->setObjectName("preview");
+    d->preview->setToolTip(tr("Show the result of the filter on the slice displayed in the input view, updated when the parameters change. Run filters the whole image."));
+
+    d->previewTimer = new QTimer(this);
+    d->previewTimer->setSingleShot(true);
+    d->previewTimer->setInterval(150);
+    connect(d->previewTimer, SIGNAL(timeout()), this, SLOT(updatePreview()), Qt::UniqueConnection);
+
+    d->previewWatcher = new QFutureWatcher<int>(this);
+    d->previewPending = false;
+    connect(d->previewWatcher, SIGNAL(finished()), this, SLOT(showPreview()), Qt::UniqueConnection);
+
+    connect(d->preview,                     SIGNAL(toggled(bool)),            this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->filters,                     SIGNAL(currentIndexChanged(int)), this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->addFilterValue,              SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->subtractFilterValue,         SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->multiplyFilterValue,         SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->divideFilterValue,           SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->gaussianFilterValue,         SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->medianSizeFilterValue,       SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->shrink0Value,                SIGNAL(valueChanged(int)),        this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->shrink1Value,                SIGNAL(valueChanged(int)),        this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->shrink2Value,                SIGNAL(valueChanged(int)),        this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->intensityMinimumValue,       SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->intensityMaximumValue,       SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->intensityOutputMinimumValue, SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->intensityOutputMaximumValue, SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->thresholdFilterValue,        SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->thresholdLowerValue,         SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->thresholdUpperValue,         SIGNAL(valueChanged(double)),     this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->thresholdFilterValue2,       SIGNAL(valueChanged(int)),        this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->binaryThreshold,             SIGNAL(toggled(bool)),            this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    connect(d->valueButtonGroup,            SIGNAL(buttonClicked(int)),       this, SLOT(schedulePreview()), Qt::UniqueConnection);
+
+    // Filter chain:
+    d->addToChainButton = new QPushButton ( tr ( "Add to chain" ) );
+    d->addToChainButton->setObjectName("addToChain");
+    d->addToChainButton->setFocusPolicy ( Qt::NoFocus );
+    d->addToChainButton->setToolTip(tr("Append the selected filter, with its current parameters, to the chain"));
+
+    d->chainList = new QListWidget;
+    d->chainList->setMaximumHeight(100);
+
+    d->runChainButton = new QPushButton ( tr ( "Run chain" ) );
+    d->runChainButton->setObjectName("RunChain");
+    d->runChainButton->setFocusPolicy ( Qt::NoFocus );
+    d->runChainButton->setToolTip(tr("Launch the filters of the chain in a single pass, without intermediate images"));
+    d->runChainButton->setEnabled(false);
+
+    QPushButton *clearChainButton = new QPushButton ( tr ( "Clear chain" ) );
+    clearChainButton->setObjectName("clearChain");
+    clearChainButton->setFocusPolicy ( Qt::NoFocus );
+
+    QHBoxLayout *chainButtonsLayout = new QHBoxLayout;
+    chainButtonsLayout->addWidget ( d->runChainButton );
+    chainButtonsLayout->addWidget ( clearChainButton );
+
     // Principal layout:
     QWidget *widget = new QWidget ( this );
 
@@ -443,7 +547,11 @@ itkFiltersToolBox::itkFiltersToolBox(QWidget *parent)
     layout->addWidget ( d->intensityFilterWidget );
     layout->addWidget ( d->thresholdFilterWidget );
     layout->addWidget ( d->componentSizeThresholdFilterWidget );
+    layout->addWidget ( d->preview );
     layout->addWidget ( runButton );
+    layout->addWidget ( d->addToChainButton );
+    layout->addWidget ( d->chainList );
+    layout->addLayout ( chainButtonsLayout );
     layout->addStretch ( 1 );
 
     this->onFiltersActivated(0);
@@ -452,6 +560,9 @@ itkFiltersToolBox::itkFiltersToolBox(QWidget *parent)
     this->addWidget(widget);
 
     connect(runButton, SIGNAL(clicked()), this, SLOT(run()), Qt::UniqueConnection);
+    connect(d->addToChainButton, SIGNAL(clicked()), this, SLOT(addToChain()), Qt::UniqueConnection);
+    connect(d->runChainButton, SIGNAL(clicked()), this, SLOT(runChain()), Qt::UniqueConnection);
+    connect(clearChainButton, SIGNAL(clicked()), this, SLOT(clearChain()), Qt::UniqueConnection);
 
     if (this->selectorToolBox()) // empty in pipelines
     {
@@ -462,7 +573,9 @@ itkFiltersToolBox::itkFiltersToolBox(QWidget *parent)
 
 itkFiltersToolBox::~itkFiltersToolBox()
 {
+    d->previewWatcher->waitForFinished();
     d->process.releasePointer();
+    d->chain.clear();
     
     delete d;
     d = nullptr;
@@ -507,10 +620,14 @@ void itkFiltersToolBox::clear()
     d->thresholdColor = Qt::black;
     d->minValueImage = d->maxValueImage = 0.;
     d->process = nullptr;
+    hidePreview();
 }
 
 void itkFiltersToolBox::update()
 {
+    // the preview of the previous input is not a result of the new one
+    hidePreview();
+
     medAbstractData *data = this->selectorToolBox()->data();
     if (!data)
     {
@@ -717,59 +834,64 @@ void itkFiltersToolBox::setupItkComponentSizeThresholdProcess()
     d->process->setParameter(static_cast<int>(d->binaryComponentThreshold->isChecked()), 2);
 }
 
-void itkFiltersToolBox::run()
+void itkFiltersToolBox::setupProcess()
 {
-    if ( !this->selectorToolBox() )
-    {
-        return;
-    }
-    if ( !this->selectorToolBox()->data() )
-    {
-        return;
-    }
-
     //Set parameters :
     //   channel 0 : filter type
     //   channel 1,2,..,N : filter parameters
     switch ( d->filters->currentIndex() )
     {
-        case 0: // add filter
+        case itkFiltersToolBoxPrivate::AddFilter:
             this->setupItkAddProcess();
             break;
-        case 1: // subtract filter
+        case itkFiltersToolBoxPrivate::SubtractFilter:
             this->setupItkSubtractProcess();
             break;
-        case 2: // multiply filter
+        case itkFiltersToolBoxPrivate::MultiplyFilter:
             this->setupItkMultiplyProcess();
             break;
-        case 3: // divide filter
+        case itkFiltersToolBoxPrivate::DivideFilter:
             this->setupItkDivideProcess();
             break;
-        case 4: // gaussian filter
+        case itkFiltersToolBoxPrivate::GaussianFilter:
             this->setupItkGaussianProcess();
             break;
-        case 5: // normalize filter
+        case itkFiltersToolBoxPrivate::NormalizeFilter:
             this->setupItkNormalizeProcess();
             break;
-        case 6: // median filter
+        case itkFiltersToolBoxPrivate::MedianFilter:
             this->setupItkMedianProcess();
             break;
-        case 7: // invert intensity filter
+        case itkFiltersToolBoxPrivate::InvertFilter:
             this->setupItkInvertProcess();
             break;
-        case 8: // shrink filter
+        case itkFiltersToolBoxPrivate::ShrinkFilter:
             this->setupItkShrinkProcess();
             break;
-        case 9: // intensity windowing filter
+        case itkFiltersToolBoxPrivate::WindowingFilter:
             this->setupItkWindowingProcess();
             break;
-        case 10: // intensity windowing filter
+        case itkFiltersToolBoxPrivate::ThresholdingFilter:
             this->setupItkThresholdingProcess();
             break;
-        case 11: // size thresholding filter
+        case itkFiltersToolBoxPrivate::ComponentSizeThresholdFilter:
             this->setupItkComponentSizeThresholdProcess();
             break;
     }
+}
+
+void itkFiltersToolBox::run()
+{
+    if ( !this->selectorToolBox() )
+    {
+        return;
+    }
+    if ( !this->selectorToolBox()->data() )
+    {
+        return;
+    }
+
+    this->setupProcess();
 
     if (d->process)
     {
@@ -781,6 +903,276 @@ void itkFiltersToolBox::run()
     }
 }
 
+void itkFiltersToolBox::addToChain()
+{
+    if ( !this->selectorToolBox() || !this->selectorToolBox()->data() )
+    {
+        return;
+    }
+
+    this->setupProcess();
+
+    if (d->process)
+    {
+        d->chain.append(d->process);
+        d->chainList->addItem(d->filters->currentText());
+        d->runChainButton->setEnabled(true);
+    }
+    d->process = nullptr;
+}
+
+void itkFiltersToolBox::runChain()
+{
+    if ( !this->selectorToolBox() || !this->selectorToolBox()->data() || d->chain.isEmpty() )
+    {
+        return;
+    }
+
+    dtkSmartPointer<itkFiltersChainProcess> chainProcess = dtkAbstractProcessFactory::instance()->createSmartPointer ( "itkChainProcess" );
+    if ( !chainProcess )
+    {
+        return;
+    }
+    chainProcess->setInput(this->selectorToolBox()->data());
+    for (dtkSmartPointer<itkFiltersProcessBase> process : d->chain)
+    {
+        chainProcess->appendProcess(process);
+    }
+    d->process = chainProcess.data();
+
+    this->setToolBoxOnWaitStatus();
+
+    medRunnableProcess *runProcess = new medRunnableProcess;
+    runProcess->setProcess ( d->process );
+    this->addConnectionsAndStartJob(runProcess);
+}
+
+void itkFiltersToolBox::clearChain()
+{
+    d->chain.clear();
+    d->chainList->clear();
+    d->runChainButton->setEnabled(false);
+}
+
+void itkFiltersToolBox::schedulePreview()
+{
+    if ( d->preview->isChecked() && d->preview->isEnabled() )
+    {
+        d->previewTimer->start();
+    }
+    else
+    {
+        hidePreview();
+    }
+}
+
+void itkFiltersToolBox::hidePreview()
+{
+    d->previewTimer->stop();
+    d->previewPending = false;
+
+    medSelectorWorkspace *workspace = dynamic_cast<medSelectorWorkspace*>(getWorkspace());
+    if ( workspace && d->previewData )
+    {
+        workspace->hideProcessPreview();
+    }
+    d->previewData = nullptr;
+}
+
+void itkFiltersToolBox::updatePreview()
+{
+    if ( !d->preview->isChecked() || !this->selectorToolBox() || !this->selectorToolBox()->data() )
+    {
+        return;
+    }
+
+    // a single preview at a time, the latest parameters are previewed after it
+    if ( d->previewWatcher->isRunning() )
+    {
+        d->previewPending = true;
+        return;
+    }
+
+    medSelectorWorkspace *workspace = dynamic_cast<medSelectorWorkspace*>(getWorkspace());
+    medAbstractImageView *view = workspace ? dynamic_cast<medAbstractImageView*>(workspace->inputView()) : nullptr;
+    if ( !view )
+    {
+        return;
+    }
+
+    // follow the slice browsed in the input view
+    if ( view != d->previewView )
+    {
+        d->previewView = view;
+        connect(view->positionBeingViewedParameter(), SIGNAL(valueChanged(QVector3D)), this, SLOT(schedulePreview()), Qt::UniqueConnection);
+        connect(view, SIGNAL(orientationChanged()), this, SLOT(schedulePreview()), Qt::UniqueConnection);
+    }
+
+    // keep the process of the last run, whose output may not be imported yet
+    dtkSmartPointer<itkFiltersProcessBase> runProcess = d->process;
+    this->setupProcess();
+    dtkSmartPointer<itkFiltersProcessBase> process = d->process;
+    d->process = runProcess;
+    if ( !process )
+    {
+        return;
+    }
+
+    dtkSmartPointer<medAbstractData> data = this->selectorToolBox()->data();
+    d->previewInput = data;
+    QVector3D position = view->positionBeingViewedParameter()->value();
+    QVector3D normal = view->viewPlaneNormal();
+
+    d->previewWatcher->setFuture(QtConcurrent::run([this, data, process, position, normal]()
+    {
+        return DISPATCH_ON_3D_PIXEL_TYPE(&itkFiltersToolBox::computePreview, this, data.data(), process.data(), position, normal);
+    }));
+}
+
+void itkFiltersToolBox::showPreview()
+{
+    itk::DataObject::Pointer image = d->previewImage;
+    d->previewImage = nullptr;
+    dtkSmartPointer<medAbstractData> input = d->previewInput;
+    d->previewInput = nullptr;
+
+    if ( d->previewPending )
+    {
+        d->previewPending = false;
+        updatePreview();
+        return;
+    }
+
+    medSelectorWorkspace *workspace = dynamic_cast<medSelectorWorkspace*>(getWorkspace());
+    if ( !image || !workspace || !d->preview->isChecked() || !d->preview->isEnabled()
+         || !this->selectorToolBox()->data() || this->selectorToolBox()->data() != input
+         || d->previewWatcher->result() != medAbstractProcessLegacy::SUCCESS )
+    {
+        return;
+    }
+
+    d->previewData = medAbstractDataFactory::instance()->createSmartPointer(this->selectorToolBox()->data()->identifier());
+    if ( d->previewData )
+    {
+        d->previewData->setData(image);
+        d->previewData->setMetaData(medMetaDataKeys::SeriesDescription.key(), tr("Preview of ") + d->filters->currentText());
+        workspace->showProcessPreview(d->previewData);
+    }
+}
+
+/**
+ * Runs the filter of the process on the slice of the image under the
+ * position viewed, in a worker thread. ITK enlarges the region read from the
+ * input by the neighborhood the filter needs; filters that would read their
+ * whole input only get a slab around the slice.
+ */
+template <typename ImageType>
+int itkFiltersToolBox::computePreview(medAbstractData *data, itkFiltersProcessBase *process, QVector3D position, QVector3D normal)
+{
+    ImageType *input = static_cast<ImageType*>(data->data());
+
+    typename ImageType::PointType point;
+    point[0] = position.x();
+    point[1] = position.y();
+    point[2] = position.z();
+    typename ImageType::IndexType index;
+    input->TransformPhysicalPointToIndex(point, index);
+
+    // the slice is across the image axis closest to the view normal
+    const typename ImageType::DirectionType &direction = input->GetDirection();
+    unsigned int axis = 0;
+    double bestAlignment = -1;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        double alignment = std::abs(direction[0][i] * normal.x() + direction[1][i] * normal.y() + direction[2][i] * normal.z());
+        if (alignment > bestAlignment)
+        {
+            bestAlignment = alignment;
+            axis = i;
+        }
+    }
+
+    typename ImageType::RegionType largestRegion = input->GetLargestPossibleRegion();
+    if ( index[axis] < largestRegion.GetIndex(axis) ||
+         index[axis] >= largestRegion.GetIndex(axis) + static_cast<itk::IndexValueType>(largestRegion.GetSize(axis)) )
+    {
+        return medAbstractProcessLegacy::FAILURE;
+    }
+
+    dtkSmartPointer<medAbstractData> filteredData = data;
+    if ( !process->isStreamable() )
+    {
+        typename ImageType::RegionType slab = largestRegion;
+        itk::IndexValueType margin = static_cast<itk::IndexValueType>(std::ceil(process->kernelRadius() / input->GetSpacing()[axis]));
+        slab.SetIndex(axis, index[axis] - margin);
+        slab.SetSize(axis, 2 * margin + 1);
+        slab.Crop(largestRegion);
+
+        typedef itk::ExtractImageFilter<ImageType, ImageType> ExtractFilterType;
+        typename ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+        extractFilter->SetInput(input);
+        extractFilter->SetExtractionRegion(slab);
+        extractFilter->Update();
+
+        filteredData = medAbstractDataFactory::instance()->createSmartPointer(data->identifier());
+        if ( !filteredData )
+        {
+            return medAbstractProcessLegacy::FAILURE;
+        }
+        filteredData->setData(extractFilter->GetOutput());
+    }
+
+    QList<itk::ProcessObject::Pointer> pipeline;
+    if ( process->appendToPipeline(filteredData.data(), &pipeline) != medAbstractProcessLegacy::SUCCESS )
+    {
+        return medAbstractProcessLegacy::FAILURE;
+    }
+
+    ImageType *output = dynamic_cast<ImageType*>(pipeline.last()->GetPrimaryOutput());
+    output->UpdateOutputInformation();
+
+    // the output may be resampled (shrink), the slice is located again in its grid
+    output->TransformPhysicalPointToIndex(point, index);
+    typename ImageType::RegionType region = output->GetLargestPossibleRegion();
+    if ( index[axis] < region.GetIndex(axis) ||
+         index[axis] >= region.GetIndex(axis) + static_cast<itk::IndexValueType>(region.GetSize(axis)) )
+    {
+        return medAbstractProcessLegacy::FAILURE;
+    }
+    region.SetIndex(axis, index[axis]);
+    region.SetSize(axis, 1);
+
+    for (itk::ProcessObject::Pointer filter : pipeline)
+    {
+        itkFiltersProcessBase::setWorkUnits(filter);
+    }
+    output->SetRequestedRegion(region);
+    output->Update();
+
+    // copy to an image of its own, located at the slice
+    typename ImageType::Pointer slice = ImageType::New();
+    typename ImageType::RegionType sliceRegion;
+    sliceRegion.SetSize(region.GetSize());
+    typename ImageType::PointType origin;
+    output->TransformIndexToPhysicalPoint(region.GetIndex(), origin);
+    slice->SetRegions(sliceRegion);
+    slice->SetOrigin(origin);
+    slice->SetSpacing(output->GetSpacing());
+    slice->SetDirection(output->GetDirection());
+    slice->Allocate();
+
+    itk::ImageRegionConstIterator<ImageType> source(output, region);
+    itk::ImageRegionIterator<ImageType> target(slice, sliceRegion);
+    for (; !source.IsAtEnd(); ++source, ++target)
+    {
+        target.Set(source.Get());
+    }
+
+    d->previewImage = slice;
+
+    return medAbstractProcessLegacy::SUCCESS;
+}
+
 void itkFiltersToolBox::updateClutEditorValue(int label)
 {
     if ( d->clutEditor != nullptr )
@@ -1048,46 +1440,54 @@ void itkFiltersToolBox::onFiltersActivated ( int index )
 
     switch ( index )
     {
-        case 0:
+        case itkFiltersToolBoxPrivate::AddFilter:
             d->addFilterWidget->show();
             break;
-        case 1:
+        case itkFiltersToolBoxPrivate::SubtractFilter:
             d->subtractFilterWidget->show();
             break;
-        case 2:
+        case itkFiltersToolBoxPrivate::MultiplyFilter:
             d->multiplyFilterWidget->show();
             break;
-        case 3:
+        case itkFiltersToolBoxPrivate::DivideFilter:
             d->divideFilterWidget->show();
             break;
-        case 4:
+        case itkFiltersToolBoxPrivate::GaussianFilter:
             d->gaussianFilterWidget->show();
             break;
-        case 5:
+        case itkFiltersToolBoxPrivate::NormalizeFilter:
             d->normalizeFilterWidget->show();
             break;
-        case 6:
+        case itkFiltersToolBoxPrivate::MedianFilter:
             d->medianFilterWidget->show();
             break;
-        case 7:
+        case itkFiltersToolBoxPrivate::InvertFilter:
             d->invertFilterWidget->show();
             break;
-        case 8:
+        case itkFiltersToolBoxPrivate::ShrinkFilter:
             d->shrinkFilterWidget->show();
             break;
-        case 9:
+        case itkFiltersToolBoxPrivate::WindowingFilter:
             d->intensityFilterWidget->show();
             break;
-        case 10:
+        case itkFiltersToolBoxPrivate::ThresholdingFilter:
             d->thresholdFilterWidget->show();
             break;
-        case 11:
+        case itkFiltersToolBoxPrivate::ComponentSizeThresholdFilter:
             d->componentSizeThresholdFilterWidget->show();
             break;
         default:
             d->addFilterWidget->show();
     }
 
+    // normalize, invert and isolated voxels removal need their whole input at once
+    bool streamable = (index != itkFiltersToolBoxPrivate::NormalizeFilter
+                       && index != itkFiltersToolBoxPrivate::InvertFilter
+                       && index != itkFiltersToolBoxPrivate::ComponentSizeThresholdFilter);
+    d->addToChainButton->setEnabled(streamable);
+    d->preview->setEnabled(streamable);
+    schedulePreview();
+
     updateHistogramView();
 }
 
@@ -14,7 +14,11 @@
 
 #include <medAbstractSelectableToolBox.h>
 
+#include <QVector3D>
+
+class itkFiltersProcessBase;
 class itkFiltersToolBoxPrivate;
+class medAbstractImageView;
 
 /*! \brief Toolbox to apply some itk filters.
  *
@@ -36,7 +40,11 @@ class itkFiltersToolBoxPrivate;
  * "binaryThresholdButton" : QRadioButton\n
  * "componentSizeThresholdFilterValue" : QSpinBox\n
  * "histogram" : QCheckBox\n
- * "Run" : QPushButton
+ * "preview" : QCheckBox\n
+ * "Run" : QPushButton\n
+ * "addToChain" : QPushButton\n
+ * "RunChain" : QPushButton\n
+ * "clearChain" : QPushButton
  */
 class itkFiltersToolBox : public medAbstractSelectableToolBox
 {
@@ -59,6 +67,10 @@ public slots:
     void update();
     void run();
 
+    void addToChain();
+    void runChain();
+    void clearChain();
+
     void showHistogram(int state);
     void updateHistogramView();
     void updateSliders();
@@ -71,10 +83,17 @@ private slots:
     void checkBinaryThreshold(bool checked);
     void onViewClosed();
     void updateClutEditorView();
+    void schedulePreview();
+    void updatePreview();
+    void showPreview();
 
 private:
     template <typename ImageType> int setupSpinBoxValues(medAbstractData*);
 
+    void setupProcess();
+    void hidePreview();
+    template <typename ImageType> int computePreview(medAbstractData *data, itkFiltersProcessBase *process, QVector3D position, QVector3D normal);
+
     void setupItkAddProcess();
     void setupItkSubtractProcess();
     void setupItkMultiplyProcess();
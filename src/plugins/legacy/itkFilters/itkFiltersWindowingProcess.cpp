@@ -109,10 +109,8 @@ int itkFiltersWindowingProcess::tryUpdate()
 }
 
 template <class ImageType>
-int itkFiltersWindowingProcess::updateProcess(medAbstractData* inputData)
+typename itk::ImageSource<ImageType>::Pointer itkFiltersWindowingProcess::createFilter(ImageType *inputImage)
 {
-    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
-
     typedef itk::IntensityWindowingImageFilter< ImageType, ImageType >  WindowingFilterType;
     typename WindowingFilterType::Pointer windowingFilter = WindowingFilterType::New();
 
@@ -122,11 +120,21 @@ int itkFiltersWindowingProcess::updateProcess(medAbstractData* inputData)
     windowingFilter->SetOutputMinimum((typename ImageType::PixelType) d->minimumOutputIntensityValue);
     windowingFilter->SetOutputMaximum((typename ImageType::PixelType) d->maximumOutputIntensityValue);
 
+    return windowingFilter.GetPointer();
+}
+
+template <class ImageType>
+int itkFiltersWindowingProcess::updateProcess(medAbstractData *inputData)
+{
+    typename ImageType::Pointer inputImage = static_cast<ImageType*>(inputData->data());
+    typename itk::ImageSource<ImageType>::Pointer windowingFilter = createFilter<ImageType>(inputImage);
+
     itk::CStyleCommand::Pointer callback = itk::CStyleCommand::New();
     callback->SetClientData(( void * ) this);
     callback->SetCallback(itkFiltersProcessBase::eventCallback);
     windowingFilter->AddObserver(itk::ProgressEvent(), callback);
 
+    setWorkUnits(windowingFilter);
     windowingFilter->Update();
 
     getOutputData()->setData(windowingFilter->GetOutput());
@@ -139,6 +147,11 @@ int itkFiltersWindowingProcess::updateProcess(medAbstractData* inputData)
     return medAbstractProcessLegacy::SUCCESS;
 }
 
+int itkFiltersWindowingProcess::appendToPipeline(medAbstractData *inputData, QList<itk::ProcessObject::Pointer> *pipeline)
+{
+    return appendCreatedFilter<itkFiltersWindowingProcess>(inputData, pipeline);
+}
+
 // /////////////////////////////////////////////////////////////////
 // Type instanciation
 // /////////////////////////////////////////////////////////////////
@@ -137,6 +137,7 @@ int itkMorphologicalFiltersProcessBase::updateProcess(medAbstractData *inputData
     typedef itk::MinimumMaximumImageFilter <ImageType> ImageCalculatorFilterType;
     typename ImageCalculatorFilterType::Pointer imageCalculatorFilter = ImageCalculatorFilterType::New();
     imageCalculatorFilter->SetInput(inputImage);
+    setWorkUnits(imageCalculatorFilter);
     imageCalculatorFilter->Update();
 
     typedef itk::KernelImageFilter< ImageType, ImageType, StructuringElementType >  FilterType;
@@ -207,6 +208,7 @@ int itkMorphologicalFiltersProcessBase::updateProcess(medAbstractData *inputData
     callback->SetCallback ( itkFiltersProcessBase::eventCallback );
     filter->AddObserver ( itk::ProgressEvent(), callback );
 
+    setWorkUnits(filter);
     filter->Update();
 
     getOutputData()->setData ( filter->GetOutput() );
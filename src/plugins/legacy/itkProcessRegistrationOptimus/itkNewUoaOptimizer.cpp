@@ -14,6 +14,8 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <exception>
+#include <thread>
 
 #include "itkNewUoaOptimizer.h"
 
@@ -113,6 +115,7 @@ NewUoaOptimizer
 
 
     // Start optimization process
+    m_InitialValues.clear();
     this->newuoa(w, &n, &npt, &x[1], &rhobeg, &rhoend, &iprint, &max_function_calls);
 
 
@@ -148,7 +151,8 @@ NewUoaOptimizer
   /*long int s_wsfe(cilist *), e_wsfe(void);*/
 		
   /* Local variables */
-  static long int id, np, iw, igq, ihq, ixb, ifv, ipq, ivl, ixn, ixo, ixp, 
+  /* The locals are not static, several optimizers may run at once */
+  long int id, np, iw, igq, ihq, ixb, ifv, ipq, ivl, ixn, ixo, ixp, 
 	 ndim, nptm, ibmat, izmat; // i; //-FD Apparemment i est inutilise
 		
   /* Fortran I/O blocks */
@@ -267,35 +271,35 @@ NewUoaOptimizer
   /*long int s_wsfe(cilist *), e_wsfe(void), do_fio(long int *, char *, ftnlen);*/
 	
   /* Local variables */
-  static double f;
-  static long int i__, j, k, ih, nf, nh, ip, jp;
+  double f;
+  long int i__, j, k, ih, nf, nh, ip, jp;
   //  static  long int size, size2, bsize; 
-  static double dx;
-  static long int np, nfm;
-  static double one;
-  static long int idz;
-  static double dsq, rho;
-  static long int ipt, jpt;
-  static double sum, fbeg, diff, half, beta;
-  static long int nfmm;
-  static double gisq;
-  static long int knew;
-  static double temp, suma, sumb, fopt, bsum, gqsq;
-  static long int kopt, nptm;
-  static double zero, xipt, xjpt, sumz, diffa, diffb, diffc, hdiag, 
+  double dx;
+  long int np, nfm;
+  double one;
+  long int idz;
+  double dsq, rho;
+  long int ipt, jpt;
+  double sum, fbeg, diff, half, beta;
+  long int nfmm;
+  double gisq;
+  long int knew;
+  double temp, suma, sumb, fopt, bsum, gqsq;
+  long int kopt, nptm;
+  double zero, xipt, xjpt, sumz, diffa, diffb, diffc, hdiag, 
 	 alpha, delta, recip, reciq, fsave;
-  static long int ksave, nfsav, itemp;
-  static double dnorm, ratio, dstep, tenth, vquad;
-  static long int ktemp;
-  static double tempq;
-  static long int itest;
-  static double rhosq;
+  long int ksave, nfsav, itemp;
+  double dnorm, ratio, dstep, tenth, vquad;
+  long int ktemp;
+  double tempq;
+  long int itest;
+  double rhosq;
 			
-  static double detrat, crvmin;
-  static long int nftest;
-  static double distsq;
+  double detrat, crvmin;
+  long int nftest;
+  double distsq;
 		
-  static double xoptsq; 
+  double xoptsq; 
   NewUoaOptimizer::ParametersType xCoord( m_SpaceDimension );
 
 
@@ -447,6 +451,12 @@ NewUoaOptimizer
 	 x[j] = xpt[nf + j * xpt_dim1] + xbase[j];
   }
 
+  /*     The first 2N+1 points do not depend on the values of F, the next */
+  /*     ones only on these values: they are evaluated by batches. */
+  if (nf == 1 || nfm == (*n << 1) + 1) {
+	 this->EvaluateInitialPoints(*n, *npt, nf, &xbase[1], *rhobeg, nftest);
+  }
+
   goto L310;
   // 		if (nf > nftest) 
   // 		{
@@ -816,7 +826,11 @@ NewUoaOptimizer
 	 
 
 
-  f = (double) this->m_CostFunction->GetValue(xCoord);
+  if (nf <= (long int) m_InitialValues.size()) {
+	 f = m_InitialValues[nf - 1];
+  } else {
+	 f = (double) this->m_CostFunction->GetValue(xCoord);
+  }
   if (*iprint == 3) {
 	 /*s_wsfe(&io___56);
 		do_fio(&c__1, (char *)&nf, (ftnlen)sizeof(long int));
@@ -1257,15 +1271,15 @@ NewUoaOptimizer
   //     double atan(double), sqrt(double), cos(double), sin(  double);
 
   /* Local variables */
-  static long int i__, j, k;
-  static double dd, gg;
-  static long int iu;
-  static double sp, ss, cf1, cf2, cf3, cf4, cf5, dhd, cth, one, tau, 
+  long int i__, j, k;
+  double dd, gg;
+  long int iu;
+  double sp, ss, cf1, cf2, cf3, cf4, cf5, dhd, cth, one, tau, 
 	 sth, sum, half, temp, step;
-  static long int nptm;
-  static double zero, angle, scale, denom;
-  static long int iterc, isave;
-  static double delsq, tempa, tempb, twopi, taubeg, tauold, taumax;
+  long int nptm;
+  double zero, angle, scale, denom;
+  long int iterc, isave;
+  double delsq, tempa, tempb, twopi, taubeg, tauold, taumax;
 		
 		
   /*     N is the number of variables. */
@@ -1550,21 +1564,21 @@ NewUoaOptimizer
   // 		double atan(double), sqrt(double), cos(double), sin(double);
 		
   /* Local variables */
-  static long int i__, j, k;
-  static double dd;
-  static long int jc;
-  static double ds;
-  static long int ip, iu, nw;
-  static double ss, den[9], one, par[9], tau, sum, two, diff, half, 
+  long int i__, j, k;
+  double dd;
+  long int jc;
+  double ds;
+  long int ip, iu, nw;
+  double ss, den[9], one, par[9], tau, sum, two, diff, half, 
 	 temp;
-  static long int ksav;
-  static double step;
-  static long int nptm;
-  static double zero, alpha, angle, denex[9];
-  static long int iterc;
-  static double tempa, tempb, tempc;
-  static long int isave;
-  static double ssden, dtest, quart, xoptd, twopi, xopts, denold, denmax, densav, dstemp, sumold, sstemp, xoptsq;
+  long int ksav;
+  double step;
+  long int nptm;
+  double zero, alpha, angle, denex[9];
+  long int iterc;
+  double tempa, tempb, tempc;
+  long int isave;
+  double ssden, dtest, quart, xoptd, twopi, xopts, denold, denmax, densav, dstemp, sumold, sstemp, xoptsq;
 
 
   /*     N is the number of variables. */
@@ -2064,12 +2078,12 @@ NewUoaOptimizer
   // 		double sqrt(double);
 		
   /* Local variables */
-  static long int i__, j, ja, jb, jl, jp;
-  static double one, tau, temp;
-  static long int nptm;
-  static double zero;
-  static long int iflag;
-  static double scala, scalb, alpha, denom, tempa, tempb, tausq;
+  long int i__, j, ja, jb, jl, jp;
+  double one, tau, temp;
+  long int nptm;
+  double zero;
+  long int iflag;
+  double scala, scalb, alpha, denom, tempa, tempb, tausq;
 
 
   /*     The arrays BMAT and ZMAT with IDZ are updated, in order to shift the */
@@ -2253,20 +2267,20 @@ NewUoaOptimizer
   double d__1, d__2;
 		
   /* Local variables */
-  static long int i__, j, k;
-  static double dd, cf, dg, gg;
-  static long int ih;
-  static double ds, sg;
-  static long int iu;
-  static double ss, dhd, dhs, cth, sgk, shs, sth, qadd, half, qbeg, 
+  long int i__, j, k;
+  double dd, cf, dg, gg;
+  long int ih;
+  double ds, sg;
+  long int iu;
+  double ss, dhd, dhs, cth, sgk, shs, sth, qadd, half, qbeg, 
 	 qred, qmin, temp, qsav, qnew, zero, ggbeg, alpha, angle, reduc;
-  static long int iterc;
-  static double ggsav, delsq, tempa, tempb;
-  static long int isave;
-  static double bstep, ratio, twopi;
-  static long int itersw;
-  static double angtest;
-  static long int itermax;
+  long int iterc;
+  double ggsav, delsq, tempa, tempb;
+  long int isave;
+  double bstep, ratio, twopi;
+  long int itersw;
+  double angtest;
+  long int itermax;
 		
 		
   /*     N is the number of variables of a quadratic objective function, Q say. */
@@ -2585,6 +2599,122 @@ NewUoaOptimizer
 } 
 
 
+void
+NewUoaOptimizer
+::SetCostFunctionCopies(const CostFunctionListType &copies)
+{
+  m_CostFunctionCopies = copies;
+  this->Modified();
+}
+
+
+const NewUoaOptimizer::CostFunctionListType &
+NewUoaOptimizer
+::GetCostFunctionCopies() const
+{
+  return m_CostFunctionCopies;
+}
+
+
+void
+NewUoaOptimizer
+::ToParameters(const double *x, ParametersType &parameters) const
+{
+  parameters.SetSize(m_SpaceDimension);
+  for (unsigned int i = 0; i < m_SpaceDimension; i++)
+  {
+      parameters[i] = x[i];
+      if(i>=3)
+          parameters[i] *= m_ScaleTranslation;
+  }
+}
+
+
+void
+NewUoaOptimizer
+::EvaluateInitialPoints(long int n, long int npt, long int first, const double *xbase,
+                        double rhobeg, long int maxfun)
+{
+    // Same points as the initialization procedure of newuob, numbered from 1
+    long int last = (first == 1) ? std::min(npt, 2 * n + 1) : npt;
+    last = std::min(last, maxfun);
+    if (last < first)
+        return;
+
+    std::vector<ParametersType> points(last - first + 1);
+    std::vector<double> x(n);
+    for (long int nf = first; nf <= last; nf++)
+    {
+        const long int nfm = nf - 1;
+        const long int nfmm = nfm - n;
+        std::vector<double> displacement(n, 0.0);
+        if (nfm <= 2 * n)
+        {
+            if (nfm >= 1 && nfm <= n)
+                displacement[nfm - 1] = rhobeg;
+            else if (nfm > n)
+                displacement[nfmm - 1] = -rhobeg;
+        }
+        else
+        {
+            long int itemp = (nfmm - 1) / n;
+            long int jpt = nfm - itemp * n - n;
+            long int ipt = jpt + itemp;
+            if (ipt > n)
+            {
+                itemp = jpt;
+                jpt = ipt - n;
+                ipt = itemp;
+            }
+            // values at xbase + rhobeg e_i and xbase - rhobeg e_i
+            const double xipt = (m_InitialValues[ipt + n] < m_InitialValues[ipt]) ? -rhobeg : rhobeg;
+            const double xjpt = (m_InitialValues[jpt + n] < m_InitialValues[jpt]) ? -rhobeg : rhobeg;
+            displacement[ipt - 1] = xipt;
+            displacement[jpt - 1] = xjpt;
+        }
+
+        for (long int j = 0; j < n; j++)
+            x[j] = displacement[j] + xbase[j];
+        this->ToParameters(x.data(), points[nf - first]);
+    }
+
+    // Point i is evaluated by the cost function i modulo their number, the
+    // values do not depend on the number of threads.
+    const size_t functionCount = std::min(m_CostFunctionCopies.size() + 1, points.size());
+    std::vector<double> values(points.size());
+    std::vector<std::exception_ptr> errors(functionCount);
+    auto evaluate = [&](size_t function)
+    {
+        const CostFunctionType *costFunction = (function == 0) ? this->m_CostFunction.GetPointer()
+                                                               : m_CostFunctionCopies[function - 1].GetPointer();
+        try
+        {
+            for (size_t i = function; i < points.size(); i += functionCount)
+                values[i] = (double) costFunction->GetValue(points[i]);
+        }
+        catch (...)
+        {
+            errors[function] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t function = 1; function < functionCount; function++)
+        threads.emplace_back(evaluate, function);
+    evaluate(0);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    for (const std::exception_ptr &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    m_InitialValues.insert(m_InitialValues.end(), values.begin(), values.end());
+}
+
+
 void
 NewUoaOptimizer
 ::PrintSelf( std::ostream &os, Indent indent ) const 
@@ -14,6 +14,8 @@
 
 #include "itkSingleValuedNonLinearOptimizer.h"
 
+#include <vector>
+
 
 namespace itk {
 
@@ -28,6 +30,8 @@ class ITK_EXPORT NewUoaOptimizer : public SingleValuedNonLinearOptimizer
   typedef SmartPointer<const Self>                                  ConstPointer;
 
   typedef SingleValuedNonLinearOptimizer::ParametersType             ParametersType;
+  typedef SingleValuedNonLinearOptimizer::CostFunctionType           CostFunctionType;
+  typedef std::vector<CostFunctionType::Pointer>                     CostFunctionListType;
 
   /* Method for creation through the object factory */
   itkNewMacro(Self) ;
@@ -64,6 +68,12 @@ class ITK_EXPORT NewUoaOptimizer : public SingleValuedNonLinearOptimizer
   itkSetMacro( ScaleTranslation, double);
   itkGetConstReferenceMacro( ScaleTranslation, double);
 
+  /* Set/Get copies of the cost function, giving the same values. The initial
+     interpolation points, which do not depend on each other, are evaluated
+     concurrently by the cost function and its copies, one thread each. */
+  void SetCostFunctionCopies(const CostFunctionListType &copies);
+  const CostFunctionListType &GetCostFunctionCopies() const;
+
   /* Start the optimizer */
   void StartOptimization();
   
@@ -102,6 +112,13 @@ class ITK_EXPORT NewUoaOptimizer : public SingleValuedNonLinearOptimizer
 				 double *, double *, double *, double *, 
 				 double *, double *, double *);
 
+  // Evaluates the initial interpolation points from first to the end of its batch
+  void EvaluateInitialPoints(long int n, long int npt, long int first, const double *xbase,
+                             double rhobeg, long int maxfun);
+
+  // Parameters of the cost function at x, the translation being scaled
+  void ToParameters(const double *x, ParametersType &parameters) const;
+
  private:
   NewUoaOptimizer(const Self&);  // Purposely not implemented
   void operator=(const Self&)  ; // Purposely not implemented
@@ -128,6 +145,12 @@ class ITK_EXPORT NewUoaOptimizer : public SingleValuedNonLinearOptimizer
   /* Scaling on the translation (x,y,z). */
   double                      m_ScaleTranslation;
 
+  /* Copies of the cost function used along with it. */
+  CostFunctionListType        m_CostFunctionCopies;
+
+  /* Values at the initial interpolation points evaluated so far. */
+  std::vector<double>         m_InitialValues;
+
 
 
 } ; // end of class
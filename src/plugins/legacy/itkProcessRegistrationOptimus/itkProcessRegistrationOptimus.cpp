@@ -186,6 +186,11 @@ template <typename PixelType>
     registration->SetRhoStart(rhoStart);
     registration->SetRhoEnd(rhoEnd);
     registration->SetScalingCoefficient(scalingCoefficient);
+    if (proc->workUnits() > 0)
+    {
+        // a frame of a 4D image, the metric evaluations share the threads with the other frames
+        registration->SetNumberOfConcurrentEvaluations(proc->workUnits());
+    }
 
     // Run the registration
     time_t t1 = clock();
@@ -213,6 +218,10 @@ template <typename PixelType>
     resampler->SetOutputSpacing( proc->fixedImage()->GetSpacing() );
     resampler->SetOutputDirection( proc->fixedImage()->GetDirection() );
     resampler->SetDefaultPixelValue( 0 );
+    if (proc->workUnits() > 0)
+    {
+        resampler->SetNumberOfWorkUnits( proc->workUnits() );
+    }
 
     try {
         resampler->Update();
@@ -300,6 +309,20 @@ itk::Transform<double,3,3>::Pointer itkProcessRegistrationOptimus::getTransform(
     return nullptr;
 }
 
+bool itkProcessRegistrationOptimus::supportsFrameRegistration() const
+{
+    return true;
+}
+
+itkProcessRegistration *itkProcessRegistrationOptimus::createFrameRegistration()
+{
+    itkProcessRegistrationOptimus *frame = new itkProcessRegistrationOptimus;
+    *frame->d = *d;
+    frame->d->proc = frame;
+    frame->d->registrationMethod = NULL;
+    return frame;
+}
+
 QString itkProcessRegistrationOptimus::getTitleAndParameters(){
     
     typedef float PixelType;
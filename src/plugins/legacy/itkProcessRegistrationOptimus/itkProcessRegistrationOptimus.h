@@ -48,6 +48,8 @@ public:
 //    bool write(const QString& file);
 protected :
     virtual bool writeTransform(const QString& file);
+    virtual bool supportsFrameRegistration() const;
+    virtual itkProcessRegistration *createFrameRegistration();
 
 private:
     itkProcessRegistrationOptimusPrivate *d;
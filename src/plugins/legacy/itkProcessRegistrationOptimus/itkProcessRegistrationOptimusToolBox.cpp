@@ -37,6 +37,7 @@ public:
     QSpinBox * binsBox;
     QSpinBox * samplesBox;
     QSpinBox * interpolationsBox;
+    QSpinBox * referenceFrameBox;
     QDoubleSpinBox * rhoStartBox;
     QDoubleSpinBox * rhoEndBox;
     QDoubleSpinBox * scalingCoeffBox;
@@ -114,6 +115,13 @@ itkProcessRegistrationOptimusToolBox::itkProcessRegistrationOptimusToolBox(QWidg
     d->scalingCoeffBox->setValue(50.0);
     d->scalingCoeffBox->setToolTip(tr("Scaling coefficient"));
 
+    d->referenceFrameBox = new QSpinBox(widget);
+    d->referenceFrameBox->setMinimum(-1);
+    d->referenceFrameBox->setMaximum(9999);
+    d->referenceFrameBox->setValue(-1);
+    d->referenceFrameBox->setSpecialValueText(tr("Fixed image"));
+    d->referenceFrameBox->setToolTip(tr("Frame of a 4D moving image the other frames are registered to"));
+
     this->setTitle(tr("Optimus"));
     layout->addRow(new QLabel(tr("Max. number of iterations"),widget),
                    d->iterationsBox);
@@ -129,6 +137,7 @@ itkProcessRegistrationOptimusToolBox::itkProcessRegistrationOptimusToolBox(QWidg
     layout->addRow(new QLabel(tr("Rho end"),widget),d->rhoEndBox);
     layout->addRow(new QLabel(tr("Scaling coefficient"),widget),
                    d->scalingCoeffBox);
+    layout->addRow(new QLabel(tr("4D Reference Frame"),widget),d->referenceFrameBox);
 
 
     this->addWidget(widget);
@@ -210,6 +219,7 @@ void itkProcessRegistrationOptimusToolBox::run(void)
         process_Registration->setRhoEnd(d->rhoEndBox->value());
         process_Registration->setRhoStart(d->rhoStartBox->value());
         process_Registration->setScalingCoefficient(d->scalingCoeffBox->value());
+        process_Registration->setReferenceFrame(d->referenceFrameBox->value());
 
 
         // process->setMyWonderfullParameter(fronTheGui);
@@ -233,7 +243,7 @@ void itkProcessRegistrationOptimusToolBox::run(void)
 
         medJobManagerL::instance()->registerJobItem(runProcess, d->process->identifier());
 
-        addConnectionsAndStartJob(runProcess);
+        addConnectionsAndStartJob(runProcess, medJobScheduler::HeavyProcessJob);
         enableOnProcessSuccessImportOutput(runProcess, false);
     }
 }
@@ -85,6 +85,11 @@ protected:
      */
     float                m_scalingCoefficient;
 
+    /**
+     * Number of metric evaluations run at once.
+     */
+    unsigned int         m_concurrentEvaluations;
+
     /**
      * Initial transformation.
      */
@@ -216,6 +221,21 @@ public:
     void                 SetScalingCoefficient(float value);
 
 
+    /**
+     * Gets the number of metric evaluations run at once.
+     * @return  number of concurrent evaluations, 0 for the number of threads
+     */
+    unsigned int         GetNumberOfConcurrentEvaluations(void) const;
+
+
+    /**
+     * Sets the number of metric evaluations run at once, each one with its own
+     * copy of the metric. The result does not depend on this number.
+     * @param  value  number of concurrent evaluations, 0 for the number of threads
+     */
+    void                 SetNumberOfConcurrentEvaluations(unsigned int value);
+
+
     /**
      * Performs the image registration.
      */
@@ -17,6 +17,9 @@
 #include <itkCenteredTransformInitializer.h>
 #include <itkLinearInterpolateImageFunction.h>
 #include <itkNewUoaOptimizer.h>
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
 
 //#include "rpiOptimus.hxx"
 
@@ -38,6 +41,7 @@ Optimus< TFixedImage, TMovingImage, TTransformScalarType >
     this->m_rhoStart           = 0.6;
     this->m_rhoEnd             = 0.003;
     this->m_scalingCoefficient = 20.0;
+    this->m_concurrentEvaluations = 0;
 
     // Initialize the transformations
     this->m_transform          = TransformType::New();
@@ -214,6 +218,26 @@ Optimus< TFixedImage, TMovingImage, TTransformScalarType >
 
 
 
+template < class TFixedImage, class TMovingImage, class TTransformScalarType >
+unsigned int
+Optimus< TFixedImage, TMovingImage, TTransformScalarType >
+::GetNumberOfConcurrentEvaluations() const
+{
+    return this->m_concurrentEvaluations;
+}
+
+
+
+template < class TFixedImage, class TMovingImage, class TTransformScalarType >
+void
+Optimus< TFixedImage, TMovingImage, TTransformScalarType >
+::SetNumberOfConcurrentEvaluations(unsigned int value)
+{
+    this->m_concurrentEvaluations = value;
+}
+
+
+
 template < class TFixedImage, class TMovingImage, class TTransformScalarType >
 void
 Optimus< TFixedImage, TMovingImage, TTransformScalarType >
@@ -284,9 +308,56 @@ Optimus< TFixedImage, TMovingImage, TTransformScalarType >
     registration->SetInitialTransformParameters( transform->GetParameters() );
 
 
-    // Initialize the metric
+    // Initialize the metric. The samples and the way they are split between
+    // threads are fixed, so that the values do not depend on the machine.
+    // The registration passes its own work units to the metric when it is
+    // initialized, so it is given the same number.
+    const int          metricSeed      = 121212;
+    const unsigned int metricWorkUnits = 16;
     metric->SetNumberOfHistogramBins(  this->m_histogramBins );
     metric->SetNumberOfSpatialSamples( this->m_spatialSamples );
+    metric->SetNumberOfWorkUnits(      metricWorkUnits );
+    registration->SetNumberOfWorkUnits( metricWorkUnits );
+    metric->ReinitializeSeed(          metricSeed );
+
+
+    // Copies of the metric, with their own transformation and interpolator,
+    // evaluate the initial points of the optimizer along with the metric.
+    // There are 2n+1 such points in the first batch.
+    unsigned int evaluations = this->m_concurrentEvaluations;
+    if (evaluations == 0)
+        evaluations = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+    evaluations = std::min(evaluations, 2 * TransformType::ParametersDimension + 1);
+
+    typename OptimizerType::CostFunctionListType metricCopies;
+    for (unsigned int i = 1; i < evaluations; ++i)
+    {
+        typename TransformType::Pointer copyTransform = TransformType::New();
+        copyTransform->SetCenter(     transform->GetCenter() );
+        copyTransform->SetParameters( transform->GetParameters() );
+
+        typename MetricType::Pointer copy = MetricType::New();
+        copy->SetTransform(              copyTransform );
+        copy->SetInterpolator(           InterpolatorType::New() );
+        copy->SetFixedImage(             this->m_fixedImage );
+        copy->SetMovingImage(            this->m_movingImage );
+        copy->SetFixedImageRegion(       this->m_fixedImage->GetBufferedRegion() );
+        copy->SetNumberOfHistogramBins(  this->m_histogramBins );
+        copy->SetNumberOfSpatialSamples( this->m_spatialSamples );
+        copy->SetNumberOfWorkUnits(      metricWorkUnits );
+        copy->ReinitializeSeed(          metricSeed );
+        try
+        {
+            copy->Initialize();
+        }
+        catch( itk::ExceptionObject & err )
+        {
+            std::string message = "Unexpected error: ";
+            message += err.GetDescription();
+            throw std::runtime_error( message  );
+        }
+        metricCopies.push_back( copy.GetPointer() );
+    }
 
 
     // Initialize the optimizer
@@ -295,6 +366,7 @@ Optimus< TFixedImage, TMovingImage, TTransformScalarType >
     optimizer->SetNbInterp(         this->m_interpolations );
     optimizer->SetScaleTranslation( this->m_scalingCoefficient );
     optimizer->SetMaxFunctionCalls( this->m_iterations );
+    optimizer->SetCostFunctionCopies( metricCopies );
 
 
     // Start the registration process
@@ -34,8 +34,10 @@
 #include <medDataManager.h>
 #include <medMetaDataKeys.h>
 #include <medMessageController.h>
+#include <medPaintUndoStore.h>
 #include <medPluginManager.h>
 #include <medSelectorToolBox.h>
+#include <medSettingsManager.h>
 #include <medTabbedViewContainers.h>
 #include <medToolBoxFactory.h>
 #include <medUtilities.h>
@@ -480,9 +482,6 @@ AlgorithmPaintToolBox::AlgorithmPaintToolBox(QWidget *parent ) :
     m_copy.second = -1;
     viewCopied = nullptr;
 
-    m_undoStacks = new QHash<medAbstractView*,QStack<PairListSlicePlaneId>*>();
-    m_redoStacks = new QHash<medAbstractView*,QStack<PairListSlicePlaneId>*>();
-
     currentPlaneIndex = 0;
     currentIdSlice = 0;
     undoRedoCopyPasteModeOn = false;
@@ -507,12 +506,13 @@ AlgorithmPaintToolBox::AlgorithmPaintToolBox(QWidget *parent ) :
 AlgorithmPaintToolBox::~AlgorithmPaintToolBox()
 {
     setOfPaintBrushRois.clear();
+    qDeleteAll(m_undoStores);
 }
 
 medAbstractData* AlgorithmPaintToolBox::processOutput()
 {
     // Check if painted data on the volume
-    if (!m_undoStacks->empty() && !m_undoStacks->value(currentView)->isEmpty())
+    if (m_undoStores.value(currentView) && m_undoStores.value(currentView)->canUndo())
     {
         updateMaskWithMasterLabel();
         copyMetaData(m_maskData, m_imageData);
@@ -1524,13 +1524,8 @@ void AlgorithmPaintToolBox::setParameter(int channel, int value)
 
 void AlgorithmPaintToolBox::undo()
 {
-    if (!currentView ||  !m_undoStacks || !m_undoStacks->contains(currentView))
-    {
-        return;
-    }
-    QStack<PairListSlicePlaneId> * undo_stack = m_undoStacks->value(currentView);
-
-    if (undo_stack->isEmpty())
+    medPaintUndoStore *store = m_undoStores.value(currentView);
+    if (!currentView || !store || !store->canUndo())
     {
         return;
     }
@@ -1541,51 +1536,8 @@ void AlgorithmPaintToolBox::undo()
         return;
     }
 
-    if (!m_redoStacks->contains(currentView))
-    {
-        m_redoStacks->insert(currentView,new QStack<PairListSlicePlaneId>());
-    }
-
-    QStack<PairListSlicePlaneId> * redo_stack = m_redoStacks->value(currentView);
-
-    PairListSlicePlaneId previousState = undo_stack->pop();
-    unsigned char planeIndex = previousState.second;
-
-    MaskType::RegionType requestedRegion = m_itkMask->GetLargestPossibleRegion();
-    Mask2dType::IndexType index2d;
-    Mask2dType::RegionType region;
-    Mask2dType::RegionType::SizeType size;
-
-    unsigned int i, j;
-    char direction[2];
-    for (i = 0, j = 0; i < 3; ++i )
-    {
-        if (i != planeIndex)
-        {
-            direction[j] = i;
-            j++;
-        }
-    }
-
-    index2d[ direction[0] ]    = requestedRegion.GetIndex()[ direction[0] ];
-    index2d[ 1- direction[0] ] = requestedRegion.GetIndex()[ direction[1] ];
-    size[ direction[0] ]     = requestedRegion.GetSize()[  direction[0] ];
-    size[ 1- direction[0] ]  = requestedRegion.GetSize()[  direction[1] ];
-
-    region.SetSize(size);
-    region.SetIndex(index2d);
-
-    PaintBrushSet list;
-    for(auto& prev : previousState.first )
+    for (unsigned int idSlice : store->undo(m_itkMask))
     {
-        unsigned int idSlice = prev->getIdSlice();
-        Mask2dType::Pointer currentSlice = Mask2dType::New();
-        currentSlice->SetRegions(region);
-        currentSlice->Allocate();
-        copySliceFromMask3D(currentSlice, planeIndex, direction, idSlice, false);
-        pasteSliceToMask3D(prev->getSlice(), planeIndex, direction, idSlice, false);
-        list.insert(new medPaintBrush(currentSlice, idSlice, prev->isMasterRoi(), prev->getLabel() ));
-
         for (auto& pB : setOfPaintBrushRois)
         {
             if (pB->getIdSlice() == idSlice)
@@ -1602,16 +1554,13 @@ void AlgorithmPaintToolBox::undo()
         }
     }
 
-    PairListSlicePlaneId currentState = PairListSlicePlaneId(list,planeIndex);
-    redo_stack->append(currentState);
-
     m_itkMask->Modified();
     m_itkMask->GetPixelContainer()->Modified();
     m_itkMask->SetPipelineMTime(m_itkMask->GetMTime());
     m_maskAnnotationData->invokeModified();
 
     // No more painted data
-    if (m_undoStacks->value(currentView)->isEmpty())
+    if (!store->canUndo())
     {
         m_applyButton->setDisabled(true);
     }
@@ -1619,57 +1568,14 @@ void AlgorithmPaintToolBox::undo()
 
 void AlgorithmPaintToolBox::redo()
 {
-    if (!currentView ||  !m_redoStacks || !m_redoStacks->contains(currentView))
-    {
-        return;
-    }
-
-    QStack<PairListSlicePlaneId> *redo_stack = m_redoStacks->value(currentView);
-    QStack<PairListSlicePlaneId> *undo_stack = m_undoStacks->value(currentView);
-
-    if (redo_stack->isEmpty())
+    medPaintUndoStore *store = m_undoStores.value(currentView);
+    if (!currentView || !store || !store->canRedo())
     {
         return;
     }
 
-    // Save the current state in the undo_stack
-    PairListSlicePlaneId nextState = redo_stack->pop();
-    unsigned char planeIndex = nextState.second;
-    MaskType::RegionType requestedRegion = m_itkMask->GetLargestPossibleRegion();
-    Mask2dType::IndexType index2d;
-    Mask2dType::RegionType region;
-    Mask2dType::RegionType::SizeType size;
-
-    unsigned int i, j;
-    char direction[2];
-    for (i = 0, j = 0; i < 3; ++i )
+    for (unsigned int idSlice : store->redo(m_itkMask))
     {
-        if (i != planeIndex)
-        {
-            direction[j] = i;
-            j++;
-        }
-    }
-
-    index2d[ direction[0] ]    = requestedRegion.GetIndex()[ direction[0] ];
-    index2d[ 1- direction[0] ] = requestedRegion.GetIndex()[ direction[1] ];
-    size[ direction[0] ]     = requestedRegion.GetSize()[  direction[0] ];
-    size[ 1- direction[0] ]  = requestedRegion.GetSize()[  direction[1] ];
-
-    region.SetSize(size);
-    region.SetIndex(index2d);
-
-    PaintBrushSet list;
-    for(auto& next : nextState.first )
-    {
-        unsigned int idSlice = next->getIdSlice();
-        Mask2dType::Pointer currentSlice = Mask2dType::New();
-        currentSlice->SetRegions(region);
-        currentSlice->Allocate();
-        copySliceFromMask3D(currentSlice,planeIndex,direction,idSlice, false);
-        pasteSliceToMask3D(next->getSlice(),nextState.second,direction,idSlice, false);
-        list.insert(new medPaintBrush(currentSlice, idSlice, next->isMasterRoi(), next->getLabel() ));
-
         if (slicingParameter)
         {
             slicingParameter->getSlider()->addTick(idSlice);
@@ -1677,9 +1583,6 @@ void AlgorithmPaintToolBox::redo()
         }
     }
 
-    PairListSlicePlaneId currentState = PairListSlicePlaneId(list,planeIndex);
-    undo_stack->append(currentState);
-
     m_itkMask->Modified();
     m_itkMask->GetPixelContainer()->Modified();
     m_itkMask->SetPipelineMTime(m_itkMask->GetMTime());
@@ -1694,41 +1597,8 @@ void AlgorithmPaintToolBox::addSliceToStack(medAbstractView *view, const unsigne
         return;
     }
 
-    if(!m_undoStacks->contains(view))
-    {
-        m_undoStacks->insert(view, new QStack<PairListSlicePlaneId>());
-    }
-
-    // copy code
-    MaskType::RegionType requestedRegion = m_itkMask->GetLargestPossibleRegion();
-    Mask2dType::IndexType index2d;
-    Mask2dType::RegionType region;
-    Mask2dType::RegionType::SizeType size;
-
-    unsigned int i, j;
-    char direction[2];
-    for (i = 0, j = 0; i < 3; ++i )
+    for (unsigned int idSlice : listIdSlice)
     {
-        if (i != planeIndex)
-        {
-            direction[j] = i;
-            j++;
-        }
-    }
-
-    index2d[ direction[0] ]    = requestedRegion.GetIndex()[ direction[0] ];
-    index2d[ 1- direction[0] ] = requestedRegion.GetIndex()[ direction[1] ];
-    size[ direction[0] ]     = requestedRegion.GetSize()[  direction[0] ];
-    size[ 1- direction[0] ]  = requestedRegion.GetSize()[  direction[1] ];
-
-    region.SetSize(size);
-    region.SetIndex(index2d);
-
-    PaintBrushSet setOfUndoRois;
-    setOfUndoRois.clear();
-    for(int i = 0; i<listIdSlice.size(); i++)
-    {
-        unsigned int idSlice = listIdSlice[i];
         for (auto& pB : setOfPaintBrushRois)
         {
             if (pB->getIdSlice() == idSlice)
@@ -1737,24 +1607,33 @@ void AlgorithmPaintToolBox::addSliceToStack(medAbstractView *view, const unsigne
                 break;
             }
         }
-        Mask2dType::Pointer currentSlice = Mask2dType::New();
-        currentSlice->SetRegions(region);
-        currentSlice->Allocate();
-        copySliceFromMask3D(currentSlice,planeIndex,direction,idSlice);
-        setOfUndoRois.insert(new medPaintBrush(currentSlice, idSlice, isMaster, m_strokeLabelSpinBox->value()));
+        setInterpolatedPixelsToLabel(planeIndex, idSlice);
+        setOfPaintBrushRois.insert(new medPaintBrush(idSlice, isMaster, m_strokeLabelSpinBox->value()));
 
         slicingParameter->getSlider()->addTick(idSlice);
         slicingParameter->getSlider()->update();
     }
 
-    setOfPaintBrushRois.insert(setOfUndoRois.begin(), setOfUndoRois.end());
-
-    m_undoStacks->value(view)->append(PairListSlicePlaneId(setOfUndoRois,planeIndex));
+    // only the voxels changed by the operation are kept
+    if (isMaster)
+    {
+        undoStore(view)->beginOperation(m_itkMask, planeIndex, listIdSlice);
+    }
+    else
+    {
+        // interpolated slices belong to the operation begun by interpolate()
+        undoStore(view)->addSlices(m_itkMask, planeIndex, listIdSlice);
+    }
+}
 
-    if (m_redoStacks->contains(view))
+medPaintUndoStore *AlgorithmPaintToolBox::undoStore(medAbstractView *view)
+{
+    if (!m_undoStores.contains(view))
     {
-        m_redoStacks->value(view)->clear();
+        qint64 memoryBudget = medSettingsManager::instance()->value("medAlgorithmPaint", "undo_memory_budget", 64).toLongLong();
+        m_undoStores.insert(view, new medPaintUndoStore(memoryBudget * 1024 * 1024));
     }
+    return m_undoStores.value(view);
 }
 
 void AlgorithmPaintToolBox::clear()
@@ -1801,16 +1680,7 @@ void AlgorithmPaintToolBox::clearMask()
     }
     m_imageData = nullptr;
 
-    if (m_undoStacks->value(currentView))
-    {
-        m_undoStacks->value(currentView)->clear();
-        m_undoStacks->remove(currentView);
-    }
-    if (m_redoStacks->value(currentView))
-    {
-        m_redoStacks->value(currentView)->clear();
-        m_redoStacks->remove(currentView);
-    }
+    delete m_undoStores.take(currentView);
 
     showButtons(false);
     resetToolbox();
@@ -1841,11 +1711,7 @@ void AlgorithmPaintToolBox::setCurrentView(medAbstractImageView * view)
 {
     currentView = view;
 
-    if (!m_undoStacks->contains(currentView))
-    {
-        m_redoStacks->insert(currentView,new QStack<PairListSlicePlaneId>());
-        m_undoStacks->insert(currentView,new QStack<PairListSlicePlaneId>());
-    }
+    undoStore(currentView);
 }
 
 void AlgorithmPaintToolBox::addBrushSize(int size)
@@ -2137,6 +2003,28 @@ void AlgorithmPaintToolBox::pasteSliceToMask3D(const itk::Image<unsigned char,2>
     }
 }
 
+/**
+ * Interpolated pixels of a slice become regular pixels of the current label.
+ */
+void AlgorithmPaintToolBox::setInterpolatedPixelsToLabel(unsigned char planeIndex, unsigned int slice)
+{
+    MaskType::RegionType region = m_itkMask->GetLargestPossibleRegion();
+    region.SetIndex(planeIndex, slice);
+    region.SetSize(planeIndex, 1);
+    if (!m_itkMask->GetLargestPossibleRegion().IsInside(region))
+    {
+        return;
+    }
+
+    for (MaskIterator it(m_itkMask, region); !it.IsAtEnd(); ++it)
+    {
+        if (it.Get() == interpolatedMaskPixelValue)
+        {
+            it.Set(m_strokeLabelSpinBox->value());
+        }
+    }
+}
+
 void AlgorithmPaintToolBox::deleteSliceFromMask3D(unsigned int sliceIndex)
 {
     typedef itk::ImageSliceIteratorWithIndex< MaskType> SliceIteratorType;
@@ -2204,6 +2092,22 @@ void AlgorithmPaintToolBox::interpolate()
     this->setToolBoxOnWaitStatusForNonRunnableProcess();
 
     std::vector<std::pair<unsigned int, int>> masterRois;
+    QList<unsigned int> interpolatedSlices;
+    for (auto& pB : setOfPaintBrushRois)
+    {
+        if (pB->isMasterRoi())
+        {
+            masterRois.push_back(std::pair<unsigned int, int>(pB->getIdSlice(), pB->getLabel()));
+        }
+        else
+        {
+            interpolatedSlices.append(pB->getIdSlice());
+        }
+    }
+
+    // the previous interpolation is erased and redone in a single operation,
+    // see addSliceToStack()
+    undoStore(currentView)->beginOperation(m_itkMask, currentPlaneIndex, interpolatedSlices);
     for(auto it = setOfPaintBrushRois.begin(); it != setOfPaintBrushRois.end(); )
     {
         auto& pB = *it;
@@ -2214,7 +2118,6 @@ void AlgorithmPaintToolBox::interpolate()
         }
         else
         {
-            masterRois.push_back(std::pair<unsigned int, int>(pB->getIdSlice(), pB->getLabel()));
             ++it;
         }
     }
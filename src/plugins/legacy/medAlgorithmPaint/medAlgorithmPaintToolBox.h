@@ -36,6 +36,7 @@ namespace med
 {
 
 class ClickAndMoveEventFilter;
+class medPaintUndoStore;
 
 struct PaintBrushObjComparator
 {
@@ -246,7 +247,8 @@ private:
     QPair<Mask2dType::Pointer,char> m_copy;
 
     // undo_redo_feature's attributes
-    QHash<medAbstractView*,QStack<PairListSlicePlaneId>*> *m_undoStacks,*m_redoStacks;
+    QHash<medAbstractView*, medPaintUndoStore*> m_undoStores;
+    medPaintUndoStore *undoStore(medAbstractView *view);
     medAbstractImageView *currentView;
     medAbstractImageView *viewCopied;
 
@@ -260,6 +262,7 @@ private:
 
     void interpolateBetween2PaintBrush(unsigned int firstSlice, unsigned int secondSlice);
     void deleteSliceFromMask3D(unsigned int sliceIndex);
+    void setInterpolatedPixelsToLabel(unsigned char planeIndex, unsigned int slice);
 
     QVector3D m_lastVup;
     QVector3D m_lastVpn;
@@ -25,16 +25,14 @@ namespace med
 class medPaintBrushPrivate
 {
 public:
-    Mask2dType::Pointer slice;
     bool isMaster; //true when the ROI is new or has been modified (for interpolation)
     int label;
 };
 
-medPaintBrush::medPaintBrush(Mask2dType::Pointer slice, int id, bool isMaster, int label, medAbstractRoi* parent)
+medPaintBrush::medPaintBrush(int id, bool isMaster, int label, medAbstractRoi* parent)
     : medAbstractRoi(parent), d(new medPaintBrushPrivate)
 {
     setIdSlice(id);
-    d->slice = slice;
     setMasterRoi(isMaster);
     d->label = label;
 }
@@ -45,11 +43,6 @@ medPaintBrush::~medPaintBrush()
     d = nullptr;
 }
 
-Mask2dType::Pointer medPaintBrush::getSlice()
-{
-    return d->slice;
-}
-
 void medPaintBrush::setRightColor()
 {
 }
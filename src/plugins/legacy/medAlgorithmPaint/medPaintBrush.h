@@ -29,7 +29,7 @@ class MEDALGORITMPAINT_EXPORT medPaintBrush : public medAbstractRoi
     Q_OBJECT
 
 public:
-    medPaintBrush(Mask2dType::Pointer slice, int id, bool isMaster, int label, medAbstractRoi* parent = nullptr);
+    medPaintBrush(int id, bool isMaster, int label, medAbstractRoi* parent = nullptr);
 
     virtual ~medPaintBrush();
 
@@ -54,8 +54,6 @@ public:
 
     void saveState() override;
 
-    Mask2dType::Pointer getSlice();
-
     int getLabel();
 
 private:
@@ -0,0 +1,441 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medPaintUndoStore.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QVector>
+
+namespace med
+{
+
+namespace
+{
+
+// position of the voxels of a slice in the mask buffer
+struct SliceGeometry
+{
+    qint64 base;
+    qint64 stepU, stepV;   // buffer offsets along the rows, and between rows
+    qint64 sizeU, sizeV;
+};
+
+bool sliceGeometry(MaskType *mask, unsigned char planeIndex, unsigned int slice, SliceGeometry &geometry)
+{
+    const MaskType::RegionType region = mask->GetBufferedRegion();
+    const qint64 position = static_cast<qint64>(slice) - region.GetIndex(planeIndex);
+    if (planeIndex > 2 || position < 0 || position >= static_cast<qint64>(region.GetSize(planeIndex)))
+    {
+        return false;
+    }
+
+    const MaskType::OffsetValueType *offsetTable = mask->GetOffsetTable();
+    const unsigned int axisU = (planeIndex == 0) ? 1 : 0;
+    const unsigned int axisV = (planeIndex == 2) ? 1 : 2;
+
+    geometry.base  = position * offsetTable[planeIndex];
+    geometry.stepU = offsetTable[axisU];
+    geometry.stepV = offsetTable[axisV];
+    geometry.sizeU = region.GetSize(axisU);
+    geometry.sizeV = region.GetSize(axisV);
+    return true;
+}
+
+}
+
+// values of a slice before an operation, as runs of equal values: mask
+// slices are mostly uniform, the runs only follow the painted contours
+struct medPaintSliceValues
+{
+    QByteArray values;
+    QVector<quint32> lengths;
+};
+
+struct medPaintOperation
+{
+    QList<unsigned int> slices;
+    qint64 step = 1;             // buffer offset between consecutive voxels of a run
+    QVector<qint64> runStarts;   // buffer offset of the first voxel of each run
+    QVector<quint32> runLengths;
+    QByteArray differences;      // XOR of the values before and after, for each voxel of the runs
+    qint64 fileOffset = -1;      // position in the spill file when not in memory
+
+    qint64 memorySize() const
+    {
+        return runStarts.size() * sizeof(qint64) + runLengths.size() * sizeof(quint32) + differences.size();
+    }
+};
+
+class medPaintUndoStorePrivate
+{
+public:
+    qint64 memoryBudget;
+    qint64 memoryUsage;
+    MaskType *mask;
+
+    QList<medPaintOperation> undoOperations;
+    QList<medPaintOperation> redoOperations;
+
+    bool pending;
+    unsigned char pendingPlane;
+    QList<unsigned int> pendingSlices;
+    QList<medPaintSliceValues> pendingValues; // values of the slices before the pending operation
+
+    QTemporaryFile *spillFile;
+
+    void saveSlices(const QList<unsigned int> &slices);
+    void endOperation();
+    void apply(const medPaintOperation &operation);
+    void push(QList<medPaintOperation> &operations, const medPaintOperation &operation);
+    medPaintOperation pop(QList<medPaintOperation> &operations);
+    void release(QList<medPaintOperation> &operations);
+    void enforceMemoryBudget();
+    bool spill(medPaintOperation &operation);
+    void load(medPaintOperation &operation);
+};
+
+void medPaintUndoStorePrivate::saveSlices(const QList<unsigned int> &slices)
+{
+    const unsigned char *buffer = mask->GetBufferPointer();
+    for (unsigned int slice : slices)
+    {
+        SliceGeometry geometry;
+        if (pendingSlices.contains(slice) || !sliceGeometry(mask, pendingPlane, slice, geometry))
+        {
+            continue;
+        }
+
+        medPaintSliceValues saved;
+        for (qint64 v = 0; v < geometry.sizeV; ++v)
+        {
+            const unsigned char *row = buffer + geometry.base + v * geometry.stepV;
+            for (qint64 u = 0; u < geometry.sizeU; ++u)
+            {
+                const char value = static_cast<char>(row[u * geometry.stepU]);
+                if (!saved.values.isEmpty() && saved.values.back() == value)
+                {
+                    saved.lengths.last()++;
+                }
+                else
+                {
+                    saved.values.append(value);
+                    saved.lengths.append(1);
+                }
+            }
+        }
+
+        pendingSlices.append(slice);
+        pendingValues.append(saved);
+    }
+}
+
+/**
+ * Records the differences between the saved slices and the mask.
+ */
+void medPaintUndoStorePrivate::endOperation()
+{
+    if (!pending)
+    {
+        return;
+    }
+    pending = false;
+
+    medPaintOperation operation;
+    operation.slices = pendingSlices;
+
+    const unsigned char *buffer = mask->GetBufferPointer();
+    for (int i = 0; i < pendingSlices.size(); ++i)
+    {
+        SliceGeometry geometry;
+        if (!sliceGeometry(mask, pendingPlane, pendingSlices[i], geometry))
+        {
+            continue;
+        }
+        operation.step = geometry.stepU;
+
+        const medPaintSliceValues &before = pendingValues[i];
+        int beforeRun = 0;
+        quint32 beforeRunLeft = before.lengths.value(0);
+        for (qint64 v = 0; v < geometry.sizeV; ++v)
+        {
+            const unsigned char *row = buffer + geometry.base + v * geometry.stepV;
+            bool inRun = false;
+            for (qint64 u = 0; u < geometry.sizeU; ++u)
+            {
+                if (beforeRunLeft == 0)
+                {
+                    beforeRunLeft = before.lengths[++beforeRun];
+                }
+                beforeRunLeft--;
+
+                unsigned char difference = static_cast<unsigned char>(before.values[beforeRun]) ^ row[u * geometry.stepU];
+                if (!difference)
+                {
+                    inRun = false;
+                    continue;
+                }
+
+                if (inRun)
+                {
+                    operation.runLengths.last()++;
+                }
+                else
+                {
+                    operation.runStarts.append(geometry.base + v * geometry.stepV + u * geometry.stepU);
+                    operation.runLengths.append(1);
+                    inRun = true;
+                }
+                operation.differences.append(static_cast<char>(difference));
+            }
+        }
+    }
+
+    pendingSlices.clear();
+    pendingValues.clear();
+
+    // an operation which changed nothing has nothing to undo
+    if (!operation.runStarts.isEmpty())
+    {
+        push(undoOperations, operation);
+    }
+}
+
+void medPaintUndoStorePrivate::apply(const medPaintOperation &operation)
+{
+    unsigned char *buffer = mask->GetBufferPointer();
+    const unsigned char *difference = reinterpret_cast<const unsigned char *>(operation.differences.constData());
+    for (int i = 0; i < operation.runStarts.size(); ++i)
+    {
+        unsigned char *voxel = buffer + operation.runStarts[i];
+        for (quint32 k = 0; k < operation.runLengths[i]; ++k)
+        {
+            *voxel ^= *difference++;
+            voxel += operation.step;
+        }
+    }
+}
+
+void medPaintUndoStorePrivate::push(QList<medPaintOperation> &operations, const medPaintOperation &operation)
+{
+    operations.append(operation);
+    memoryUsage += operation.memorySize();
+    enforceMemoryBudget();
+}
+
+medPaintOperation medPaintUndoStorePrivate::pop(QList<medPaintOperation> &operations)
+{
+    medPaintOperation operation = operations.takeLast();
+    load(operation);
+    memoryUsage -= operation.memorySize();
+    return operation;
+}
+
+void medPaintUndoStorePrivate::release(QList<medPaintOperation> &operations)
+{
+    for (const medPaintOperation &operation : operations)
+    {
+        if (operation.fileOffset < 0)
+        {
+            memoryUsage -= operation.memorySize();
+        }
+    }
+    operations.clear();
+}
+
+/**
+ * Spills the operations furthest from the current state, keeping the next
+ * operation to undo and to redo in memory.
+ */
+void medPaintUndoStorePrivate::enforceMemoryBudget()
+{
+    for (int i = 0; i < undoOperations.size() - 1 && memoryUsage > memoryBudget; ++i)
+    {
+        if (!spill(undoOperations[i]))
+        {
+            return;
+        }
+    }
+    for (int i = 0; i < redoOperations.size() - 1 && memoryUsage > memoryBudget; ++i)
+    {
+        if (!spill(redoOperations[i]))
+        {
+            return;
+        }
+    }
+}
+
+bool medPaintUndoStorePrivate::spill(medPaintOperation &operation)
+{
+    if (operation.fileOffset >= 0 || operation.memorySize() == 0)
+    {
+        return true;
+    }
+
+    if (!spillFile)
+    {
+        spillFile = new QTemporaryFile(QDir::tempPath() + "/medPaintUndo-XXXXXX");
+        if (!spillFile->open())
+        {
+            qWarning() << "medPaintUndoStore: cannot create" << spillFile->fileName()
+                       << ", paint history kept in memory";
+            return false;
+        }
+    }
+
+    qint64 fileOffset = spillFile->size();
+    spillFile->seek(fileOffset);
+    QDataStream stream(spillFile);
+    stream << operation.runStarts << operation.runLengths << operation.differences;
+    if (stream.status() != QDataStream::Ok)
+    {
+        return false;
+    }
+
+    memoryUsage -= operation.memorySize();
+    operation.fileOffset = fileOffset;
+    operation.runStarts = QVector<qint64>();
+    operation.runLengths = QVector<quint32>();
+    operation.differences = QByteArray();
+    return true;
+}
+
+void medPaintUndoStorePrivate::load(medPaintOperation &operation)
+{
+    if (operation.fileOffset < 0)
+    {
+        return;
+    }
+
+    spillFile->seek(operation.fileOffset);
+    QDataStream stream(spillFile);
+    stream >> operation.runStarts >> operation.runLengths >> operation.differences;
+    operation.fileOffset = -1;
+    memoryUsage += operation.memorySize();
+}
+
+medPaintUndoStore::medPaintUndoStore(qint64 memoryBudget) : d(new medPaintUndoStorePrivate)
+{
+    d->memoryBudget = memoryBudget;
+    d->memoryUsage = 0;
+    d->mask = nullptr;
+    d->pending = false;
+    d->pendingPlane = 0;
+    d->spillFile = nullptr;
+}
+
+medPaintUndoStore::~medPaintUndoStore()
+{
+    delete d->spillFile;
+    delete d;
+    d = nullptr;
+}
+
+void medPaintUndoStore::beginOperation(MaskType *mask, unsigned char planeIndex, const QList<unsigned int> &slices)
+{
+    if (mask != d->mask)
+    {
+        clear();
+        d->mask = mask;
+    }
+    d->endOperation();
+    d->release(d->redoOperations);
+
+    d->pending = true;
+    d->pendingPlane = planeIndex;
+    d->saveSlices(slices);
+}
+
+void medPaintUndoStore::addSlices(MaskType *mask, unsigned char planeIndex, const QList<unsigned int> &slices)
+{
+    if (!d->pending || mask != d->mask || planeIndex != d->pendingPlane)
+    {
+        beginOperation(mask, planeIndex, slices);
+        return;
+    }
+    d->saveSlices(slices);
+}
+
+bool medPaintUndoStore::canUndo() const
+{
+    return d->pending || !d->undoOperations.isEmpty();
+}
+
+bool medPaintUndoStore::canRedo() const
+{
+    return !d->redoOperations.isEmpty();
+}
+
+QList<unsigned int> medPaintUndoStore::undo(MaskType *mask)
+{
+    if (mask != d->mask)
+    {
+        clear();
+        return QList<unsigned int>();
+    }
+
+    d->endOperation();
+    if (d->undoOperations.isEmpty())
+    {
+        return QList<unsigned int>();
+    }
+
+    medPaintOperation operation = d->pop(d->undoOperations);
+    d->apply(operation);
+    d->push(d->redoOperations, operation);
+
+    return operation.slices;
+}
+
+QList<unsigned int> medPaintUndoStore::redo(MaskType *mask)
+{
+    if (mask != d->mask)
+    {
+        clear();
+        return QList<unsigned int>();
+    }
+
+    if (d->redoOperations.isEmpty())
+    {
+        return QList<unsigned int>();
+    }
+
+    medPaintOperation operation = d->pop(d->redoOperations);
+    d->apply(operation);
+    d->push(d->undoOperations, operation);
+
+    return operation.slices;
+}
+
+void medPaintUndoStore::clear()
+{
+    d->pending = false;
+    d->pendingSlices.clear();
+    d->pendingValues.clear();
+
+    d->undoOperations.clear();
+    d->redoOperations.clear();
+    d->memoryUsage = 0;
+
+    delete d->spillFile;
+    d->spillFile = nullptr;
+}
+
+qint64 medPaintUndoStore::memoryUsage() const
+{
+    return d->memoryUsage;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QList>
+
+#include <itkImage.h>
+
+#include <medAlgorithmPaintPluginExport.h>
+
+namespace med
+{
+
+class medPaintUndoStorePrivate;
+
+typedef itk::Image <unsigned char, 3> MaskType;
+
+/**
+ * @class medPaintUndoStore
+ * @brief Undo and redo history of the paint operations on a mask.
+ *
+ * An operation only keeps the voxels it changed, as runs of XOR differences
+ * between the values before and after it. Applying these differences toggles
+ * the mask between both states, so undo and redo cost the number of changed
+ * voxels. Beyond the memory budget, the oldest operations are written to a
+ * temporary file and read back when they are needed.
+ */
+class MEDALGORITMPAINT_EXPORT medPaintUndoStore
+{
+public:
+    /**
+     * @param memoryBudget - memory of the operations kept in memory, in bytes
+     */
+    medPaintUndoStore(qint64 memoryBudget);
+    ~medPaintUndoStore();
+
+    /**
+     * Saves the slices that an operation is about to modify, as runs of equal
+     * values, and clears the redo history. The changes are recorded when the
+     * next operation begins, or when the operation is undone.
+     */
+    void beginOperation(MaskType *mask, unsigned char planeIndex, const QList<unsigned int> &slices);
+
+    /**
+     * Saves more slices for the operation in progress, so that it is undone at
+     * once. Begins an operation if there is none in progress on this plane.
+     */
+    void addSlices(MaskType *mask, unsigned char planeIndex, const QList<unsigned int> &slices);
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /** Reverts the last operation on the mask, and returns the slices it modified. */
+    QList<unsigned int> undo(MaskType *mask);
+
+    /** Applies again the last undone operation, and returns the slices it modified. */
+    QList<unsigned int> redo(MaskType *mask);
+
+    void clear();
+
+    /** Memory of the operations currently kept in memory, in bytes. */
+    qint64 memoryUsage() const;
+
+private:
+    medPaintUndoStorePrivate *d;
+};
+
+}
@@ -13,7 +13,9 @@
 
 #include <medFilteringWorkspaceL.h>
 
+#include <medAbstractImageView.h>
 #include <medAbstractLayeredView.h>
+#include <medAbstractParameterL.h>
 #include <medAbstractSelectableToolBox.h>
 #include <medDataManager.h>
 #include <medMetaDataKeys.h>
@@ -30,11 +32,15 @@ public:
     medViewContainer *outputContainer;
 
     medAbstractData *filterOutput;
+    QPointer<medAbstractData> preview;
 };
 
 medFilteringWorkspaceL::medFilteringWorkspaceL(QWidget *parent)
     : medSelectorWorkspace (parent, staticName()), d(new medFilteringWorkspaceLPrivate)
 {
+    d->inputContainer = nullptr;
+    d->outputContainer = nullptr;
+    d->filterOutput = nullptr;
 }
 
 medFilteringWorkspaceL::~medFilteringWorkspaceL()
@@ -156,6 +162,59 @@ void medFilteringWorkspaceL::importProcessOutput()
     }
 }
 
+medAbstractView *medFilteringWorkspaceL::inputView()
+{
+    return d->inputContainer ? d->inputContainer->view() : nullptr;
+}
+
+/**
+ * @brief displays a preview in the output container, with the orientation and position of the input view
+ */
+void medFilteringWorkspaceL::showProcessPreview(medAbstractData *preview)
+{
+    if (!preview || !d->outputContainer)
+    {
+        return;
+    }
+
+    medAbstractLayeredView *outputView = dynamic_cast<medAbstractLayeredView *>(d->outputContainer->view());
+    if (outputView && d->preview && outputView->contains(d->preview))
+    {
+        // the output container is not multilayered, adding the data would recreate its view
+        medAbstractData *previousPreview = d->preview;
+        outputView->addLayer(preview);
+        outputView->removeData(previousPreview);
+    }
+    else
+    {
+        d->outputContainer->addData(preview);
+        // the input stays the container in which the user browses
+        d->inputContainer->setSelected(true);
+    }
+    d->preview = preview;
+
+    medAbstractImageView *inputImageView  = dynamic_cast<medAbstractImageView *>(inputView());
+    medAbstractImageView *outputImageView = dynamic_cast<medAbstractImageView *>(d->outputContainer->view());
+    if (inputImageView && outputImageView)
+    {
+        outputImageView->setOrientation(inputImageView->orientation());
+        outputImageView->positionBeingViewedParameter()->setValue(inputImageView->positionBeingViewedParameter()->value());
+    }
+}
+
+/**
+ * @brief removes the preview from the output container, if it is still displayed
+ */
+void medFilteringWorkspaceL::hideProcessPreview()
+{
+    medAbstractLayeredView *outputView = d->outputContainer ? dynamic_cast<medAbstractLayeredView *>(d->outputContainer->view()) : nullptr;
+    if (outputView && d->preview && outputView->contains(d->preview))
+    {
+        outputView->removeData(d->preview);
+    }
+    d->preview = nullptr;
+}
+
 bool medFilteringWorkspaceL::isUsable()
 {
     medToolBoxFactory * tbFactory = medToolBoxFactory::instance();
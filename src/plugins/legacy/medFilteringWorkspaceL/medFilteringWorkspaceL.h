@@ -41,6 +41,10 @@ public:
 
     virtual void open(const medDataIndex &index);
 
+    medAbstractView *inputView();
+    void showProcessPreview(medAbstractData *preview);
+    void hideProcessPreview();
+
 signals:
 
     /**
@@ -231,7 +231,7 @@ void medN4BiasCorrectionToolBox::run()
     }
     medRunnableProcess *runProcess = new medRunnableProcess;
     runProcess->setProcess (d->process);
-    this->addConnectionsAndStartJob(runProcess);
+    this->addConnectionsAndStartJob(runProcess, medJobScheduler::HeavyProcessJob);
 }
 
 std::vector<int> medN4BiasCorrectionToolBox::extractValue(QString text)
@@ -14,8 +14,10 @@
 #include <medVtkFibersData.h>
 
 #include <medAbstractDataFactory.h>
+#include <medThumbnailRenderer.h>
 
 #include <vtkSmartPointer.h>
+#include <vtkCellArray.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataReader.h>
 #include <vtkPolyDataWriter.h>
@@ -80,3 +82,49 @@ void *medVtkFibersData::data()
 {
     return d->data;
 }
+
+/**
+ * Projection of the fibers, colored by direction.
+ */
+QImage medVtkFibersData::renderThumbnail(QSize size)
+{
+    vtkPolyData *fibers = d->data ? d->data->GetFibers() : nullptr;
+    if (!fibers || !fibers->GetPoints() || !fibers->GetLines())
+    {
+        return QImage();
+    }
+
+    vtkPoints *fiberPoints = fibers->GetPoints();
+    QVector<QVector3D> points(fiberPoints->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < fiberPoints->GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        fiberPoints->GetPoint(i, point);
+        points[i] = QVector3D(point[0], point[1], point[2]);
+    }
+
+    // every few fibers on large bundles
+    vtkCellArray *lines = fibers->GetLines();
+    vtkIdType segmentCount = std::max<vtkIdType>(0, lines->GetNumberOfConnectivityEntries() - 2 * lines->GetNumberOfCells());
+    vtkIdType stride = std::max<vtkIdType>(1, segmentCount / medThumbnailRenderer::maximumSegmentCount());
+
+    QVector< QPair<int, int> > segments;
+    const vtkIdType *connectivity = lines->GetPointer();
+    const vtkIdType connectivitySize = lines->GetNumberOfConnectivityEntries();
+    vtkIdType fiber = 0;
+    for (vtkIdType offset = 0; offset < connectivitySize; offset += connectivity[offset] + 1, ++fiber)
+    {
+        if (fiber % stride != 0)
+        {
+            continue;
+        }
+        const vtkIdType count = connectivity[offset];
+        const vtkIdType *ids = connectivity + offset + 1;
+        for (vtkIdType i = 1; i < count; ++i)
+        {
+            segments.append(qMakePair(static_cast<int>(ids[i - 1]), static_cast<int>(ids[i])));
+        }
+    }
+
+    return medThumbnailRenderer::renderProjection(points, segments, medThumbnailRenderer::ColorByDirection, size);
+}
@@ -34,6 +34,8 @@ public:
 
     void setData(void *data);
 
+    QImage renderThumbnail(QSize size) override;
+
 private:
     medVtkFibersDataPrivate *d;
 };
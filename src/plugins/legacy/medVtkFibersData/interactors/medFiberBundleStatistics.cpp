@@ -0,0 +1,318 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medFiberBundleStatistics.h>
+
+#include <QDebug>
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <itkFiberBundleStatisticsCalculator.h>
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// sums over the fibers, minimum and maximum over the points
+struct Accumulator
+{
+    double sum = 0;
+    double squareSum = 0;
+    double min = HUGE_VAL;
+    double max = -HUGE_VAL;
+    unsigned long count = 0;
+
+    void addFiber(double value)
+    {
+        sum += value;
+        squareSum += value * value;
+        ++count;
+    }
+
+    void merge(const Accumulator &other)
+    {
+        sum += other.sum;
+        squareSum += other.squareSum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count += other.count;
+    }
+
+    medFiberBundleStatistics::Values values() const
+    {
+        medFiberBundleStatistics::Values values;
+        if (count > 0)
+        {
+            values.mean = sum / count;
+            values.min = min;
+            values.max = max;
+            if (count > 1)
+            {
+                values.var = (squareSum - sum * sum / count) / (count - 1.0);
+            }
+        }
+        return values;
+    }
+};
+
+struct ScalarArray
+{
+    QString name;
+    vtkDataArray *array;
+    int type;          // VTK_FLOAT, VTK_DOUBLE, or another type read through vtkDataArray
+    const void *values;
+};
+
+// fiber of consecutive point ids: plain loop over the values, which the compiler vectorizes
+template <class T>
+double contiguousSum(const T *values, vtkIdType count, double &minValue, double &maxValue)
+{
+    double sum = 0;
+    double fiberMin = minValue;
+    double fiberMax = maxValue;
+    for (vtkIdType k = 0; k < count; ++k)
+    {
+        double value = values[k];
+        sum += value;
+        fiberMin = std::min(fiberMin, value);
+        fiberMax = std::max(fiberMax, value);
+    }
+    minValue = fiberMin;
+    maxValue = fiberMax;
+    return sum;
+}
+
+template <class T>
+double indexedSum(const T *values, const vtkIdType *ids, vtkIdType count, double &minValue, double &maxValue)
+{
+    double sum = 0;
+    for (vtkIdType k = 0; k < count; ++k)
+    {
+        double value = values[ids[k]];
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    return sum;
+}
+
+double fiberSum(const ScalarArray &scalars, const vtkIdType *ids, vtkIdType count, bool contiguous,
+                double &minValue, double &maxValue)
+{
+    switch (scalars.type)
+    {
+        case VTK_FLOAT:
+        {
+            const float *values = static_cast<const float *>(scalars.values);
+            return contiguous ? contiguousSum(values + ids[0], count, minValue, maxValue)
+                              : indexedSum(values, ids, count, minValue, maxValue);
+        }
+        case VTK_DOUBLE:
+        {
+            const double *values = static_cast<const double *>(scalars.values);
+            return contiguous ? contiguousSum(values + ids[0], count, minValue, maxValue)
+                              : indexedSum(values, ids, count, minValue, maxValue);
+        }
+        default:
+        {
+            double sum = 0;
+            for (vtkIdType k = 0; k < count; ++k)
+            {
+                double value = scalars.array->GetComponent(ids[k], 0);
+                sum += value;
+                minValue = std::min(minValue, value);
+                maxValue = std::max(maxValue, value);
+            }
+            return sum;
+        }
+    }
+}
+
+template <class T>
+double fiberLength(const T *coordinates, const vtkIdType *ids, vtkIdType count)
+{
+    double length = 0;
+    for (vtkIdType k = 1; k < count; ++k)
+    {
+        const T *p1 = coordinates + 3 * ids[k - 1];
+        const T *p2 = coordinates + 3 * ids[k];
+        double dx = p2[0] - p1[0];
+        double dy = p2[1] - p1[1];
+        double dz = p2[2] - p1[2];
+        length += std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    return length;
+}
+
+double fiberLength(vtkPoints *points, const vtkIdType *ids, vtkIdType count)
+{
+    vtkDataArray *coordinates = points->GetData();
+    switch (coordinates->GetDataType())
+    {
+        case VTK_FLOAT:
+            return fiberLength(static_cast<const float *>(coordinates->GetVoidPointer(0)), ids, count);
+        case VTK_DOUBLE:
+            return fiberLength(static_cast<const double *>(coordinates->GetVoidPointer(0)), ids, count);
+        default:
+        {
+            double length = 0;
+            for (vtkIdType k = 1; k < count; ++k)
+            {
+                double p1[3], p2[3];
+                points->GetPoint(ids[k - 1], p1);
+                points->GetPoint(ids[k], p2);
+                length += std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+            }
+            return length;
+        }
+    }
+}
+
+}
+
+medFiberBundleStatistics medFiberBundleStatistics::compute(vtkPolyData *bundle)
+{
+    medFiberBundleStatistics statistics;
+    if (!bundle)
+    {
+        return statistics;
+    }
+
+    vtkPointData *pointData = bundle->GetPointData();
+
+    if (pointData->HasArray("Tensors"))
+    {
+        // Specific TTK case
+        itk::FiberBundleStatisticsCalculator::Pointer statCalculator = itk::FiberBundleStatisticsCalculator::New();
+        statCalculator->SetInput(bundle);
+
+        try
+        {
+            statCalculator->Compute();
+
+            Values adc, fa;
+            statCalculator->GetADCStatistics(adc.mean, adc.min, adc.max, adc.var);
+            statCalculator->GetFAStatistics(fa.mean, fa.min, fa.max, fa.var);
+            statistics.arrays["ADC"] = adc;
+            statistics.arrays["FA"] = fa;
+        }
+        catch(itk::ExceptionObject &e)
+        {
+            qDebug() << e.GetDescription();
+            return statistics;
+        }
+    }
+
+    std::vector<ScalarArray> scalarArrays;
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i)
+    {
+        vtkDataArray *array = pointData->GetArray(i);
+        if (array && array->GetNumberOfComponents() == 1)
+        {
+            scalarArrays.push_back({pointData->GetArrayName(i), array, array->GetDataType(), array->GetVoidPointer(0)});
+        }
+    }
+
+    // start of each fiber in the connectivity (count followed by point ids)
+    vtkPoints *points = bundle->GetPoints();
+    vtkCellArray *lines = bundle->GetLines();
+    if (!points || !lines)
+    {
+        return statistics;
+    }
+
+    const vtkIdType *connectivity = lines->GetPointer();
+    const vtkIdType connectivitySize = lines->GetNumberOfConnectivityEntries();
+    std::vector<vtkIdType> fiberOffsets;
+    fiberOffsets.reserve(lines->GetNumberOfCells());
+    for (vtkIdType offset = 0; offset < connectivitySize; offset += connectivity[offset] + 1)
+    {
+        fiberOffsets.push_back(offset);
+    }
+
+    // fibers split in chunks, several per thread to balance the fiber lengths
+    const size_t fiberCount = fiberOffsets.size();
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    const size_t chunkCount = std::min<size_t>(fiberCount, 4 * threader->GetNumberOfWorkUnits());
+
+    std::vector< std::vector<Accumulator> > arrayAccumulators(chunkCount, std::vector<Accumulator>(scalarArrays.size()));
+    std::vector<Accumulator> lengthAccumulators(chunkCount);
+
+    threader->ParallelizeArray(0, chunkCount, [&](itk::SizeValueType chunk)
+    {
+        std::vector<Accumulator> &arrays = arrayAccumulators[chunk];
+        Accumulator &length = lengthAccumulators[chunk];
+
+        size_t firstFiber = fiberCount * chunk / chunkCount;
+        size_t lastFiber = fiberCount * (chunk + 1) / chunkCount;
+        for (size_t fiber = firstFiber; fiber < lastFiber; ++fiber)
+        {
+            const vtkIdType count = connectivity[fiberOffsets[fiber]];
+            const vtkIdType *ids = connectivity + fiberOffsets[fiber] + 1;
+
+            double fiberLengthValue = fiberLength(points, ids, count);
+            length.addFiber(fiberLengthValue);
+            length.min = std::min(length.min, fiberLengthValue);
+            length.max = std::max(length.max, fiberLengthValue);
+
+            if (count == 0)
+            {
+                continue;
+            }
+
+            // tractography writes the points of a fiber one after the other
+            bool contiguous = true;
+            for (vtkIdType k = 1; k < count && contiguous; ++k)
+            {
+                contiguous = (ids[k] == ids[0] + k);
+            }
+
+            for (size_t i = 0; i < scalarArrays.size(); ++i)
+            {
+                double sum = fiberSum(scalarArrays[i], ids, count, contiguous, arrays[i].min, arrays[i].max);
+                arrays[i].addFiber(sum / count);
+            }
+        }
+    }, nullptr);
+
+    Accumulator length;
+    std::vector<Accumulator> arrays(scalarArrays.size());
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        length.merge(lengthAccumulators[chunk]);
+        for (size_t i = 0; i < scalarArrays.size(); ++i)
+        {
+            arrays[i].merge(arrayAccumulators[chunk][i]);
+        }
+    }
+
+    statistics.length = length.values();
+    for (size_t i = 0; i < scalarArrays.size(); ++i)
+    {
+        if (arrays[i].count > 0)
+        {
+            statistics.arrays[scalarArrays[i].name] = arrays[i].values();
+        }
+    }
+
+    return statistics;
+}
@@ -0,0 +1,48 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <QMap>
+#include <QString>
+
+class vtkPolyData;
+
+/**
+ * @class medFiberBundleStatistics
+ * @brief Statistics of a fiber bundle: length of its fibers, and mean value
+ * along its fibers of each scalar point array (FA and ADC for tensor bundles).
+ * Means and variances are computed over the fibers, minima and maxima over
+ * all the points.
+ */
+class medFiberBundleStatistics
+{
+public:
+    struct Values
+    {
+        double mean = 0;
+        double min = 0;
+        double max = 0;
+        double var = 0;
+    };
+
+    /** Statistics of the scalar point arrays, by array name. */
+    QMap<QString, Values> arrays;
+    Values length;
+
+    /**
+     * Computes all the statistics in a single pass over the fibers, split
+     * between threads. Can be called from any thread, as long as the bundle
+     * is not modified meanwhile.
+     */
+    static medFiberBundleStatistics compute(vtkPolyData *bundle);
+};
@@ -33,7 +33,6 @@
 
 #include <itkImage.h>
 #include <itkImageToVTKImageFilter.h>
-#include <itkFiberBundleStatisticsCalculator.h>
 #include <itkCastImageFilter.h>
 
 #include <medMessageController.h>
@@ -52,8 +51,11 @@
 #include <medStringListParameterL.h>
 #include <medIntParameterL.h>
 #include <medDropSite.h>
+#include <medFiberBundleStatistics.h>
 
+#include <QFutureWatcher>
 #include <QInputDialog>
+#include <QtConcurrent>
 #include <cmath>
 #include <QColorDialog>
 #include <QFormLayout>
@@ -80,10 +82,15 @@ public:
     QWidget *toolboxWidget;
     QPointer<QWidget> bundleToolboxWidget;
 
-    QMap<QString, double> meanLengthList;
-    QMap<QString, double> minLengthList;
-    QMap<QString, double> maxLengthList;
-    QMap<QString, double> varLengthList;
+    // statistics of each bundle, valid while the bundle modification time is unchanged
+    struct CachedStatistics
+    {
+        vtkMTimeType modifiedTime;
+        medFiberBundleStatistics statistics;
+    };
+    QHash<vtkPolyData*, CachedStatistics> statistics;
+
+    medFiberBundleStatistics bundleStatistics(const QString &name);
 
     QList<medAbstractParameterL*> parameters;
 
@@ -130,6 +137,24 @@ public:
     QWidget * poLutWidget;
 };
 
+/**
+ * Returns the statistics of a bundle, computed on the first request.
+ */
+medFiberBundleStatistics medVtkFibersDataInteractorPrivate::bundleStatistics(const QString &name)
+{
+    vtkPolyData *bundle = dataset ? dataset->GetBundle(name.toLatin1().constData()).Bundle : nullptr;
+    if (!bundle)
+    {
+        return medFiberBundleStatistics();
+    }
+
+    if (!statistics.contains(bundle) || statistics[bundle].modifiedTime != bundle->GetMTime())
+    {
+        statistics[bundle] = {bundle->GetMTime(), medFiberBundleStatistics::compute(bundle)};
+    }
+    return statistics[bundle].statistics;
+}
+
 template <class T>
 void medVtkFibersDataInteractorPrivate::setROI (medAbstractData *data)
 {
@@ -859,120 +884,14 @@ void medVtkFibersDataInteractor::bundleImageStatistics (const QString &bundleNam
                                                         QMap <QString, double> &max,
                                                         QMap <QString, double> &var)
 {
-    vtkPolyData *bundleData = d->dataset->GetBundle(bundleName.toLatin1().constData()).Bundle;
-
-    if (!bundleData)
-        return;
-
-    if (bundleData->GetPointData()->HasArray("Tensors"))
-    {
-        // Specific TTK case
-        itk::FiberBundleStatisticsCalculator::Pointer statCalculator = itk::FiberBundleStatisticsCalculator::New();
-        statCalculator->SetInput (bundleData);
-
-        try
-        {
-            statCalculator->Compute();
-        }
-        catch(itk::ExceptionObject &e)
-        {
-            dtkDebug() << e.GetDescription();
-            return;
-        }
+    medFiberBundleStatistics statistics = d->bundleStatistics(bundleName);
 
-        double meanVal, minVal, maxVal, varVal;
-        statCalculator->GetADCStatistics(meanVal, minVal, maxVal, varVal);
-        mean["ADC"] = meanVal;
-        min["ADC"] = minVal;
-        max["ADC"] = maxVal;
-        var["ADC"] = varVal;
-
-        statCalculator->GetFAStatistics(meanVal, minVal, maxVal, varVal);
-        mean["FA"] = meanVal;
-        min["FA"] = minVal;
-        max["FA"] = maxVal;
-        var["FA"] = varVal;
-    }
-
-    vtkPointData *bundlePointData = bundleData->GetPointData();
-    unsigned int numberOfArrays = bundlePointData->GetNumberOfArrays();
-    vtkPoints* points = bundleData->GetPoints();
-    vtkCellArray* lines = bundleData->GetLines();
-    lines->InitTraversal();
-
-    for (unsigned int i = 0;i < numberOfArrays;++i)
+    for (QString arrayName : statistics.arrays.keys())
     {
-        // To do, explore fibers one by one, compute mean value on each fiber, then deduce all stats
-        // Put them inside maps
-        QString arrayName = bundlePointData->GetArrayName(i);
-        vtkDataArray *imageCoefficients = bundlePointData->GetArray(i);
-        unsigned int numComponents = imageCoefficients->GetNumberOfComponents();
-
-        if (numComponents != 1)
-            continue;
-
-        vtkIdType  npts  = 0;
-        vtkIdType* ptids = 0;
-        vtkIdType test = lines->GetNextCell (npts, ptids);
-
-        double sumData = 0;
-        double squareSumData = 0;
-        double minValue = HUGE_VAL;
-        double maxValue = - HUGE_VAL;
-        unsigned int numberOfLines = 0;
-
-        // go over lines, each cell is a line
-        while (test)
-        {
-            double meanFiberData = 0;
-
-            for (int k=0; k<npts; k++)
-            {
-                double pt[3];
-                points->GetPoint (ptids[k], pt);
-
-                double tupleValue = 0;
-                imageCoefficients->GetTuple(ptids[k], &tupleValue);
-
-                if (k == 0)
-                {
-                    minValue = tupleValue;
-                    maxValue = tupleValue;
-                }
-
-                if (minValue > tupleValue)
-                    minValue = tupleValue;
-
-                if (maxValue < tupleValue)
-                    maxValue = tupleValue;
-
-                meanFiberData += tupleValue;
-            }
-
-            meanFiberData /= npts;
-
-            if (minValue > meanFiberData)
-                minValue = meanFiberData;
-
-            if (maxValue < meanFiberData)
-                maxValue = meanFiberData;
-
-            sumData += meanFiberData;
-            squareSumData += meanFiberData * meanFiberData;
-            ++numberOfLines;
-
-            test = lines->GetNextCell (npts, ptids);
-        }
-
-        if (std::isfinite (sumData / numberOfLines))
-        {
-            mean[arrayName] = sumData / numberOfLines;
-            min[arrayName] = minValue;
-            max[arrayName] = maxValue;
-            var[arrayName] = 0;
-            if (numberOfLines > 1)
-                var[arrayName] = (squareSumData - sumData * sumData / numberOfLines) / (numberOfLines - 1.0);
-        }
+        mean[arrayName] = statistics.arrays[arrayName].mean;
+        min[arrayName]  = statistics.arrays[arrayName].min;
+        max[arrayName]  = statistics.arrays[arrayName].max;
+        var[arrayName]  = statistics.arrays[arrayName].var;
     }
 }
 
@@ -982,73 +901,12 @@ void medVtkFibersDataInteractor::computeBundleLengthStatistics (const QString &n
                                                                 double &max,
                                                                 double &var)
 {
-    vtkPolyData *bundleData = d->dataset->GetBundle(name.toLatin1().constData()).Bundle;
-
-    if (!bundleData)
-        return;
-
-    vtkPoints* points = bundleData->GetPoints();
-    vtkCellArray* lines = bundleData->GetLines();
-
-    lines->InitTraversal();
-    vtkIdType  npts  = 0;
-    vtkIdType* ptids = 0;
-    vtkIdType test = lines->GetNextCell (npts, ptids);
+    medFiberBundleStatistics statistics = d->bundleStatistics(name);
 
-    double sumData = 0;
-    double squareSumData = 0;
-    double minValue = HUGE_VAL;
-    double maxValue = - HUGE_VAL;
-    unsigned int numberOfLines = 0;
-
-    // go over lines, each cell is a line
-    while (test)
-    {
-        double lengthFiber = 0;
-
-        for (int k=1; k<npts; k++)
-        {
-            double pt1[3];
-            double pt2[3];
-            points->GetPoint (ptids[k-1], pt1);
-            points->GetPoint (ptids[k], pt2);
-
-            double normDiff = 0;
-            for (unsigned int l = 0;l < 3;++l)
-                normDiff += (pt2[l] - pt1[l])*(pt2[l] - pt1[l]);
-
-            lengthFiber += sqrt(normDiff);
-        }
-
-        if (minValue > lengthFiber)
-            minValue = lengthFiber;
-
-        if (maxValue < lengthFiber)
-            maxValue = lengthFiber;
-
-        sumData += lengthFiber;
-        squareSumData += lengthFiber * lengthFiber;
-        ++numberOfLines;
-
-        test = lines->GetNextCell (npts, ptids);
-    }
-
-    if (std::isfinite (sumData / numberOfLines))
-    {
-        mean = sumData / numberOfLines;
-        min = minValue;
-        max = maxValue;
-        var = 0;
-        if (numberOfLines > 1)
-            var = (squareSumData - sumData * sumData / numberOfLines) / (numberOfLines - 1.0);
-    }
-    else
-    {
-        mean = 0;
-        min = 0;
-        max = 0;
-        var = 0;
-    }
+    mean = statistics.length.mean;
+    min  = statistics.length.min;
+    max  = statistics.length.max;
+    var  = statistics.length.var;
 }
 
 void medVtkFibersDataInteractor::bundleLengthStatistics(const QString &name,
@@ -1057,27 +915,12 @@ void medVtkFibersDataInteractor::bundleLengthStatistics(const QString &name,
                                                     double &max,
                                                     double &var)
 {
-    if (!d->meanLengthList.contains(name)) {
-        this->computeBundleLengthStatistics(name, mean, min, max, var);
-        d->meanLengthList[name] = mean;
-        d->minLengthList[name] = min;
-        d->maxLengthList[name] = max;
-        d->varLengthList[name] = var;
-    }
-    else {
-        mean = d->meanLengthList[name];
-        min  = d->minLengthList[name];
-        max  = d->maxLengthList[name];
-        var  = d->varLengthList[name];
-    }
+    this->computeBundleLengthStatistics(name, mean, min, max, var);
 }
 
 void medVtkFibersDataInteractor::clearStatistics(void)
 {
-    d->meanLengthList.clear();
-    d->minLengthList.clear();
-    d->maxLengthList.clear();
-    d->varLengthList.clear();
+    d->statistics.clear();
 }
 
 
@@ -1156,6 +999,33 @@ void medVtkFibersDataInteractor::validateBundling()
 }
 
 
+namespace
+{
+void fillStatisticsItems(QStandardItem *item, const medFiberBundleStatistics &statistics)
+{
+    QList<QPair<QString, medFiberBundleStatistics::Values> > rows;
+    for (QString key : statistics.arrays.keys())
+    {
+        rows.append(qMakePair(key + ": ", statistics.arrays[key]));
+    }
+    rows.append(qMakePair(QObject::tr("Length: "), statistics.length));
+
+    for (const QPair<QString, medFiberBundleStatistics::Values> &row : rows)
+    {
+        const medFiberBundleStatistics::Values &values = row.second;
+
+        QStandardItem *childItem = new QStandardItem (row.first + QString::number(values.mean));
+        childItem->setEditable(false);
+        childItem->appendRow(new QStandardItem (QObject::tr("mean: ")     + QString::number(values.mean)));
+        childItem->appendRow(new QStandardItem (QObject::tr("variance: ") + QString::number(values.var)));
+        childItem->appendRow(new QStandardItem (QObject::tr("min: ")      + QString::number(values.min)));
+        childItem->appendRow(new QStandardItem (QObject::tr("max: ")      + QString::number(values.max)));
+
+        item->appendRow(childItem);
+    }
+}
+}
+
 void medVtkFibersDataInteractor::addBundle (const QString &name, const QColor &color)
 {
     int row = d->bundlingModel->rowCount();
@@ -1166,40 +1036,54 @@ void medVtkFibersDataInteractor::addBundle (const QString &name, const QColor &c
     item->setEditable(true);
     item->setCheckState(Qt::Checked);
 
-    QMap <QString, double> meanData;
-    QMap <QString, double> minData;
-    QMap <QString, double> maxData;
-    QMap <QString, double> varData;
-
-    double meanLength = 0.0;
-    double minLength  = 0.0;
-    double maxLength  = 0.0;
-    double varLength  = 0.0;
-
-    this->bundleImageStatistics(name, meanData, minData, maxData, varData);
-    this->bundleLengthStatistics(name, meanLength, minLength, maxLength, varLength);
+    item->setData(name,Qt::UserRole+1);
 
-    for(QString key : meanData.keys())
+    vtkSmartPointer<vtkPolyData> bundle;
+    if (d->dataset)
+    {
+        bundle = d->dataset->GetBundle(name.toLatin1().constData()).Bundle;
+    }
+    if (bundle && d->statistics.contains(bundle) && d->statistics[bundle].modifiedTime == bundle->GetMTime())
     {
-        QStandardItem *childItem1 = new QStandardItem (key + ": " + QString::number(meanData[key]));
-        childItem1->setEditable(false);
-        childItem1->appendRow(new QStandardItem (tr("mean: ")     + QString::number(meanData[key])));
-        childItem1->appendRow(new QStandardItem (tr("variance: ") + QString::number(varData[key])));
-        childItem1->appendRow(new QStandardItem (tr("min: ")      + QString::number(minData[key])));
-        childItem1->appendRow(new QStandardItem (tr("max: ")      + QString::number(maxData[key])));
-
-        item->appendRow(childItem1);
+        fillStatisticsItems(item, d->statistics[bundle].statistics);
     }
+    else if (bundle)
+    {
+        // the statistics are computed in the background, and shown once available
+        item->appendRow(new QStandardItem (tr("Computing statistics...")));
+
+        vtkMTimeType modifiedTime = bundle->GetMTime();
+        QFutureWatcher<medFiberBundleStatistics> *watcher = new QFutureWatcher<medFiberBundleStatistics>(this);
+        connect(watcher, &QFutureWatcher<medFiberBundleStatistics>::finished, this, [this, watcher, bundle, modifiedTime]()
+        {
+            medFiberBundleStatistics statistics = watcher->result();
+            watcher->deleteLater();
 
-    QStandardItem *childItem2 = new QStandardItem (tr("Length: ") + QString::number(meanLength));
-    childItem2->setEditable(false);
-    childItem2->appendRow(new QStandardItem (tr("mean: ")     + QString::number(meanLength)));
-    childItem2->appendRow(new QStandardItem (tr("variance: ") + QString::number(varLength)));
-    childItem2->appendRow(new QStandardItem (tr("min: ")      + QString::number(minLength)));
-    childItem2->appendRow(new QStandardItem (tr("max: ")      + QString::number(maxLength)));
+            if (bundle->GetMTime() != modifiedTime)
+            {
+                return;
+            }
+
+            // the bundle may have been renamed, moved or removed meanwhile
+            for (int i = 0; i < d->bundlingModel->rowCount(); ++i)
+            {
+                QStandardItem *bundleItem = d->bundlingModel->item(i);
+                QString bundleName = bundleItem->data(Qt::UserRole+1).toString();
+                if (d->dataset && d->dataset->GetBundle(bundleName.toLatin1().constData()).Bundle == bundle.Get())
+                {
+                    d->statistics[bundle] = {modifiedTime, statistics};
+                    bundleItem->removeRows(0, bundleItem->rowCount());
+                    fillStatisticsItems(bundleItem, statistics);
+                    break;
+                }
+            }
+        });
+        watcher->setFuture(QtConcurrent::run([bundle]()
+        {
+            return medFiberBundleStatistics::compute(bundle);
+        }));
+    }
 
-    item->appendRow(childItem2);
-    item->setData(name,Qt::UserRole+1);
 
     d->bundlingModel->setItem(row, item);
 
@@ -1583,6 +1467,10 @@ void medVtkFibersDataInteractor::removeCurrentBundle()
     d->view2d->RemoveLayerActor(d->manager->GetBundleActor(bundleName.toLatin1().constData()),d->view->layer(d->data));
     d->view3d->GetRenderer()->RemoveActor(d->manager->GetBundleActor(bundleName.toLatin1().constData()));
     
+    if (d->dataset)
+    {
+        d->statistics.remove(d->dataset->GetBundle(bundleName.toLatin1().constData()).Bundle);
+    }
     d->manager->RemoveBundle(bundleName.toLatin1().constData());
     
     // TO DO : better handle bundle list: how to remove metadata from object ?
@@ -93,7 +93,7 @@ public:
 
     /**
      * Triggers the computation of image related statistics of a fiber bundle.
-     * An internal call to computeBundleImageStatistics() is made.
+     * Values are cached until the bundle is modified.
      * @param name identifies the fiber bundle
      * @param mean mean bundle image related values
      * @param min  minimum bundle image related values
@@ -108,8 +108,8 @@ public:
 
     /**
      * Triggers the computation of the length statistics of a fiber bundle.
-     * An internal call to computeBundleLengthtatistics() is made. Values
-     * are cached for faster subsequent access to Length statistics.
+     * An internal call to computeBundleLengthStatistics() is made. Values
+     * are cached until the bundle is modified.
      * @param name identifies the fiber bundle
      * @param mean mean bundle Length value
      * @param min  minimum bundle Length value
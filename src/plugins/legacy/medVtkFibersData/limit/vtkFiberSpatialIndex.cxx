@@ -0,0 +1,421 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include "vtkFiberSpatialIndex.h"
+
+#include <vtkCellArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // segments per chunk, and chunks per leaf of the hierarchy
+  const vtkIdType ChunkSegments = 8;
+  const vtkIdType LeafChunks = 4;
+
+  bool BoxesIntersect (const float bounds[6], const double box[6])
+  {
+    return bounds[0] <= box[1] && bounds[1] >= box[0] &&
+           bounds[2] <= box[3] && bounds[3] >= box[2] &&
+           bounds[4] <= box[5] && bounds[5] >= box[4];
+  }
+
+  bool BoxContains (const double box[6], const float bounds[6])
+  {
+    return bounds[0] >= box[0] && bounds[1] <= box[1] &&
+           bounds[2] >= box[2] && bounds[3] <= box[3] &&
+           bounds[4] >= box[4] && bounds[5] <= box[5];
+  }
+
+  // float bounds rounded outwards, so that the tests above stay conservative
+  void StoreBounds (const double bounds[6], float stored[6])
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      stored[2*i]   = std::nextafter (static_cast<float>(bounds[2*i]),   -std::numeric_limits<float>::infinity());
+      stored[2*i+1] = std::nextafter (static_cast<float>(bounds[2*i+1]),  std::numeric_limits<float>::infinity());
+    }
+  }
+}
+
+vtkStandardNewMacro(vtkFiberSpatialIndex);
+
+vtkFiberSpatialIndex::vtkFiberSpatialIndex()
+{
+  this->Input = 0;
+}
+
+vtkFiberSpatialIndex::~vtkFiberSpatialIndex()
+{
+  if (this->Input)
+    this->Input->Delete();
+}
+
+void vtkFiberSpatialIndex::SetInput (vtkPolyData *fibers)
+{
+  if (this->Input == fibers)
+    return;
+
+  if (this->Input)
+    this->Input->Delete();
+
+  this->Input = fibers;
+
+  if (this->Input)
+    this->Input->Register (this);
+
+  this->Modified();
+}
+
+vtkIdType vtkFiberSpatialIndex::GetNumberOfFibers()
+{
+  this->UpdateFibers();
+  return static_cast<vtkIdType>(this->FiberOffsets.size());
+}
+
+void vtkFiberSpatialIndex::InitializeSelection (Selection &selection, vtkIdType numberOfFibers, bool selected)
+{
+  selection.assign ((numberOfFibers + 63) / 64, selected ? ~uint64_t(0) : uint64_t(0));
+}
+
+void vtkFiberSpatialIndex::UpdateFibers()
+{
+  if (this->FibersTime > this->GetMTime() && this->Input && this->FibersTime > this->Input->GetMTime())
+    return;
+
+  this->FiberOffsets.clear();
+
+  vtkCellArray *lines = this->Input ? this->Input->GetLines() : 0;
+  if (lines)
+  {
+    this->FiberOffsets.reserve (lines->GetNumberOfCells());
+    const vtkIdType *connectivity = lines->GetPointer();
+    const vtkIdType size = lines->GetNumberOfConnectivityEntries();
+    for (vtkIdType offset = 0; offset < size; offset += connectivity[offset] + 1)
+    {
+      this->FiberOffsets.push_back (offset);
+    }
+  }
+
+  this->FibersTime.Modified();
+}
+
+/**
+   Chunks of consecutive segments share their end points, so that every
+   point of a fiber belongs to a chunk.
+ */
+void vtkFiberSpatialIndex::UpdateHierarchy()
+{
+  this->UpdateFibers();
+  if (this->HierarchyTime > this->FibersTime)
+    return;
+
+  this->Chunks.clear();
+  this->Nodes.clear();
+
+  vtkPoints *points = this->Input ? this->Input->GetPoints() : 0;
+  if (points && !this->FiberOffsets.empty())
+  {
+    const vtkIdType *connectivity = this->Input->GetLines()->GetPointer();
+
+    for (vtkIdType fiber = 0; fiber < static_cast<vtkIdType>(this->FiberOffsets.size()); fiber++)
+    {
+      const vtkIdType offset = this->FiberOffsets[fiber];
+      const vtkIdType npts = connectivity[offset];
+
+      for (vtkIdType first = 0; first < npts; first += ChunkSegments)
+      {
+        Chunk chunk;
+        chunk.Fiber = fiber;
+        chunk.FirstPoint = offset + 1 + first;
+        chunk.NumberOfPoints = std::min (ChunkSegments + 1, npts - first);
+
+        double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+        for (vtkIdType k = 0; k < chunk.NumberOfPoints; k++)
+        {
+          double pt[3];
+          points->GetPoint (connectivity[chunk.FirstPoint + k], pt);
+          for (int i = 0; i < 3; i++)
+          {
+            bounds[2*i]   = std::min (bounds[2*i],   pt[i]);
+            bounds[2*i+1] = std::max (bounds[2*i+1], pt[i]);
+          }
+        }
+        StoreBounds (bounds, chunk.Bounds);
+        this->Chunks.push_back (chunk);
+
+        if (first + ChunkSegments >= npts - 1)
+          break;
+      }
+    }
+
+    if (!this->Chunks.empty())
+    {
+      this->Nodes.reserve (2 * this->Chunks.size() / LeafChunks + 1);
+      this->BuildNode (0, static_cast<vtkIdType>(this->Chunks.size()));
+    }
+  }
+
+  this->HierarchyTime.Modified();
+}
+
+/**
+   Splits the chunks at the median of their centers along the largest
+   extent of the centers.
+ */
+int vtkFiberSpatialIndex::BuildNode (vtkIdType first, vtkIdType count)
+{
+  const int index = static_cast<int>(this->Nodes.size());
+  this->Nodes.push_back (Node());
+
+  float bounds[6] = { VTK_FLOAT_MAX, -VTK_FLOAT_MAX, VTK_FLOAT_MAX, -VTK_FLOAT_MAX, VTK_FLOAT_MAX, -VTK_FLOAT_MAX };
+  float centers[6] = { VTK_FLOAT_MAX, -VTK_FLOAT_MAX, VTK_FLOAT_MAX, -VTK_FLOAT_MAX, VTK_FLOAT_MAX, -VTK_FLOAT_MAX };
+  for (vtkIdType c = first; c < first + count; c++)
+  {
+    const float *b = this->Chunks[c].Bounds;
+    for (int i = 0; i < 3; i++)
+    {
+      bounds[2*i]   = std::min (bounds[2*i],   b[2*i]);
+      bounds[2*i+1] = std::max (bounds[2*i+1], b[2*i+1]);
+      const float center = 0.5f * (b[2*i] + b[2*i+1]);
+      centers[2*i]   = std::min (centers[2*i],   center);
+      centers[2*i+1] = std::max (centers[2*i+1], center);
+    }
+  }
+
+  Node &node = this->Nodes[index];
+  std::copy (bounds, bounds + 6, node.Bounds);
+  node.FirstChunk = first;
+  node.NumberOfChunks = count;
+  node.RightChild = -1;
+
+  if (count <= LeafChunks)
+    return index;
+
+  int axis = 0;
+  for (int i = 1; i < 3; i++)
+  {
+    if (centers[2*i+1] - centers[2*i] > centers[2*axis+1] - centers[2*axis])
+      axis = i;
+  }
+
+  const vtkIdType half = count / 2;
+  std::nth_element (this->Chunks.begin() + first, this->Chunks.begin() + first + half, this->Chunks.begin() + first + count,
+                    [axis] (const Chunk &a, const Chunk &b)
+                    {
+                      return a.Bounds[2*axis] + a.Bounds[2*axis+1] < b.Bounds[2*axis] + b.Bounds[2*axis+1];
+                    });
+
+  this->BuildNode (first, half);
+  const int right = this->BuildNode (first + half, count - half);
+  // the vector may have been reallocated by the children
+  this->Nodes[index].RightChild = right;
+
+  return index;
+}
+
+void vtkFiberSpatialIndex::FindFibersInBox (const double bounds[6], Selection &selection)
+{
+  this->UpdateHierarchy();
+  InitializeSelection (selection, static_cast<vtkIdType>(this->FiberOffsets.size()), false);
+
+  if (this->Nodes.empty())
+    return;
+
+  vtkPoints *points = this->Input->GetPoints();
+  const vtkIdType *connectivity = this->Input->GetLines()->GetPointer();
+
+  std::vector<int> stack (1, 0);
+  while (!stack.empty())
+  {
+    const Node &node = this->Nodes[stack.back()];
+    const int nodeIndex = stack.back();
+    stack.pop_back();
+
+    if (!BoxesIntersect (node.Bounds, bounds))
+      continue;
+
+    const bool inside = BoxContains (bounds, node.Bounds);
+    if (!inside && node.RightChild >= 0)
+    {
+      stack.push_back (node.RightChild);
+      stack.push_back (nodeIndex + 1);
+      continue;
+    }
+
+    for (vtkIdType c = node.FirstChunk; c < node.FirstChunk + node.NumberOfChunks; c++)
+    {
+      const Chunk &chunk = this->Chunks[c];
+      if (IsSelected (selection, chunk.Fiber))
+        continue;
+
+      if (inside || BoxContains (bounds, chunk.Bounds))
+      {
+        Select (selection, chunk.Fiber);
+        continue;
+      }
+
+      if (!BoxesIntersect (chunk.Bounds, bounds))
+        continue;
+
+      for (vtkIdType k = 0; k < chunk.NumberOfPoints; k++)
+      {
+        double pt[3];
+        points->GetPoint (connectivity[chunk.FirstPoint + k], pt);
+        if (pt[0] >= bounds[0] && pt[0] <= bounds[1] &&
+            pt[1] >= bounds[2] && pt[1] <= bounds[3] &&
+            pt[2] >= bounds[4] && pt[2] <= bounds[5])
+        {
+          Select (selection, chunk.Fiber);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void vtkFiberSpatialIndex::UpdateVoxels (vtkImageData *mask, vtkMatrix4x4 *directionMatrix)
+{
+  this->UpdateFibers();
+
+  std::vector<double> geometry;
+  int *dim = mask->GetDimensions();
+  double *origin = mask->GetOrigin();
+  double *spacing = mask->GetSpacing();
+  geometry.insert (geometry.end(), dim, dim + 3);
+  geometry.insert (geometry.end(), origin, origin + 3);
+  geometry.insert (geometry.end(), spacing, spacing + 3);
+
+  vtkMatrix4x4 *t_direction = vtkMatrix4x4::New();
+  t_direction->Identity();
+  if (directionMatrix)
+  {
+    vtkMatrix4x4::Invert (directionMatrix, t_direction);
+  }
+  geometry.insert (geometry.end(), &t_direction->Element[0][0], &t_direction->Element[0][0] + 16);
+
+  if (this->VoxelsTime > this->FibersTime && geometry == this->VoxelGeometry)
+  {
+    t_direction->Delete();
+    return;
+  }
+
+  const size_t numberOfVoxels = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+  this->VoxelOffsets.assign (numberOfVoxels + 1, 0);
+  this->VoxelFibers.clear();
+
+  vtkPoints *points = this->Input ? this->Input->GetPoints() : 0;
+  const vtkIdType *connectivity = this->FiberOffsets.empty() ? 0 : this->Input->GetLines()->GetPointer();
+
+  auto voxel = [&] (vtkIdType pointId) -> long long
+  {
+    double pt[4];
+    points->GetPoint (pointId, pt);
+    pt[3] = 1.0;
+    for (int i = 0; i < 3; i++)
+    {
+      pt[i] -= origin[i];
+    }
+    t_direction->MultiplyPoint (pt, pt);
+
+    int c[3];
+    for (int i = 0; i < 3; i++)
+    {
+      c[i] = (int)( vtkMath::Round( pt[i]/spacing[i] ) );
+      if (c[i] < 0 || c[i] >= dim[i])
+        return -1;
+    }
+    return c[0] + static_cast<long long>(dim[0]) * (c[1] + static_cast<long long>(dim[1]) * c[2]);
+  };
+
+  // counting pass then filling pass, a fiber is listed once per run of
+  // consecutive points in a voxel
+  for (int pass = 0; pass < 2 && points && connectivity; pass++)
+  {
+    std::vector<size_t> next;
+    if (pass == 1)
+    {
+      for (size_t v = 0; v < numberOfVoxels; v++)
+      {
+        this->VoxelOffsets[v + 1] += this->VoxelOffsets[v];
+      }
+      this->VoxelFibers.resize (this->VoxelOffsets[numberOfVoxels]);
+      next.assign (this->VoxelOffsets.begin(), this->VoxelOffsets.end() - 1);
+    }
+
+    for (size_t fiber = 0; fiber < this->FiberOffsets.size(); fiber++)
+    {
+      const vtkIdType offset = this->FiberOffsets[fiber];
+      long long last = -1;
+      for (vtkIdType k = 0; k < connectivity[offset]; k++)
+      {
+        const long long v = voxel (connectivity[offset + 1 + k]);
+        if (v < 0 || v == last)
+          continue;
+        last = v;
+
+        if (pass == 0)
+          this->VoxelOffsets[v + 1]++;
+        else
+          this->VoxelFibers[next[v]++] = static_cast<uint32_t>(fiber);
+      }
+    }
+  }
+
+  t_direction->Delete();
+
+  this->VoxelGeometry = geometry;
+  this->VoxelsTime.Modified();
+}
+
+void vtkFiberSpatialIndex::FindFibersInLabels (vtkImageData *mask, vtkMatrix4x4 *directionMatrix,
+                                               const bool usedLabels[256], std::vector<Selection> &selections)
+{
+  selections.assign (256, Selection());
+
+  if (!mask || mask->GetScalarType() != VTK_UNSIGNED_CHAR)
+  {
+    vtkErrorMacro (<< "Mask image must be of unsigned char type.");
+    return;
+  }
+
+  this->UpdateVoxels (mask, directionMatrix);
+
+  const vtkIdType numberOfFibers = static_cast<vtkIdType>(this->FiberOffsets.size());
+  const unsigned char *maskValues = static_cast<unsigned char *>(mask->GetScalarPointer());
+  const size_t numberOfVoxels = this->VoxelOffsets.size() - 1;
+
+  for (size_t v = 0; v < numberOfVoxels; v++)
+  {
+    const unsigned char label = maskValues[v];
+    if (!label || !usedLabels[label])
+      continue;
+
+    Selection &selection = selections[label];
+    if (selection.empty())
+      InitializeSelection (selection, std::max<vtkIdType>(numberOfFibers, 1), false);
+
+    for (size_t f = this->VoxelOffsets[v]; f < this->VoxelOffsets[v + 1]; f++)
+    {
+      Select (selection, this->VoxelFibers[f]);
+    }
+  }
+}
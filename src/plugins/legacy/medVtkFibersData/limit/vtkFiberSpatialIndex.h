@@ -0,0 +1,126 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <medVtkFibersDataPluginExport.h>
+
+#include <vtkObject.h>
+#include <vtkTimeStamp.h>
+
+#include <cstdint>
+#include <vector>
+
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkPolyData;
+
+/**
+   Spatial index of the lines of a fiber data set, used to select fibers
+   without going through all their points.
+
+   Boxes are looked up in a bounding volume hierarchy over chunks of
+   consecutive fiber segments. Label images are looked up in an inverted
+   index giving the fibers passing through each voxel, built for the
+   geometry of the image. Both are built on the first query following a
+   change of the input, the inverted index also when the image geometry
+   changes.
+
+   Selections hold one bit per fiber, in the order of the lines of the input.
+ */
+class MEDVTKFIBERSDATAPLUGIN_EXPORT vtkFiberSpatialIndex : public vtkObject
+{
+public:
+    static vtkFiberSpatialIndex *New();
+    vtkTypeMacro(vtkFiberSpatialIndex, vtkObject)
+
+    void PrintSelf (ostream& os, vtkIndent indent){}
+
+    typedef std::vector<uint64_t> Selection;
+
+    void SetInput (vtkPolyData *fibers);
+    vtkGetObjectMacro (Input, vtkPolyData)
+
+    vtkIdType GetNumberOfFibers();
+
+    /** Fibers having a point inside the box (xmin, xmax, ymin, ymax, zmin, zmax). */
+    void FindFibersInBox (const double bounds[6], Selection &selection);
+
+    /**
+       Fibers passing through the voxels of each label of the mask, which
+       must be an unsigned char image. The point to voxel mapping is the one of
+       vtkLimitFibersToROI. Selections are only filled for the labels present
+       in the mask for which usedLabels is true, the others are left empty.
+     */
+    void FindFibersInLabels (vtkImageData *mask, vtkMatrix4x4 *directionMatrix,
+                             const bool usedLabels[256], std::vector<Selection> &selections);
+
+    static void InitializeSelection (Selection &selection, vtkIdType numberOfFibers, bool selected);
+
+    static bool IsSelected (const Selection &selection, vtkIdType fiber)
+    {
+        return (selection[fiber >> 6] >> (fiber & 63)) & 1;
+    }
+
+    static void Select (Selection &selection, vtkIdType fiber)
+    {
+        selection[fiber >> 6] |= uint64_t(1) << (fiber & 63);
+    }
+
+protected:
+    vtkFiberSpatialIndex();
+    ~vtkFiberSpatialIndex();
+
+    void UpdateFibers();
+    void UpdateHierarchy();
+    void UpdateVoxels (vtkImageData *mask, vtkMatrix4x4 *directionMatrix);
+
+    int BuildNode (vtkIdType first, vtkIdType count);
+
+private:
+    vtkFiberSpatialIndex (const vtkFiberSpatialIndex&);
+    void operator=(const vtkFiberSpatialIndex&);
+
+    struct Chunk
+    {
+        float Bounds[6];
+        vtkIdType Fiber;
+        // in the connectivity of the lines
+        vtkIdType FirstPoint;
+        vtkIdType NumberOfPoints;
+    };
+
+    struct Node
+    {
+        float Bounds[6];
+        vtkIdType FirstChunk;
+        vtkIdType NumberOfChunks;
+        // the left child follows its parent
+        int RightChild;
+    };
+
+    vtkPolyData *Input;
+
+    // offset of each fiber in the connectivity of the lines
+    std::vector<vtkIdType> FiberOffsets;
+    vtkTimeStamp FibersTime;
+
+    std::vector<Chunk> Chunks;
+    std::vector<Node> Nodes;
+    vtkTimeStamp HierarchyTime;
+
+    // fibers of voxel v are VoxelFibers[VoxelOffsets[v]] to VoxelFibers[VoxelOffsets[v + 1] - 1]
+    std::vector<size_t> VoxelOffsets;
+    std::vector<uint32_t> VoxelFibers;
+    std::vector<double> VoxelGeometry;
+    vtkTimeStamp VoxelsTime;
+};
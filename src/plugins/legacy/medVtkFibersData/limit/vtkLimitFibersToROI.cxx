@@ -22,8 +22,9 @@
 #include <vtkCellArray.h>
 #include <vtkCellData.h>
 #include <vtkUnsignedCharArray.h>
+#include <vtkIdTypeArray.h>
 
-#include <vtkMath.h>
+#include <vtkFiberSpatialIndex.h>
 
 #include <algorithm>
 
@@ -42,6 +43,7 @@ vtkLimitFibersToROI::vtkLimitFibersToROI()
     this->BooleanOperationVector[i] = 2;
   }
   this->DirectionMatrix = 0;
+  this->SpatialIndex = vtkFiberSpatialIndex::New();
 }
 
 vtkLimitFibersToROI::~vtkLimitFibersToROI()
@@ -51,6 +53,8 @@ vtkLimitFibersToROI::~vtkLimitFibersToROI()
 
   if (this->DirectionMatrix)
     this->DirectionMatrix->Delete();
+
+  this->SpatialIndex->Delete();
 }
 
 
@@ -85,7 +89,10 @@ int vtkLimitFibersToROI::RequestData (vtkInformation *vtkNotUsed(request),
   {
     return 0;
   }
-  
+
+  // also used by the VOI selection downstream
+  this->SpatialIndex->SetInput (input);
+
   if (MaskImage == 0)
   {
     output->SetLines (lines);
@@ -100,184 +107,92 @@ int vtkLimitFibersToROI::RequestData (vtkInformation *vtkNotUsed(request),
   vtkUnsignedCharArray* newColors = vtkUnsignedCharArray::New();
   newColors->SetNumberOfComponents (3);
 
-  
-  int* dim        = MaskImage->GetDimensions();
-  double* origin  = MaskImage->GetOrigin();
-  double* spacing = MaskImage->GetSpacing();
-
   /**
-     Automatically extract labels (i.e. any scalar value except 0) contained
-     in MaskImage.
+     Algorithm: the spatial index gives, for each label of MaskImage (i.e.
+     any scalar value except 0) the fibers passing through it. Along with
+     the BooleanOperationVector, we determine if the fiber should be
+     retained or not.
   */
-  std::vector<int> Labels;
-  unsigned char*   MaskValues = (unsigned char*)MaskImage->GetScalarPointer();
-  
-  for (int i=0;i<MaskImage->GetNumberOfPoints();i++)
+  bool usedLabels[256];
+  for( unsigned int i=0; i<256; i++)
   {
-    int val = (int)(*MaskValues);
-    if (val>0)
-    {
-      bool IsInserted = false;
-      for (unsigned int j=0; j<Labels.size(); j++)
-      {
-        if ( Labels[j]==val )
-        {
-          IsInserted = true;
-          break;
-        }
-      }
-      
-      if ( !IsInserted )
-      {
-        Labels.push_back (val);
-      }
-    }
-
-    ++MaskValues;
+    usedLabels[i] = this->BooleanOperationVector[i] > 0;
   }
 
-  std::sort ( Labels.begin(), Labels.end() );
-  unsigned int numLabels = static_cast<unsigned int>(Labels.size());
-  
-  vtkDebugMacro ( << "Number Of Valid ROIs: " << numLabels );
-
-
+  std::vector<vtkFiberSpatialIndex::Selection> labelFibers;
+  this->SpatialIndex->FindFibersInLabels (MaskImage, this->DirectionMatrix, usedLabels, labelFibers);
 
-  // Test if the BooleanOperationVector size matches the max label
-  if( Labels[numLabels-1]>255 )
+  // labels are only looked up when used, any voxel of the mask tells which ones are present
+  std::vector<bool> presentLabels (256, false);
+  unsigned char* MaskValues = (unsigned char*)MaskImage->GetScalarPointer();
+  for (vtkIdType i=0; i<MaskImage->GetNumberOfPoints(); i++)
   {
-    vtkErrorMacro (<<"Error: The BoolearOperationVector variable has an incompatible length with the mask image.");
-    newColors->Delete();
-    return 0;
+    presentLabels[ MaskValues[i] ] = true;
   }
+  presentLabels[0] = false;
 
-
-
-  //reset the Scalar Pointer
-  MaskValues= (unsigned char*)MaskImage->GetScalarPointer();
-
-  
-  /**
-     Algorithm: For each fiber, we test the number of regions (i.e. labels)
-     it passes through. Along with the BooleanOperationVector, we determine
-     if the fiber should be retained or not.
-  */
-  
-  lines->InitTraversal();
-  
-  vtkIdType  npts  = 0;
-  vtkIdType* ptids = 0;
-  vtkIdType   test = lines->GetNextCell (npts, ptids);
-  int cellId = 0;
+  const int numLabels = static_cast<int>(std::count (presentLabels.begin(), presentLabels.end(), true));
+  vtkDebugMacro ( << "Number Of Valid ROIs: " << numLabels );
 
   char tmp[256];
-  snprintf (tmp, 256, "%d ROIs to process.", (int)Labels.size());
+  snprintf (tmp, 256, "%d ROIs to process.", numLabels);
   this->SetProgressText (tmp);
 
-  if( !Labels.size() )
+  if( !numLabels )
   {
     vtkWarningMacro( << "There is no label to process." );
+    newColors->Delete();
     return 1;
   }
-  
-    
-  this->UpdateProgress (0.0);
 
-  int iterProgress = 0;
-  int maxProgress  = lines->GetNumberOfCells();
-  int step         = maxProgress/100;
+  this->UpdateProgress (0.0);
 
+  // 0: nullptr
+  // 1: NOT
+  // 2: AND
+  vtkFiberSpatialIndex::Selection selection;
+  vtkFiberSpatialIndex::InitializeSelection (selection, lines->GetNumberOfCells(), true);
 
-  vtkMatrix4x4 *t_direction = vtkMatrix4x4::New();
-  t_direction->Identity();
-  if (this->DirectionMatrix)
+  for( unsigned int label=1; label<256; label++)
   {
-    vtkMatrix4x4::Invert (this->DirectionMatrix, t_direction);
-  }
- 
-  
-  // for All the Fibers 
-  while ( test )
-  {
-
-    //bool found = false;
-
-    std::vector<int> FiberRegions (numLabels, 0);
-    
-    // for All the points of the fiber
-    for (int k=0; k<npts; k++)
+    if( !presentLabels[label] || !usedLabels[label] )
     {
-      double pt[4];
-      points->GetPoint (ptids[k], pt);
-      pt[3] = 1.0;
-      
-      int c[3];
+      continue;
+    }
 
-      for (int i=0; i<3; i++)
+    const vtkFiberSpatialIndex::Selection &fibers = labelFibers[label];
+    for( size_t i=0; i<selection.size(); i++)
+    {
+      const uint64_t inRegion = fibers.empty() ? 0 : fibers[i];
+      if( this->BooleanOperationVector[label] == 1 )
       {
-	pt[i] -= origin[i];
+        selection[i] &= ~inRegion;
       }
-
-      t_direction->MultiplyPoint (pt, pt);
-
-      /*
-	c[0] = (int)( vtkMath::Round( (pt[0]-origin[0])/spacing[0]) );
-	c[1] = (int)( vtkMath::Round( (pt[1]-origin[1])/spacing[1]) );
-	c[2] = (int)( vtkMath::Round( (pt[2]-origin[2])/spacing[2]) );
-      */
-      c[0] = (int)( vtkMath::Round( pt[0]/spacing[0] ));
-      c[1] = (int)( vtkMath::Round( pt[1]/spacing[1] ));
-      c[2] = (int)( vtkMath::Round( pt[2]/spacing[2] ));
-      
-      if( c[0]>=0 && c[0]<dim[0] &&
-          c[1]>=0 && c[1]<dim[1] &&
-          c[2]>=0 && c[2]<dim[2] )
+      else
       {
-        
-        int index = c[0] + c[1]*dim[0] + c[2]*dim[0]*dim[1];
-        MaskValues += index;
-        int maskVal = (int)(*MaskValues);
-        MaskValues -= index;
-        
-
-        for( unsigned int i=0; i<numLabels; i++)
-        {
-          if( maskVal==Labels[i] )
-          {
-            FiberRegions[i]=1;
-            break;
-          }            
-        }
-
-        
+        selection[i] &= inRegion;
       }
     }
-    
-    bool insert = true;
-
-    // 0: nullptr
-    // 1: NOT
-    // 2: AND
-    
-    for( unsigned int i=0; i<numLabels; i++)
-    {
-      if( this->BooleanOperationVector[ Labels[i] ] > 0 )
-      {
-	if( this->BooleanOperationVector[ Labels[i] ] == 1 )
-	{
-	  insert = insert && !FiberRegions[i];
-	}
-	else
-	{
-	  insert = insert && FiberRegions[i];
-	}
-      }
-    }
-    
-    
-    if (insert)
+  }
+
+  vtkIdTypeArray* fiberIds = vtkIdTypeArray::New();
+  fiberIds->SetName ("FiberIds");
+  vtkIdTypeArray* inputFiberIds = vtkIdTypeArray::SafeDownCast (input->GetCellData()->GetArray ("FiberIds"));
+
+  lines->InitTraversal();
+
+  vtkIdType  npts  = 0;
+  vtkIdType* ptids = 0;
+  vtkIdType   test = lines->GetNextCell (npts, ptids);
+  vtkIdType cellId = 0;
+
+  // for All the Fibers
+  while ( test )
+  {
+    if (vtkFiberSpatialIndex::IsSelected (selection, cellId))
     {
       output->InsertNextCell(VTK_POLY_LINE, npts, ptids);
+      fiberIds->InsertNextValue (inputFiberIds ? inputFiberIds->GetValue (cellId) : cellId);
       if( allColors )
       {
         unsigned char fiberColor[3];
@@ -286,21 +201,10 @@ int vtkLimitFibersToROI::RequestData (vtkInformation *vtkNotUsed(request),
         newColors->InsertNextValue (fiberColor[1]);
         newColors->InsertNextValue (fiberColor[2]);
       }
-      
     }
-    
+
     test = lines->GetNextCell (npts, ptids);
     cellId++;
-    
-    iterProgress++;
-    if( step>0 )
-    {
-      if ( !(iterProgress%step) )
-      {
-        this->UpdateProgress (double(iterProgress)/double(maxProgress));
-      }
-    }
-    
   }
 
   if( allColors )
@@ -309,13 +213,13 @@ int vtkLimitFibersToROI::RequestData (vtkInformation *vtkNotUsed(request),
   }
   newColors->Delete();
 
-  t_direction->Delete();
-  
+  // lets the VOI selection downstream use the index of the input
+  output->GetCellData()->AddArray (fiberIds);
+  fiberIds->Delete();
+
   this->UpdateProgress (1.0);
-  
 
   return 1;
-  
 }
 
 void vtkLimitFibersToROI::SetBooleanOperation(int id, int value)
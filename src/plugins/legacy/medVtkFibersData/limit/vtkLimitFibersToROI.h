@@ -19,6 +19,8 @@
 #include <vtkMatrix4x4.h>
 #include <vector>
 
+class vtkFiberSpatialIndex;
+
 
 class MEDVTKFIBERSDATAPLUGIN_EXPORT vtkLimitFibersToROI: public vtkPolyDataAlgorithm
 {
@@ -56,6 +58,16 @@ public:
         return this->BooleanOperationVector;
     }
 
+    /**
+     Index of the input fibers, built on the first execution following a
+     change of the input. The output has a FiberIds cell array giving the
+     fiber of the input of each line.
+   */
+    vtkFiberSpatialIndex* GetSpatialIndex() const
+    {
+        return this->SpatialIndex;
+    }
+
 protected:
     vtkLimitFibersToROI();
     ~vtkLimitFibersToROI();
@@ -69,6 +81,7 @@ private:
 
     vtkImageData* MaskImage;
     vtkMatrix4x4* DirectionMatrix;
+    vtkFiberSpatialIndex* SpatialIndex;
 
     int BooleanOperationVector[256];
 };
@@ -22,6 +22,9 @@
 #include <vtkPolyLine.h>
 #include <vtkCellData.h>
 #include <vtkUnsignedCharArray.h>
+#include <vtkIdTypeArray.h>
+
+#include <vtkFiberSpatialIndex.h>
 
 
 vtkStandardNewMacro(vtkLimitFibersToVOI);
@@ -35,6 +38,50 @@ vtkLimitFibersToVOI::vtkLimitFibersToVOI()
   m_ZMin = 0.0;
   m_ZMax = -1.0;
   BooleanOperation = 1;
+  SourceIndex = 0;
+  SpatialIndex = vtkFiberSpatialIndex::New();
+}
+
+vtkLimitFibersToVOI::~vtkLimitFibersToVOI()
+{
+  this->SetSourceIndex (0);
+  this->SpatialIndex->Delete();
+}
+
+/**
+   Fibers of the input having a point in the VOI. The index of the source
+   is used when the input holds its fibers, either directly or through a
+   FiberIds cell array.
+ */
+void vtkLimitFibersToVOI::FindFibersInVOI (vtkPolyData *input, vtkFiberSpatialIndex::Selection &selection)
+{
+  const double bounds[6] = { m_XMin, m_XMax, m_YMin, m_YMax, m_ZMin, m_ZMax };
+
+  vtkPolyData *source = this->SourceIndex ? this->SourceIndex->GetInput() : 0;
+  if (source && source->GetLines() == input->GetLines() && source->GetPoints() == input->GetPoints())
+  {
+    this->SourceIndex->FindFibersInBox (bounds, selection);
+    return;
+  }
+
+  vtkIdTypeArray *fiberIds = vtkIdTypeArray::SafeDownCast (input->GetCellData()->GetArray ("FiberIds"));
+  if (source && fiberIds && source->GetPoints() == input->GetPoints())
+  {
+    vtkFiberSpatialIndex::Selection sourceSelection;
+    this->SourceIndex->FindFibersInBox (bounds, sourceSelection);
+
+    const vtkIdType numberOfFibers = fiberIds->GetNumberOfTuples();
+    vtkFiberSpatialIndex::InitializeSelection (selection, numberOfFibers, false);
+    for (vtkIdType i = 0; i < numberOfFibers; i++)
+    {
+      if (vtkFiberSpatialIndex::IsSelected (sourceSelection, fiberIds->GetValue (i)))
+        vtkFiberSpatialIndex::Select (selection, i);
+    }
+    return;
+  }
+
+  this->SpatialIndex->SetInput (input);
+  this->SpatialIndex->FindFibersInBox (bounds, selection);
 }
 
 
@@ -102,24 +149,13 @@ int vtkLimitFibersToVOI::RequestData (vtkInformation *vtkNotUsed(request),
   unsigned char *fiberColor = 0;
   if( allColors )
     fiberColor = new unsigned char[allColors->GetNumberOfComponents()];
-  
-  
-  while( test!=0 )
-  {
-    bool found = 0;
 
+  vtkFiberSpatialIndex::Selection selection;
+  this->FindFibersInVOI (input, selection);
 
-    for( int i=0; i<npt; i++)
-    {
-      double* pt = points->GetPoint (pto[i]);
-      if( pt[0]>=m_XMin && pt[0]<=m_XMax &&
-          pt[1]>=m_YMin && pt[1]<=m_YMax &&
-          pt[2]>=m_ZMin && pt[2]<=m_ZMax )
-      {
-        found = true;
-        break;
-      }
-    }
+  while( test!=0 )
+  {
+    bool found = vtkFiberSpatialIndex::IsSelected (selection, cellId);
 
     if ( ( found && this->GetBooleanOperation() ) ||
          (!found && !this->GetBooleanOperation() ) )
@@ -17,6 +17,8 @@
 #include <vtkPolyDataAlgorithm.h>
 #include <vector>
 
+#include <vtkFiberSpatialIndex.h>
+
 class MEDVTKFIBERSDATAPLUGIN_EXPORT vtkLimitFibersToVOI: public vtkPolyDataAlgorithm
 {
 
@@ -62,14 +64,24 @@ class MEDVTKFIBERSDATAPLUGIN_EXPORT vtkLimitFibersToVOI: public vtkPolyDataAlgor
   }
 
   vtkGetMacro (BooleanOperation, int);
+
+  /**
+     Index of the fibers the input is selected from, such as the one of a
+     vtkLimitFibersToROI upstream. Otherwise, or when the input does not come
+     from its fibers, an index of the input is built.
+   */
+  vtkSetObjectMacro (SourceIndex, vtkFiberSpatialIndex);
+  vtkGetObjectMacro (SourceIndex, vtkFiberSpatialIndex);
   
   
  protected:
   vtkLimitFibersToVOI();
-  ~vtkLimitFibersToVOI(){};
+  ~vtkLimitFibersToVOI();
   
   // Usual data generation method
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+
+  void FindFibersInVOI (vtkPolyData *input, vtkFiberSpatialIndex::Selection &selection);
   
 
  private:
@@ -78,6 +90,9 @@ class MEDVTKFIBERSDATAPLUGIN_EXPORT vtkLimitFibersToVOI: public vtkPolyDataAlgor
 
   int BooleanOperation;
 
+  vtkFiberSpatialIndex *SourceIndex;
+  vtkFiberSpatialIndex *SpatialIndex;
+
   double m_XMin;
   double m_XMax;
   double m_YMin;
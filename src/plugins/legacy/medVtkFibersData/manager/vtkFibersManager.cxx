@@ -21,6 +21,7 @@
 #include <vtkPolyDataMapper.h>
 #include <vtkLimitFibersToVOI.h>
 #include <vtkLimitFibersToROI.h>
+#include <vtkFiberSpatialIndex.h>
 #include <vtkTubeFilter.h>
 #include <vtkRibbonFilter.h>
 #include <vtkPolyDataMapper.h>
@@ -330,6 +331,7 @@ void vtkFibersManager::Initialize()
   this->Callback->GetFiberLimiter()->GetOutput()->Initialize();
   this->Callback->GetROIFiberLimiter()->GetOutput()->Initialize();
   this->Callback->GetROIFiberLimiter()->RemoveAllInputs();
+  this->Callback->GetROIFiberLimiter()->GetSpatialIndex()->SetInput ( 0 );
   
   this->TubeFilter->GetOutput()->Initialize();
 
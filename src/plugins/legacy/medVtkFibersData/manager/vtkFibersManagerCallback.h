@@ -60,6 +60,7 @@ protected:
         this->FiberLimiter    = vtkLimitFibersToVOI::New();
         this->ROIFiberLimiter = vtkLimitFibersToROI::New();
         this->FiberLimiter->SetInputConnection ( this->ROIFiberLimiter->GetOutputPort() );
+        this->FiberLimiter->SetSourceIndex ( this->ROIFiberLimiter->GetSpatialIndex() );
     }
 
     ~vtkFibersManagerCallback()
@@ -21,6 +21,7 @@
 #include <medUtilities.h>
 #include <medVtkViewBackend.h>
 #include <polygonEventFilter.h>
+#include <polygonRasterizer.h>
 #include <polygonRoiToolBox.h>
 #include <vtkContourOverlayRepresentation.h>
 
@@ -391,164 +392,63 @@ void medTagRoiManager::createMaskWithLabel(int label)
     vtkImageView2D *view2d = static_cast<medVtkViewBackend*>(d->view->backend())->view2D;
     medAbstractImageView *v = qobject_cast<medAbstractImageView*>(d->view);
 
-    QList<QPair<vtkPolygon *, int>> polygons;
+    output = medAbstractDataFactory::instance()->create( "itkDataImageUChar3" );
+    medAbstractData * data = v->layerData(0);
+    medAbstractImageData *inputData = qobject_cast<medAbstractImageData*>(data);
+    initializeMaskData(inputData, output);
+    UChar3ImageType::Pointer m_itkMask = dynamic_cast<UChar3ImageType*>( reinterpret_cast<itk::Object*>(output->data()) );
+
+    unsigned int x1=0,y1=0;
+    switch (d->sliceOrientation)
+    {
+    case 0 :
+    {
+        x1=1;
+        y1=2;
+        break;
+    }
+    case 1 :
+    {
+        x1=0;
+        y1=2;
+        break;
+    }
+    case 2 :
+    {
+        x1=0;
+        y1=1;
+        break;
+    }
+    }
+
+    // all the contours are filled at once, slices in parallel
+    polygonRasterizer rasterizer(m_itkMask, d->sliceOrientation);
     for (polygonRoi *roi : d->rois)
     {
         vtkContourWidget * contour =  roi->getContour();
         vtkContourRepresentation * contourRep = contour->GetContourRepresentation();
         vtkPolyData * polydata = contourRep->GetContourRepresentationAsPolyData();
 
-        vtkPolygon *polygon = vtkPolygon::New();
-        vtkPoints * points = vtkPoints::New();
-
-        std::vector<vtkIdType> vec_ids;
-        double imagePreviousPoint[3] ={0,0,0};
-
-        unsigned int x1=0,y1=0,z1=0;
-        switch (d->sliceOrientation)
-        {
-        case 0 :
-        {
-            x1=1;
-            y1=2;
-            z1=0;
-            break;
-        }
-        case 1 :
-        {
-            x1=0;
-            y1=2;
-            z1=1;
-            break;
-        }
-        case 2 :
-        {
-            x1=0;
-            y1=1;
-            z1=2;
-            break;
-        }
-        }
-
+        QPolygonF polygon;
         for(int j=0;j<polydata->GetNumberOfPoints();j++)
         {
             double * point = polydata->GetPoint(j);
 
             int imagePoint[3];
-            double imagePointDouble[3];
-
             view2d->GetImageCoordinatesFromWorldCoordinates(point,imagePoint);
 
-            imagePointDouble[x1]= (double)imagePoint[x1];
-            imagePointDouble[y1]= (double)imagePoint[y1];
-
-            imagePointDouble[z1]= (double)roi->getIdSlice();
-
-            if (imagePointDouble[x1]==imagePreviousPoint[x1] && imagePointDouble[y1]==imagePreviousPoint[y1] && imagePointDouble[z1]==imagePreviousPoint[z1])
+            QPointF imagePoint2D(imagePoint[x1], imagePoint[y1]);
+            if (!polygon.isEmpty() && polygon.last() == imagePoint2D)
             {
                 continue;
             }
-
-            vec_ids.push_back(points->InsertNextPoint(imagePointDouble));
-
-            imagePreviousPoint[x1] = imagePointDouble[x1];
-            imagePreviousPoint[y1] = imagePointDouble[y1];
-            imagePreviousPoint[z1] = imagePointDouble[z1];
+            polygon << imagePoint2D;
         }
 
-        polygon->Initialize(points->GetNumberOfPoints(),&vec_ids[0],points);
-
-        polygons.append(QPair<vtkPolygon*,int>(polygon,roi->getIdSlice()));
+        rasterizer.addContour(roi->getIdSlice(), polygon, label+1);
     }
+    rasterizer.rasterize();
 
-    output = medAbstractDataFactory::instance()->create( "itkDataImageUChar3" );
-    medAbstractData * data = v->layerData(0);
-    medAbstractImageData *inputData = qobject_cast<medAbstractImageData*>(data);
-    initializeMaskData(inputData, output);
-    UChar3ImageType::Pointer m_itkMask = dynamic_cast<UChar3ImageType*>( reinterpret_cast<itk::Object*>(output->data()) );
-    for(QPair<vtkPolygon *, int> polygon : polygons)
-    {
-        double bounds[6];
-        polygon.first->GetBounds(bounds);
-        unsigned int x=0, y=0, z=0;
-        unsigned int bx=0, by=0;
-        unsigned int dimX=0, dimY=0;
-        switch (d->sliceOrientation)
-        {
-            case 0 :
-            {
-                dimX = inputData->yDimension();
-                dimY = inputData->zDimension();
-                x = 1;
-                y = 2;
-                z = 0;
-                bx = 2;
-                by = 4;
-                break;
-            }
-            case 1 :
-            {
-                dimX = inputData->xDimension();
-                dimY = inputData->zDimension();
-                x = 0;
-                y = 2;
-                z = 1;
-                bx = 0;
-                by = 4;
-                break;
-            }
-            case 2 :
-            {
-                dimX = inputData->xDimension();
-                dimY = inputData->yDimension();
-                x = 0;
-                y = 1;
-                z = 2;
-                bx = 0;
-                by = 2;
-                break;
-            }
-        }
-
-        // Qt rasterization
-        int nbPoints = polygon.first->GetPoints()->GetNumberOfPoints();
-        vtkPoints *pointsArray = polygon.first->GetPoints();
-        QPolygonF polygonF;
-        for(int i=0; i<nbPoints; i++)
-        {
-            polygonF << QPointF(pointsArray->GetPoint(i)[x], pointsArray->GetPoint(i)[y]);
-        }
-
-        QPainterPath path;
-        path.addPolygon(polygonF);
-
-        QBrush brush;
-        brush.setColor(Qt::white);
-        brush.setStyle(Qt::SolidPattern);
-
-        QImage imagePolygon(dimX,dimY,QImage::Format_RGB16);
-        imagePolygon.fill(Qt::black);
-        QPainter painter;
-        painter.begin(&imagePolygon);
-        painter.fillPath(path,brush);
-
-        for(int i=bounds[bx]; i<=bounds[bx+1]; i++)
-        {
-            for(int j=bounds[by]; j<=bounds[by+1]; j++)
-            {
-                QRgb val = imagePolygon.pixel(i,j);
-
-                if (val==qRgb(255,255,255))
-                {
-                    UChar3ImageType::IndexType index;
-                    index[x]=i;
-                    index[y]=j;
-                    index[z]=polygon.second;
-                    m_itkMask->SetPixel(index,label+1);
-                }
-            }
-        }
-    }
     QString name = (d->optName==QString())?QString(d->baseName):QString("%1_%2").arg(d->baseName).arg(d->optName);
     QString desc = QString("mask ") + name;
     medUtilities::setDerivedMetaData(output, inputData, desc);
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2019. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+#include <polygonRasterizer.h>
+
+#include <QMap>
+
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+struct Edge
+{
+    int firstRow;  // first row whose center is crossed by the edge
+    int lastRow;   // row after the last one
+    double x;      // abscissa at the center of the current row
+    double dxdy;
+    int winding;   // +1 downward, -1 upward
+};
+
+struct Crossing
+{
+    double x;
+    int winding;
+
+    bool operator<(const Crossing &other) const { return x < other.x; }
+};
+
+// first row, or column, whose center is at or after coordinate c
+inline int firstCenterAfter(double c)
+{
+    return static_cast<int>(std::ceil(c - 0.5));
+}
+
+}
+
+polygonRasterizer::polygonRasterizer(MaskType *mask, int sliceOrientation)
+    : m_mask(mask), m_fillRule(EvenOddFill)
+{
+    switch (sliceOrientation)
+    {
+        case 0:
+            m_axisX = 1; m_axisY = 2; m_axisZ = 0;
+            break;
+        case 1:
+            m_axisX = 0; m_axisY = 2; m_axisZ = 1;
+            break;
+        default:
+            m_axisX = 0; m_axisY = 1; m_axisZ = 2;
+            break;
+    }
+}
+
+void polygonRasterizer::setFillRule(FillRule rule)
+{
+    m_fillRule = rule;
+}
+
+void polygonRasterizer::addContour(int slice, const QPolygonF &contour, unsigned char value)
+{
+    if (contour.size() >= 3)
+    {
+        m_contours.append({slice, contour, value});
+    }
+}
+
+void polygonRasterizer::rasterize()
+{
+    // each slice is filled by a single thread, in the order its contours were added
+    QMap<int, QVector<int> > contoursBySlice;
+    for (int i = 0; i < m_contours.size(); ++i)
+    {
+        contoursBySlice[m_contours[i].slice].append(i);
+    }
+    QVector<QVector<int> > slices = contoursBySlice.values().toVector();
+
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    threader->ParallelizeArray(0, slices.size(), [&](itk::SizeValueType i)
+    {
+        for (int contour : slices[i])
+        {
+            rasterizeContour(m_contours[contour]);
+        }
+    }, nullptr);
+}
+
+void polygonRasterizer::rasterizeContour(const Contour &contour)
+{
+    const MaskType::RegionType region = m_mask->GetBufferedRegion();
+    const int width  = static_cast<int>(region.GetSize(m_axisX));
+    const int height = static_cast<int>(region.GetSize(m_axisY));
+    const int slice  = contour.slice - static_cast<int>(region.GetIndex(m_axisZ));
+    if (slice < 0 || slice >= static_cast<int>(region.GetSize(m_axisZ)))
+    {
+        return;
+    }
+
+    const MaskType::OffsetValueType *offsetTable = m_mask->GetOffsetTable();
+    const MaskType::OffsetValueType stepX = offsetTable[m_axisX];
+    const MaskType::OffsetValueType stepY = offsetTable[m_axisY];
+    unsigned char *sliceBuffer = m_mask->GetBufferPointer() + slice * offsetTable[m_axisZ];
+
+    // edges crossing at least one row center, bucketed by their first row
+    const QPolygonF &points = contour.points;
+    QVector<Edge> edges;
+    int firstRow = height;
+    int lastRow = 0;
+    for (int i = 0; i < points.size(); ++i)
+    {
+        QPointF p0 = points[i] - QPointF(region.GetIndex(m_axisX), region.GetIndex(m_axisY));
+        QPointF p1 = points[(i + 1) % points.size()] - QPointF(region.GetIndex(m_axisX), region.GetIndex(m_axisY));
+        int winding = 1;
+        if (p0.y() > p1.y())
+        {
+            std::swap(p0, p1);
+            winding = -1;
+        }
+
+        Edge edge;
+        edge.firstRow = std::max(0, firstCenterAfter(p0.y()));
+        edge.lastRow = std::min(height, firstCenterAfter(p1.y()));
+        if (edge.firstRow >= edge.lastRow)
+        {
+            continue;
+        }
+        edge.dxdy = (p1.x() - p0.x()) / (p1.y() - p0.y());
+        edge.x = p0.x() + (edge.firstRow + 0.5 - p0.y()) * edge.dxdy;
+        edge.winding = winding;
+
+        edges.append(edge);
+        firstRow = std::min(firstRow, edge.firstRow);
+        lastRow = std::max(lastRow, edge.lastRow);
+    }
+
+    std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.firstRow < b.firstRow; });
+
+    QVector<Edge> activeEdges;
+    QVector<Crossing> crossings;
+    int nextEdge = 0;
+    for (int row = firstRow; row < lastRow; ++row)
+    {
+        while (nextEdge < edges.size() && edges[nextEdge].firstRow == row)
+        {
+            activeEdges.append(edges[nextEdge++]);
+        }
+
+        crossings.clear();
+        for (int i = 0; i < activeEdges.size(); )
+        {
+            Edge &edge = activeEdges[i];
+            if (edge.lastRow <= row)
+            {
+                activeEdges.remove(i);
+                continue;
+            }
+            crossings.append({edge.x, edge.winding});
+            edge.x += edge.dxdy;
+            ++i;
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        unsigned char *rowBuffer = sliceBuffer + row * stepY;
+        int winding = 0;
+        for (int i = 0; i + 1 < crossings.size(); ++i)
+        {
+            winding += (m_fillRule == EvenOddFill) ? 1 : crossings[i].winding;
+            bool inside = (m_fillRule == EvenOddFill) ? (winding % 2 != 0) : (winding != 0);
+            if (!inside)
+            {
+                continue;
+            }
+
+            int first = std::max(0, firstCenterAfter(crossings[i].x));
+            int last = std::min(width, firstCenterAfter(crossings[i + 1].x));
+            if (stepX == 1)
+            {
+                std::fill(rowBuffer + first, rowBuffer + std::max(first, last), contour.value);
+            }
+            else
+            {
+                for (int column = first; column < last; ++column)
+                {
+                    rowBuffer[column * stepX] = contour.value;
+                }
+            }
+        }
+    }
+}
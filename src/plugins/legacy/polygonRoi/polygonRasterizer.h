@@ -0,0 +1,69 @@
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2019. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+#pragma once
+
+#include <polygonRoiPluginExport.h>
+
+#include <QPolygonF>
+#include <QVector>
+
+#include <itkImage.h>
+
+/**
+ * Fills closed contours drawn on the slices of a 3D mask, writing spans
+ * directly in the mask buffer. A pixel is filled when its center is inside
+ * the contour, as QPainter does. Slices are filled in parallel.
+ */
+class POLYGONROIPLUGIN_EXPORT polygonRasterizer
+{
+public:
+    typedef itk::Image<unsigned char, 3> MaskType;
+
+    enum FillRule
+    {
+        EvenOddFill,
+        NonZeroFill
+    };
+
+    /**
+     * @param sliceOrientation - axis normal to the slices of the contours
+     */
+    polygonRasterizer(MaskType *mask, int sliceOrientation);
+
+    void setFillRule(FillRule rule);
+
+    /**
+     * Adds a contour, in image index coordinates of its slice. Contours
+     * of a slice are filled in the order they were added.
+     */
+    void addContour(int slice, const QPolygonF &contour, unsigned char value);
+
+    void rasterize();
+
+private:
+    struct Contour
+    {
+        int slice;
+        QPolygonF points;
+        unsigned char value;
+    };
+
+    void rasterizeContour(const Contour &contour);
+
+    MaskType *m_mask;
+    unsigned int m_axisX;
+    unsigned int m_axisY;
+    unsigned int m_axisZ;
+    FillRule m_fillRule;
+    QVector<Contour> m_contours;
+};
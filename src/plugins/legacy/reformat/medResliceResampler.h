@@ -0,0 +1,201 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <itkImage.h>
+#include <itkMultiThreaderBase.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * Resamples a VTK image on an oblique grid, with linear interpolation, in a
+ * single multithreaded pass writing in the buffer of the ITK output image.
+ *
+ * The output grid is given in the coordinates of the reslice axes, as for
+ * vtkImageReslice: the point of the input sampled for an output voxel is the
+ * reslice axes matrix applied to the position of the voxel. The output image
+ * has the origin and spacing of the grid and an identity direction.
+ */
+template <typename PixelType>
+class medResliceResampler
+{
+public:
+    typedef itk::Image<PixelType, 3> ImageType;
+
+    static typename ImageType::Pointer resample(vtkImageData *input, vtkMatrix4x4 *resliceAxes,
+                                                const int size[3], const double origin[3], const double spacing[3],
+                                                double background)
+    {
+        typename ImageType::RegionType region;
+        typename ImageType::PointType outputOrigin;
+        typename ImageType::SpacingType outputSpacing;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            region.SetIndex(i, 0);
+            region.SetSize(i, std::max(size[i], 1));
+            outputOrigin[i] = origin[i];
+            outputSpacing[i] = spacing[i];
+        }
+
+        typename ImageType::Pointer output = ImageType::New();
+        output->SetRegions(region);
+        output->SetOrigin(outputOrigin);
+        output->SetSpacing(outputSpacing);
+        output->Allocate();
+
+        int inputExtent[6];
+        double inputOrigin[3], inputSpacing[3];
+        input->GetExtent(inputExtent);
+        input->GetOrigin(inputOrigin);
+        input->GetSpacing(inputSpacing);
+
+        int inputSize[3];
+        vtkIdType inputIncrements[3];
+        const int components = input->GetNumberOfScalarComponents();
+        inputIncrements[0] = components;
+        for (int i = 0; i < 3; ++i)
+        {
+            inputSize[i] = inputExtent[2 * i + 1] - inputExtent[2 * i] + 1;
+            if (i > 0)
+            {
+                inputIncrements[i] = inputIncrements[i - 1] * inputSize[i - 1];
+            }
+        }
+        const PixelType *inputBuffer = static_cast<const PixelType *>(input->GetScalarPointer());
+
+        // Continuous index in the input of the output voxel (x, y, z) is
+        // start + x * stepX + y * stepY + z * stepZ
+        double start[3], step[3][3];
+        for (int i = 0; i < 3; ++i)
+        {
+            const double scale = 1.0 / inputSpacing[i];
+            start[i] = (resliceAxes->GetElement(i, 3)
+                        + resliceAxes->GetElement(i, 0) * origin[0]
+                        + resliceAxes->GetElement(i, 1) * origin[1]
+                        + resliceAxes->GetElement(i, 2) * origin[2]
+                        - inputOrigin[i]) * scale - inputExtent[2 * i];
+            for (int j = 0; j < 3; ++j)
+            {
+                step[j][i] = resliceAxes->GetElement(i, j) * spacing[j] * scale;
+            }
+        }
+
+        const PixelType outside = toPixel(background);
+        PixelType *outputBuffer = output->GetBufferPointer();
+        const itk::SizeValueType rowLength = region.GetSize(0);
+        const itk::SizeValueType sliceLength = rowLength * region.GetSize(1);
+
+        itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+        threader->ParallelizeImageRegion<3>(region, [&](const typename ImageType::RegionType &threadRegion)
+        {
+            const itk::IndexValueType x0 = threadRegion.GetIndex(0);
+            const itk::SizeValueType count = threadRegion.GetSize(0);
+            for (itk::IndexValueType z = threadRegion.GetIndex(2); z < threadRegion.GetIndex(2) + static_cast<itk::IndexValueType>(threadRegion.GetSize(2)); ++z)
+            {
+                for (itk::IndexValueType y = threadRegion.GetIndex(1); y < threadRegion.GetIndex(1) + static_cast<itk::IndexValueType>(threadRegion.GetSize(1)); ++y)
+                {
+                    PixelType *row = outputBuffer + z * sliceLength + y * rowLength + x0;
+                    double point[3];
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        point[i] = start[i] + x0 * step[0][i] + y * step[1][i] + z * step[2][i];
+                    }
+
+                    for (itk::SizeValueType x = 0; x < count; ++x)
+                    {
+                        row[x] = interpolate(inputBuffer, inputSize, inputIncrements, point, outside);
+                        point[0] += step[0][0];
+                        point[1] += step[0][1];
+                        point[2] += step[0][2];
+                    }
+                }
+            }
+        }, nullptr);
+
+        return output;
+    }
+
+private:
+    static PixelType toPixel(double value)
+    {
+        if (std::is_integral<PixelType>::value)
+        {
+            value = std::floor(value + 0.5);
+            value = std::min(value, static_cast<double>(std::numeric_limits<PixelType>::max()));
+            value = std::max(value, static_cast<double>(std::numeric_limits<PixelType>::lowest()));
+        }
+        return static_cast<PixelType>(value);
+    }
+
+    // Voxels on each side of the continuous index c along an axis of n voxels
+    static bool locate(double c, int n, int &i0, int &i1, double &weight)
+    {
+        const double tolerance = 1e-3;
+        if (c < -tolerance || c > n - 1 + tolerance)
+        {
+            return false;
+        }
+        if (c <= 0 || n == 1)
+        {
+            i0 = i1 = 0;
+            weight = 0;
+        }
+        else if (c >= n - 1)
+        {
+            i0 = i1 = n - 1;
+            weight = 0;
+        }
+        else
+        {
+            i0 = static_cast<int>(c);
+            i1 = i0 + 1;
+            weight = c - i0;
+        }
+        return true;
+    }
+
+    static PixelType interpolate(const PixelType *buffer, const int size[3], const vtkIdType increments[3],
+                                 const double point[3], PixelType outside)
+    {
+        int i0[3], i1[3];
+        double w[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!locate(point[i], size[i], i0[i], i1[i], w[i]))
+            {
+                return outside;
+            }
+        }
+
+        const PixelType *p00 = buffer + i0[1] * increments[1] + i0[2] * increments[2];
+        const PixelType *p10 = buffer + i1[1] * increments[1] + i0[2] * increments[2];
+        const PixelType *p01 = buffer + i0[1] * increments[1] + i1[2] * increments[2];
+        const PixelType *p11 = buffer + i1[1] * increments[1] + i1[2] * increments[2];
+        const vtkIdType x0 = i0[0] * increments[0];
+        const vtkIdType x1 = i1[0] * increments[0];
+
+        const double v00 = p00[x0] + w[0] * (static_cast<double>(p00[x1]) - p00[x0]);
+        const double v10 = p10[x0] + w[0] * (static_cast<double>(p10[x1]) - p10[x0]);
+        const double v01 = p01[x0] + w[0] * (static_cast<double>(p01[x1]) - p01[x0]);
+        const double v11 = p11[x0] + w[0] * (static_cast<double>(p11[x1]) - p11[x0]);
+        const double v0 = v00 + w[1] * (v10 - v00);
+        const double v1 = v01 + w[1] * (v11 - v01);
+        return toPixel(v0 + w[2] * (v1 - v0));
+    }
+};
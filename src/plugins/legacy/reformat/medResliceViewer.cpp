@@ -11,9 +11,7 @@
 
 =========================================================================*/
 #include "medResliceViewer.h"
-#include "resampleProcess.h"
-
-#include <itkVTKImageToImageFilter.h>
+#include "medResliceResampler.h"
 
 #include <medAbstractDataFactory.h>
 #include <medAbstractLayeredView.h>
@@ -29,6 +27,7 @@
 #include <vtkGenericOpenGLRenderWindow.h>
 #include <vtkImageData.h>
 #include <vtkImageMapToColors.h>
+#include <vtkInformation.h>
 #include <vtkImageReslice.h>
 #include <vtkImageSlabReslice.h>
 #include <vtkMatrix4x4.h>
@@ -38,9 +37,11 @@
 #include <vtkRenderer.h>
 #include <vtkResliceCursor.h>
 #include <vtkResliceCursorActor.h>
+#include <vtkResliceCursorFastThickLineRepresentation.h>
 #include <vtkResliceCursorPolyDataAlgorithm.h>
 #include <vtkResliceCursorThickLineRepresentation.h>
 #include <vtkResliceCursorWidget.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTransform.h>
 #include <vtkRenderWindowInteractor.h>
 
@@ -303,11 +304,48 @@ void medResliceViewer::thickMode(int val)
     for (int i = 0; i < 3; i++)
     {
         riw[i]->SetThickMode(val);
+        if (val)
+        {
+            useFastSlabRepresentation(i);
+        }
         riw[i]->GetRenderer()->ResetCamera();
         riw[i]->Render();
     }
 }
 
+// vtkResliceImageViewer installs a vtkResliceCursorThickLineRepresentation in
+// thick mode, replace it the same way by one projecting with our slab kernel
+void medResliceViewer::useFastSlabRepresentation(int i)
+{
+    vtkResliceCursorWidget *widget = riw[i]->GetResliceCursorWidget();
+    vtkResliceCursorThickLineRepresentation *thickRep =
+            vtkResliceCursorThickLineRepresentation::SafeDownCast(widget->GetRepresentation());
+    if (!thickRep || vtkResliceCursorFastThickLineRepresentation::SafeDownCast(thickRep))
+    {
+        return;
+    }
+
+    vtkSmartPointer<vtkResliceCursor> cursor = riw[i]->GetResliceCursor();
+    vtkSmartPointer<vtkResliceCursorFastThickLineRepresentation> fastRep =
+            vtkSmartPointer<vtkResliceCursorFastThickLineRepresentation>::New();
+
+    int enabled = widget->GetEnabled();
+    widget->SetEnabled(0);
+
+    fastRep->GetResliceCursorActor()->GetCursorAlgorithm()->SetResliceCursor(cursor);
+    fastRep->GetResliceCursorActor()->GetCursorAlgorithm()->SetReslicePlaneNormal(riw[i]->GetSliceOrientation());
+    fastRep->SetLookupTable(thickRep->GetLookupTable());
+    double windowLevel[2];
+    thickRep->GetWindowLevel(windowLevel);
+    fastRep->SetWindowLevel(windowLevel[0], windowLevel[1]);
+    vtkImageSlabReslice::SafeDownCast(fastRep->GetReslice())->SetBlendMode(
+                vtkImageSlabReslice::SafeDownCast(thickRep->GetReslice())->GetBlendMode());
+
+    widget->SetRepresentation(fastRep);
+    riw[i]->SetResliceCursor(cursor);
+    widget->SetEnabled(enabled);
+}
+
 void medResliceViewer::blendMode(int val)
 {
     if (val)
@@ -374,7 +412,7 @@ void medResliceViewer::saveImage()
     vtkSmartPointer<vtkMatrix4x4> resliceMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
     calculateResliceMatrix(resliceMatrix);
 
-    vtkImageReslice *reslicerTop = vtkImageReslice::New();
+    vtkSmartPointer<vtkImageReslice> reslicerTop = vtkSmartPointer<vtkImageReslice>::New();
     reslicerTop->SetInputData(vtkViewData);
     reslicerTop->AutoCropOutputOn();
     reslicerTop->SetResliceAxes(resliceMatrix);
@@ -386,7 +424,8 @@ void medResliceViewer::saveImage()
     {
         reslicerTop->SetOutputSpacing(outputSpacing);
     }
-    reslicerTop->Update();
+    // The reslicer only gives the output geometry, the image is resampled by generateOutput()
+    reslicerTop->UpdateInformation();
 
     // Apply orientation changes
     switch (vtkViewData->GetScalarType())
@@ -723,21 +762,37 @@ void medResliceViewer::generateOutput(vtkImageReslice* reslicer, QString destTyp
 {
     typedef itk::Image<DATA_TYPE, 3> ImageType;
 
-    typedef itk::VTKImageToImageFilter<ImageType> FilterType;
-    typename FilterType::Pointer filter = FilterType::New();
-    filter->SetInput(reslicer->GetOutput());
-    filter->Update();
-
-    outputData = medAbstractDataFactory::instance()->createSmartPointer(destType);
-    outputData->setData(filter->GetOutput());
+    int extent[6], size[3];
+    double origin[3], spacing[3];
+    vtkInformation *outputInformation = reslicer->GetOutputInformation(0);
+    outputInformation->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+    outputInformation->Get(vtkDataObject::ORIGIN(), origin);
+    outputInformation->Get(vtkDataObject::SPACING(), spacing);
+    for (int i = 0; i < 3; i++)
+    {
+        size[i] = extent[2 * i + 1] - extent[2 * i] + 1;
+        origin[i] += extent[2 * i] * spacing[i];
+    }
 
-    // Apply resampling in pix
+    // Apply resampling in pix: same extent, with the requested number of voxels
     if (reformaTlbx->findChild<QComboBox*>("bySpacingOrDimension")->currentText() == "Dimension")
     {
-        applyResamplingPix();
+        for (int i = 0; i < 3; i++)
+        {
+            int dimension = static_cast<int>(outputSpacing[i]);
+            if (dimension > 0)
+            {
+                spacing[i] *= static_cast<double>(size[i]) / dimension;
+                size[i] = dimension;
+            }
+        }
     }
 
-    typename ImageType::Pointer outputImage = static_cast<itk::Image<DATA_TYPE, 3>*>(outputData->data());
+    // Interpolated once, from the data of the view to the output buffer
+    typename ImageType::Pointer outputImage = medResliceResampler<DATA_TYPE>::resample(vtkViewData, reslicer->GetResliceAxes(),
+                                                                                       size, origin, spacing,
+                                                                                       reslicer->GetBackgroundLevel());
+    outputData = medAbstractDataFactory::instance()->createSmartPointer(destType);
 
     compensateForRadiologicalView<DATA_TYPE>(outputImage);
     correctOutputTransform<DATA_TYPE>(outputImage, reslicer->GetResliceAxes());
@@ -749,19 +804,6 @@ void medResliceViewer::generateOutput(vtkImageReslice* reslicer, QString destTyp
     medUtilitiesITK::updateMetadata<ImageType>(outputData);
 }
 
-void medResliceViewer::applyResamplingPix()
-{
-    resampleProcess *resamplePr = new resampleProcess();
-    resamplePr->setInput(outputData);
-    resamplePr->setParameter(outputSpacing[0], 0);
-    resamplePr->setParameter(outputSpacing[1], 1);
-    resamplePr->setParameter(outputSpacing[2], 2);
-    resamplePr->update();
-
-    outputData = resamplePr->output();
-    delete resamplePr;
-}
-
 template <typename DATA_TYPE>
 void medResliceViewer::compensateForRadiologicalView(itk::Image<DATA_TYPE, 3>* outputImage)
 {
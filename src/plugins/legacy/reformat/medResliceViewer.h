@@ -100,12 +100,11 @@ protected:
     void ensureOrthogonalPlanes();
     int findMovingPlaneIndex();
     void makePlaneOrthogonalToOtherPlanes(vtkPlane* targetPlane, vtkPlane* plane1, vtkPlane* plane2);
+    void useFastSlabRepresentation(int i);
 
     template <typename DATA_TYPE>
     void generateOutput(vtkImageReslice* reslicer, QString destType);
 
-    void applyResamplingPix();
-
     template <typename DATA_TYPE>
     void compensateForRadiologicalView(itk::Image<DATA_TYPE, 3>* image);
 
@@ -192,6 +192,14 @@ void undoRedoRegistrationToolBox::setRegistrationToolBox(medRegistrationSelector
 
 void undoRedoRegistrationToolBox::onRegistrationSuccess()
 {
+    // The frames of a 4D image each have their transformation, the registered series is
+    // not stacked with the other transformations
+    if (!static_cast<itkProcessRegistration*>(this->parentToolBox()->process())->frameTransforms().isEmpty())
+    {
+        this->parentToolBox()->handleOutput();
+        return;
+    }
+
     registrationFactory::instance()->addTransformation(static_cast<itkProcessRegistration*>(this->parentToolBox()->process())->getTransform(),static_cast<itkProcessRegistration*>(this->parentToolBox()->process())->getTitleAndParameters());
     registrationFactory::instance()->getItkRegistrationFactory()->Modified();
     d->m_UndoRedo->generateOutput(true,this->parentToolBox()->process());
@@ -14,7 +14,11 @@
 #include "vtkDataMesh.h"
 
 #include <medAbstractDataFactory.h>
+#include <medThumbnailRenderer.h>
 
+#include <vtkCell.h>
+#include <vtkDataSet.h>
+#include <vtkIdList.h>
 #include <vtkMetaDataSet.h>
 #include <vtkSmartPointer.h>
 
@@ -114,3 +118,51 @@ int vtkDataMesh::countEdges()
 {
     return 0;
 }
+
+qint64 vtkDataMesh::memorySize()
+{
+    if (!d->mesh || !d->mesh->GetDataSet())
+    {
+        return 0;
+    }
+    // vtkDataObject gives its size in kibibytes
+    return static_cast<qint64>(d->mesh->GetDataSet()->GetActualMemorySize()) * 1024;
+}
+
+/**
+ * Projection of the cell edges, shaded by depth.
+ */
+QImage vtkDataMesh::renderThumbnail(QSize size)
+{
+    vtkDataSet *dataSet = d->mesh ? d->mesh->GetDataSet() : nullptr;
+    if (!dataSet || dataSet->GetNumberOfPoints() == 0)
+    {
+        return QImage();
+    }
+
+    QVector<QVector3D> points(dataSet->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < dataSet->GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        dataSet->GetPoint(i, point);
+        points[i] = QVector3D(point[0], point[1], point[2]);
+    }
+
+    // cells are subsampled on large meshes
+    QVector< QPair<int, int> > segments;
+    vtkIdType cellCount = dataSet->GetNumberOfCells();
+    vtkIdType stride = std::max<vtkIdType>(1, 3 * cellCount / medThumbnailRenderer::maximumSegmentCount());
+    vtkSmartPointer<vtkIdList> cellPoints = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType cell = 0; cell < cellCount; cell += stride)
+    {
+        dataSet->GetCellPoints(cell, cellPoints);
+        vtkIdType count = cellPoints->GetNumberOfIds();
+        for (vtkIdType i = 0; i < count && count > 1; ++i)
+        {
+            segments.append(qMakePair(static_cast<int>(cellPoints->GetId(i)),
+                                      static_cast<int>(cellPoints->GetId((i + 1) % count))));
+        }
+    }
+
+    return medThumbnailRenderer::renderProjection(points, segments, medThumbnailRenderer::ShadeByDepth, size);
+}
@@ -46,6 +46,10 @@ class VTKDATAMESHPLUGIN_EXPORT vtkDataMesh : public medAbstractMeshData
     int countVertices();
     int countEdges();
 
+    qint64 memorySize() override;
+
+    QImage renderThumbnail(QSize size) override;
+
  private:
 
     vtkDataMeshPrivate* d;
@@ -23,6 +23,7 @@
 #include <medAbstractDataFactory.h>
 
 #include <medIntParameter.h>
+#include <medJobScheduler.h>
 #include <medDoubleParameter.h>
 #include <medStringParameter.h>
 
@@ -116,6 +117,11 @@ QString medItkBiasCorrectionProcess::caption() const
     return "Bias correction";
 }
 
+medJobScheduler::Category medItkBiasCorrectionProcess::schedulingCategory() const
+{
+    return medJobScheduler::HeavyProcessJob;
+}
+
 QString medItkBiasCorrectionProcess::description() const
 {
     return "Use ITK N4BiasCorrectionFilter to compute a bias corrected image.";
@@ -219,7 +225,8 @@ template <class inputType, unsigned int Dimension> medAbstractJob::medJobExitSta
     typedef itk::DivideImageFilter<OutputImageType, OutputImageType, OutputImageType> DividerType;
     typedef itk::ExtractImageFilter<OutputImageType, OutputImageType> CropperType;
 
-    unsigned int uiThreadNb = static_cast<unsigned int>(m_poUIThreadNb->value());
+    // no more threads than the scheduler leaves to each running job
+    unsigned int uiThreadNb = static_cast<unsigned int>(std::min(m_poUIThreadNb->value(), medJobScheduler::instance()->threadsPerJob()));
     unsigned int uiShrinkFactors = static_cast<unsigned int>(m_poUIShrinkFactors->value());
     unsigned int uiSplineOrder = static_cast<unsigned int>(m_poUISplineOrder->value());
     float fWienerFilterNoise = static_cast<float>(m_poFWienerFilterNoise->value());
@@ -38,6 +38,7 @@ public:
 
     virtual QString caption() const;
     virtual QString description() const;
+    virtual medJobScheduler::Category schedulingCategory() const;
 
 
     medIntParameter* getUIThreadNb() { return m_poUIThreadNb; }
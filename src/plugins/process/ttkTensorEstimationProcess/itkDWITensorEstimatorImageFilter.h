@@ -0,0 +1,100 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <itkImageToImageFilter.h>
+#include <itkVector.h>
+
+#include <vector>
+
+namespace itk
+{
+
+/**
+ * Estimates a diffusion tensor per voxel from a 4D DWI image, whose first
+ * volume is the b0 image.
+ *
+ * The volumes are read in place in the buffer of the 4D image, no 3D image
+ * is extracted. With S0 the b0 value and Si the value along the gradient gi,
+ * the log ratios log(S0/Si) are fitted in the least-squares sense by
+ * gi^T D gi. The pseudo-inverse of the gradient system is computed once, it
+ * is applied to blocks of voxels of an image row so that the inner loops run
+ * over contiguous values and are vectorized.
+ *
+ * Voxels whose b0 value is not above the background threshold get a null
+ * tensor.
+ */
+template <class TInputImage, class TOutputImage>
+class ITK_EXPORT DWITensorEstimatorImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+    typedef DWITensorEstimatorImageFilter                Self;
+    typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+    typedef SmartPointer<Self>                            Pointer;
+    typedef SmartPointer<const Self>                      ConstPointer;
+
+    itkNewMacro(Self)
+    itkTypeMacro(DWITensorEstimatorImageFilter, ImageToImageFilter)
+
+    typedef TInputImage                              InputImageType;
+    typedef typename InputImageType::PixelType       InputPixelType;
+    typedef TOutputImage                             OutputImageType;
+    typedef typename OutputImageType::PixelType      TensorType;
+    typedef typename OutputImageType::RegionType     OutputImageRegionType;
+
+    typedef Vector<double, 3>                        GradientType;
+    typedef std::vector<GradientType>                GradientListType;
+
+    //! One gradient per volume, the first one is the b0 volume
+    void SetGradientList(const GradientListType &gradients)
+    {
+        m_GradientList = gradients;
+        this->Modified();
+    }
+    const GradientListType &GetGradientList(void) const
+    {
+        return m_GradientList;
+    }
+
+    //! Background threshold on the b0 values
+    itkSetMacro(BST, double)
+    itkGetConstMacro(BST, double)
+
+protected:
+    DWITensorEstimatorImageFilter();
+    ~DWITensorEstimatorImageFilter() {}
+    void PrintSelf(std::ostream &os, Indent indent) const override;
+
+    void GenerateOutputInformation(void) override;
+    void GenerateInputRequestedRegion(void) override;
+    void BeforeThreadedGenerateData(void) override;
+    void DynamicThreadedGenerateData(const OutputImageRegionType &outputRegionForThread) override;
+
+private:
+    DWITensorEstimatorImageFilter(const Self&); //purposely not implemented
+    void operator=(const Self&); //purposely not implemented
+
+    static const unsigned int BlockSize = 64;
+
+    GradientListType m_GradientList;
+    double m_BST;
+
+    // 6 rows (xx, xy, xz, yy, yz, zz) by one column per DWI volume
+    std::vector<double> m_InverseGradientMatrix;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDWITensorEstimatorImageFilter.txx"
+#endif
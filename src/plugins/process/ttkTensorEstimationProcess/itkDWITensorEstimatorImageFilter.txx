@@ -0,0 +1,219 @@
+#pragma once
+/*=========================================================================
+
+ medInria
+
+ Copyright (c) INRIA 2013 - 2020. All rights reserved.
+ See LICENSE.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.
+
+=========================================================================*/
+
+#include <itkDWITensorEstimatorImageFilter.h>
+#include <itkImageScanlineIterator.h>
+
+#include <vnl/vnl_matrix.h>
+#include <vnl/algo/vnl_svd.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+template <class TInputImage, class TOutputImage>
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::DWITensorEstimatorImageFilter()
+{
+    m_BST = 0;
+    this->DynamicMultiThreadingOn();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Gradients: " << m_GradientList.size() << std::endl;
+    os << indent << "BST: " << m_BST << std::endl;
+}
+
+/**
+ * The output has the geometry of a volume of the input.
+ */
+template <class TInputImage, class TOutputImage>
+void
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::GenerateOutputInformation(void)
+{
+    const InputImageType *input = this->GetInput();
+    OutputImageType *output = this->GetOutput();
+    if (!input || !output)
+    {
+        return;
+    }
+
+    const typename InputImageType::RegionType &inputRegion = input->GetLargestPossibleRegion();
+    OutputImageRegionType region;
+    typename OutputImageType::SpacingType spacing;
+    typename OutputImageType::PointType origin;
+    typename OutputImageType::DirectionType direction;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        region.SetIndex(i, inputRegion.GetIndex(i));
+        region.SetSize(i, inputRegion.GetSize(i));
+        spacing[i] = input->GetSpacing()[i];
+        origin[i] = input->GetOrigin()[i];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            direction[i][j] = input->GetDirection()[i][j];
+        }
+    }
+
+    output->SetLargestPossibleRegion(region);
+    output->SetSpacing(spacing);
+    output->SetOrigin(origin);
+    output->SetDirection(direction);
+}
+
+/**
+ * Each output voxel needs all the volumes.
+ */
+template <class TInputImage, class TOutputImage>
+void
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::GenerateInputRequestedRegion(void)
+{
+    InputImageType *input = const_cast<InputImageType *>(this->GetInput());
+    if (input)
+    {
+        input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::BeforeThreadedGenerateData(void)
+{
+    const unsigned int volumes = this->GetInput()->GetBufferedRegion().GetSize(3);
+    if (m_GradientList.size() != volumes)
+    {
+        itkExceptionMacro(<< "Number of gradients (" << m_GradientList.size()
+                          << ") not matching the number of DWI volumes (" << volumes << ")");
+    }
+
+    const unsigned int measures = volumes - 1;
+    if (measures < 6)
+    {
+        itkExceptionMacro(<< "At least 6 gradients are needed to estimate tensors");
+    }
+
+    vnl_matrix<double> system(measures, 6);
+    for (unsigned int i = 0; i < measures; ++i)
+    {
+        const GradientType &g = m_GradientList[i + 1];
+        system(i, 0) = g[0] * g[0];
+        system(i, 1) = 2 * g[0] * g[1];
+        system(i, 2) = 2 * g[0] * g[2];
+        system(i, 3) = g[1] * g[1];
+        system(i, 4) = 2 * g[1] * g[2];
+        system(i, 5) = g[2] * g[2];
+    }
+
+    vnl_matrix<double> inverse = vnl_svd<double>(system).pinverse();
+    m_InverseGradientMatrix.resize(6 * measures);
+    for (unsigned int c = 0; c < 6; ++c)
+    {
+        for (unsigned int i = 0; i < measures; ++i)
+        {
+            m_InverseGradientMatrix[c * measures + i] = inverse(c, i);
+        }
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DWITensorEstimatorImageFilter<TInputImage, TOutputImage>
+::DynamicThreadedGenerateData(const OutputImageRegionType &outputRegionForThread)
+{
+    const InputImageType *input = this->GetInput();
+    OutputImageType *output = this->GetOutput();
+
+    // volume v of the input starts at v * volumeSize in the buffer
+    const typename InputImageType::RegionType &bufferedRegion = input->GetBufferedRegion();
+    const SizeValueType volumeSize = bufferedRegion.GetSize(0) * bufferedRegion.GetSize(1) * bufferedRegion.GetSize(2);
+    const InputPixelType *buffer = input->GetBufferPointer();
+
+    const unsigned int measures = static_cast<unsigned int>(m_GradientList.size()) - 1;
+    const double *inverse = m_InverseGradientMatrix.data();
+    const SizeValueType rowLength = outputRegionForThread.GetSize(0);
+
+    std::vector<double> logRatios(measures * BlockSize);
+    std::vector<double> coefficients(6 * BlockSize);
+
+    ImageScanlineIterator<OutputImageType> it(output, outputRegionForThread);
+    while (!it.IsAtEnd())
+    {
+        const typename OutputImageType::IndexType index = it.GetIndex();
+        const OffsetValueType rowOffset = (index[0] - bufferedRegion.GetIndex(0))
+                + bufferedRegion.GetSize(0) * ((index[1] - bufferedRegion.GetIndex(1))
+                + bufferedRegion.GetSize(1) * (index[2] - bufferedRegion.GetIndex(2)));
+
+        for (SizeValueType begin = 0; begin < rowLength; begin += BlockSize)
+        {
+            const unsigned int count = static_cast<unsigned int>(std::min<SizeValueType>(BlockSize, rowLength - begin));
+            const InputPixelType *b0 = buffer + rowOffset + begin;
+
+            for (unsigned int i = 0; i < measures; ++i)
+            {
+                const InputPixelType *dwi = b0 + (i + 1) * volumeSize;
+                double *y = &logRatios[i * BlockSize];
+                for (unsigned int k = 0; k < count; ++k)
+                {
+                    const double s0 = static_cast<double>(b0[k]);
+                    const double s = static_cast<double>(dwi[k]);
+                    y[k] = (s0 > m_BST && s > 0) ? std::log(s0 / s) : 0.0;
+                }
+            }
+
+            for (unsigned int c = 0; c < 6; ++c)
+            {
+                double *d = &coefficients[c * BlockSize];
+                std::fill(d, d + count, 0.0);
+                for (unsigned int i = 0; i < measures; ++i)
+                {
+                    const double w = inverse[c * measures + i];
+                    const double *y = &logRatios[i * BlockSize];
+                    for (unsigned int k = 0; k < count; ++k)
+                    {
+                        d[k] += w * y[k];
+                    }
+                }
+            }
+
+            for (unsigned int k = 0; k < count; ++k, ++it)
+            {
+                TensorType tensor;
+                tensor.Fill(0.0);
+                if (static_cast<double>(b0[k]) > m_BST)
+                {
+                    tensor.SetComponent(0, 0, coefficients[0 * BlockSize + k]);
+                    tensor.SetComponent(0, 1, coefficients[1 * BlockSize + k]);
+                    tensor.SetComponent(0, 2, coefficients[2 * BlockSize + k]);
+                    tensor.SetComponent(1, 1, coefficients[3 * BlockSize + k]);
+                    tensor.SetComponent(1, 2, coefficients[4 * BlockSize + k]);
+                    tensor.SetComponent(2, 2, coefficients[5 * BlockSize + k]);
+                }
+                it.Set(tensor);
+            }
+        }
+        it.NextLine();
+    }
+}
+
+} // end namespace itk
@@ -4,12 +4,11 @@
 
 #include <itkImage.h>
 #include <itkTensor.h>
-#include <itkDTIEstimatorTensorImageFilter.h>
+#include <itkDWITensorEstimatorImageFilter.h>
 #include <itkRemoveNonPositiveTensorsTensorImageFilter.h>
 #include <itkAnisotropicDiffusionTensorImageFilter.h>
 #include <itkLogTensorImageFilter.h>
 #include <itkExpTensorImageFilter.h>
-#include <itkExtractImageFilter.h>
 
 #include <medAbstractImageData.h>
 #include <medAbstractDiffusionModelImageData.h>
@@ -140,7 +139,6 @@ template <class inputType>
 medAbstractJob::medJobExitStatus ttkTensorEstimationProcess::_run()
 {
     typedef itk::Image <inputType,4> DWIImageType;
-    typedef itk::Image <inputType,3> SingleDWIImageType;
     typename DWIImageType::Pointer inData = dynamic_cast<DWIImageType *>((itk::Object*)(this->input()->data()));
 
     typedef float ScalarType;
@@ -150,7 +148,8 @@ medAbstractJob::medJobExitStatus ttkTensorEstimationProcess::_run()
     if (!inData)
         return medAbstractJob::MED_JOB_EXIT_FAILURE;
 
-    typedef itk::DTIEstimatorTensorImageFilter < SingleDWIImageType, TensorImageType > TensorEstimatorType;
+    // reads the gradient volumes in the buffer of the 4D image
+    typedef itk::DWITensorEstimatorImageFilter < DWIImageType, TensorImageType > TensorEstimatorType;
     typedef typename TensorEstimatorType::GradientType GradientType;
     typedef typename TensorEstimatorType::GradientListType GradientListType;
 
@@ -167,9 +166,7 @@ medAbstractJob::medJobExitStatus ttkTensorEstimationProcess::_run()
 
     typename TensorEstimatorType::Pointer filter = TensorEstimatorType::New();
 
-    typedef itk::ExtractImageFilter<DWIImageType, SingleDWIImageType> ExtractorType;
-    typename DWIImageType::SizeType size = inData->GetLargestPossibleRegion().GetSize();
-    unsigned int imageCount = size[3];
+    unsigned int imageCount = inData->GetLargestPossibleRegion().GetSize()[3];
 
     if (imageCount != diffGrads.size())
     {
@@ -177,31 +174,7 @@ medAbstractJob::medJobExitStatus ttkTensorEstimationProcess::_run()
         return medAbstractJob::MED_JOB_EXIT_FAILURE;
     }
 
-    size[3] = 0;
-    typename DWIImageType::IndexType index = {{0,0,0,0}};
-    typename DWIImageType::RegionType region;
-    region.SetSize (size);
-    for (unsigned int i=0; i<imageCount; i++)
-    {
-        index[3] = i;
-        region.SetIndex (index);
-        typename ExtractorType::Pointer extractor = ExtractorType::New();
-        extractor->SetExtractionRegion (region);
-        extractor->SetInput (inData);
-        extractor->SetDirectionCollapseToGuess();
-        try
-        {
-            extractor->Update();
-        }
-        catch (itk::ExceptionObject &e)
-        {
-            qDebug() << e.GetDescription();
-            return medAbstractJob::MED_JOB_EXIT_FAILURE;
-        }
-
-       filter->SetInput(i, extractor->GetOutput());
-    }
-
+    filter->SetInput(inData);
     filter->SetGradientList(gradientList);
     filter->SetBST(0);
 
@@ -15,15 +15,26 @@
 #include <itkLogTensorImageFilter.h>
 #include <itkFiberImageToVtkPolyData.h>
 #include <itkCommand.h>
+#include <itkExtractImageFilter.h>
+#include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
+#include <vtkAppendPolyData.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
+#include <algorithm>
+#include <cmath>
+
 ttkTensorTractographyProcess::ttkTensorTractographyProcess(QObject *parent)
     : medAbstractTractographyProcess(parent)
 {
     m_logerfilter = 0;
     m_tractographyfilter = 0;
     m_converterfilter = 0;
+    m_trackedSlabs = 0;
+    m_slabCount = 1;
+    m_cancelled = false;
 
     m_faThreshold = new medIntParameter("fa_threshold", this);
     m_faThreshold->setCaption("Starting FA threshold");
@@ -54,6 +65,12 @@ ttkTensorTractographyProcess::ttkTensorTractographyProcess(QObject *parent)
     m_sampling->setDescription("Fibers are seeded every X voxels, being X the sampling value.");
     m_sampling->setRange(1,100);
     m_sampling->setValue(1);
+
+    m_batchCount = new medIntParameter("batch_count", this);
+    m_batchCount->setCaption("Batches");
+    m_batchCount->setDescription("The seeds are tracked by slabs of the volume,\nthe fibers of each slab are shown as soon as it is tracked.");
+    m_batchCount->setRange(1,64);
+    m_batchCount->setValue(8);
 }
 
 ttkTensorTractographyProcess::~ttkTensorTractographyProcess()
@@ -95,6 +112,11 @@ medIntParameter *ttkTensorTractographyProcess::sampling() const
     return m_sampling;
 }
 
+medIntParameter *ttkTensorTractographyProcess::batchCount() const
+{
+    return m_batchCount;
+}
+
 medAbstractJob::medJobExitStatus ttkTensorTractographyProcess::run()
 {
     medAbstractJob::medJobExitStatus jobExitSatus = medAbstractJob::MED_JOB_EXIT_FAILURE;
@@ -113,6 +135,9 @@ medAbstractJob::medJobExitStatus ttkTensorTractographyProcess::run()
         }
     }
 
+    // the fibers tracked so far are only shown while the process runs
+    this->setPartialOutput(nullptr);
+
     return jobExitSatus;
 }
 
@@ -126,12 +151,30 @@ medAbstractJob::medJobExitStatus ttkTensorTractographyProcess::_run()
     if (!inData)
         return medAbstractJob::MED_JOB_EXIT_FAILURE;
 
+    typedef itk::Image<unsigned char, 3> MaskImageType;
+    MaskImageType::Pointer mask = nullptr;
+    if (this->seedMask())
+    {
+        mask = dynamic_cast<MaskImageType *>((itk::Object*)(this->seedMask()->data()));
+        if (!mask)
+        {
+            dtkWarn() << "Seed mask is not an unsigned char 3D image";
+            return medAbstractJob::MED_JOB_EXIT_FAILURE;
+        }
+    }
+
     typedef itk::LogTensorImageFilter<TensorImageType, TensorImageType> LogFilterType;
     typedef itk::Fiber<inputType, 3> FiberType;
     typedef itk::Image<FiberType, 3> FiberImageType;
     typedef itk::FiberTrackingImageFilter<TensorImageType, FiberImageType> FiberTrackingFilterType;
+    typedef itk::ExtractImageFilter<FiberImageType, FiberImageType> ExtractFilterType;
     typedef itk::FiberImageToVtkPolyData<FiberImageType> FiberImageToVtkPolyDataType;
 
+    m_cancelled = false;
+    m_trackedSlabs = 0;
+    m_slabCount = 1;
+    this->setPartialOutput(nullptr);
+
     typename LogFilterType::Pointer logFilter = LogFilterType::New();
     logFilter->SetInput(inData);
     m_logerfilter = logFilter;
@@ -167,32 +210,146 @@ medAbstractJob::medJobExitStatus ttkTensorTractographyProcess::_run()
     callback->SetCallback(ttkTensorTractographyProcess::eventCallback);
     trackerFilter->AddObserver(itk::ProgressEvent(), callback);
 
-    try
-    {
-        trackerFilter->Update();
-    }
-    catch(itk::ProcessAborted &e)
+    // Seeds are only looked for in the bounding box of the mask, aligned on
+    // the sampling so that the seeds are the ones of a whole volume tracking
+    const typename TensorImageType::RegionType largestRegion = inData->GetLargestPossibleRegion();
+    typename TensorImageType::RegionType seedRegion = largestRegion;
+    const int sampling = m_sampling->value();
+
+    if (mask)
     {
-        return medAbstractJob::MED_JOB_EXIT_CANCELLED;
+        typename TensorImageType::IndexType lower, upper;
+        bool hasSeeds = false;
+
+        itk::ImageRegionConstIteratorWithIndex<MaskImageType> maskIt(mask, mask->GetLargestPossibleRegion());
+        for (maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt)
+        {
+            if (maskIt.Get() == 0)
+                continue;
+
+            typename MaskImageType::PointType point;
+            mask->TransformIndexToPhysicalPoint(maskIt.GetIndex(), point);
+            itk::ContinuousIndex<double, 3> index;
+            inData->TransformPhysicalPointToContinuousIndex(point, index);
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+                const itk::IndexValueType low = static_cast<itk::IndexValueType>(std::floor(index[i]));
+                const itk::IndexValueType up = static_cast<itk::IndexValueType>(std::ceil(index[i]));
+                lower[i] = hasSeeds ? std::min(lower[i], low) : low;
+                upper[i] = hasSeeds ? std::max(upper[i], up) : up;
+            }
+            hasSeeds = true;
+        }
+
+        for (unsigned int i = 0; hasSeeds && i < 3; ++i)
+        {
+            const itk::IndexValueType first = largestRegion.GetIndex(i);
+            const itk::IndexValueType last = first + static_cast<itk::IndexValueType>(largestRegion.GetSize(i)) - 1;
+            lower[i] = std::max(lower[i], first);
+            lower[i] -= (lower[i] - first) % sampling;
+            upper[i] = std::min(upper[i], last);
+            hasSeeds = (upper[i] >= lower[i]);
+            seedRegion.SetIndex(i, lower[i]);
+            seedRegion.SetSize(i, hasSeeds ? upper[i] - lower[i] + 1 : 0);
+        }
+
+        // nothing to track, the output has no fibers
+        if (!hasSeeds)
+            seedRegion.SetSize(2, 0);
     }
 
+    const itk::SizeValueType depth = seedRegion.GetSize(2);
+    const itk::SizeValueType seedPlanes = (depth + sampling - 1) / sampling;
+    const itk::SizeValueType slabThickness = sampling * std::max<itk::SizeValueType>(1, (seedPlanes + m_batchCount->value() - 1) / m_batchCount->value());
+    m_slabCount = std::max<int>(1, static_cast<int>((depth + slabThickness - 1) / slabThickness));
+
+    typename ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+    extractFilter->SetInput(trackerFilter->GetOutput());
+
     typename FiberImageToVtkPolyDataType::Pointer converterFilter = FiberImageToVtkPolyDataType::New();
-    converterFilter->SetInput(trackerFilter->GetOutput());
     m_converterfilter = converterFilter;
 
-    try
-    {
-        converterFilter->Update();
-    }
-    catch(itk::ProcessAborted &e)
+    vtkSmartPointer<vtkPolyData> fibers = vtkSmartPointer<vtkPolyData>::New();
+
+    for (itk::SizeValueType slabStart = 0; slabStart < depth; slabStart += slabThickness)
     {
-        return medAbstractJob::MED_JOB_EXIT_CANCELLED;
+        if (m_cancelled)
+            return medAbstractJob::MED_JOB_EXIT_CANCELLED;
+
+        typename FiberImageType::RegionType slab = seedRegion;
+        slab.SetIndex(2, seedRegion.GetIndex(2) + slabStart);
+        slab.SetSize(2, std::min(slabThickness, depth - slabStart));
+
+        // only the slab is requested from the tracker, which spreads its
+        // seeds over the threads
+        extractFilter->SetExtractionRegion(slab);
+
+        try
+        {
+            extractFilter->Update();
+        }
+        catch(itk::ProcessAborted &e)
+        {
+            return medAbstractJob::MED_JOB_EXIT_CANCELLED;
+        }
+
+        typename FiberImageType::Pointer slabFibers = extractFilter->GetOutput();
+        slabFibers->DisconnectPipeline();
+
+        if (mask)
+        {
+            itk::ImageRegionIterator<FiberImageType> fiberIt(slabFibers, slabFibers->GetLargestPossibleRegion());
+            for (fiberIt.GoToBegin(); !fiberIt.IsAtEnd(); ++fiberIt)
+            {
+                typename FiberImageType::PointType point;
+                slabFibers->TransformIndexToPhysicalPoint(fiberIt.GetIndex(), point);
+                typename MaskImageType::IndexType maskIndex;
+                if (!mask->TransformPhysicalPointToIndex(point, maskIndex) || mask->GetPixel(maskIndex) == 0)
+                    fiberIt.Set(FiberType());
+            }
+        }
+
+        converterFilter->SetInput(slabFibers);
+
+        try
+        {
+            converterFilter->Update();
+        }
+        catch(itk::ProcessAborted &e)
+        {
+            return medAbstractJob::MED_JOB_EXIT_CANCELLED;
+        }
+
+        ++m_trackedSlabs;
+
+        vtkPolyData *slabPolyData = converterFilter->GetOutput();
+        if (!slabPolyData || slabPolyData->GetNumberOfCells() == 0)
+            continue;
+
+        // the fibers shown so far are left untouched, the next batch gets a
+        // new polydata
+        vtkSmartPointer<vtkAppendPolyData> appendFilter = vtkSmartPointer<vtkAppendPolyData>::New();
+        if (fibers->GetNumberOfCells() > 0)
+            appendFilter->AddInputData(fibers);
+        appendFilter->AddInputData(slabPolyData);
+        appendFilter->Update();
+        fibers = appendFilter->GetOutput();
+
+        if (m_trackedSlabs < m_slabCount)
+        {
+            medAbstractFibersData *partialOutput = dynamic_cast <medAbstractFibersData *> (medAbstractDataFactory::instance()->create("medVtkFibersData"));
+            if (partialOutput)
+            {
+                partialOutput->setData(fibers);
+                this->setPartialOutput(partialOutput);
+            }
+        }
     }
 
     medAbstractFibersData *output = dynamic_cast <medAbstractFibersData *> (medAbstractDataFactory::instance()->create("medVtkFibersData"));
 
     if (output)
-        output->setData (converterFilter->GetOutput());
+        output->setData (fibers);
 
     this->setOutput(output);
 
@@ -203,6 +360,8 @@ void ttkTensorTractographyProcess::cancel()
 {
     if(this->isRunning())
     {
+        m_cancelled = true;
+
         if (m_tractographyfilter.IsNotNull())
             m_tractographyfilter->AbortGenerateDataOn();
 
@@ -5,6 +5,8 @@
 #include <itkProcessObject.h>
 #include <itkSmartPointer.h>
 
+#include <atomic>
+
 #include <medIntParameter.h>
 #include <medDoubleParameter.h>
 
@@ -19,9 +21,10 @@ public:
 
     static void eventCallback(itk::Object *caller, const itk::EventObject& event, void *clientData)
     {
-        medAbstractTractographyProcess * source = reinterpret_cast<medAbstractTractographyProcess *>(clientData);
+        ttkTensorTractographyProcess * source = reinterpret_cast<ttkTensorTractographyProcess *>(clientData);
         itk::ProcessObject * processObject = (itk::ProcessObject*) caller;
-        source->progression()->setValue(processObject->GetProgress() * 100);
+        double progress = (source->m_trackedSlabs + processObject->GetProgress()) / source->m_slabCount;
+        source->progression()->setValue(progress * 100);
     }
 
     virtual medAbstractJob::medJobExitStatus run();
@@ -35,6 +38,7 @@ public:
     medIntParameter *smoothness() const;
     medIntParameter *minLength() const;
     medIntParameter *sampling() const;
+    medIntParameter *batchCount() const;
 
 private:
     template <class inputType> medAbstractJob::medJobExitStatus _run();
@@ -44,11 +48,17 @@ private:
     itk::SmartPointer<itk::ProcessObject> m_tractographyfilter;
     itk::SmartPointer<itk::ProcessObject> m_converterfilter;
 
+    // the seeds are tracked by slabs along z
+    int m_trackedSlabs;
+    int m_slabCount;
+    std::atomic<bool> m_cancelled;
+
     medIntParameter *m_faThreshold;
     medIntParameter *m_faThreshold2;
     medIntParameter *m_smoothness;
     medIntParameter *m_minLength;
     medIntParameter *m_sampling;
+    medIntParameter *m_batchCount;
 };
 
 inline medAbstractTractographyProcess* ttkTensorTractographyProcessCreator()
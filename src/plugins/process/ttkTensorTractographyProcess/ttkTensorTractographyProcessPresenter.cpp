@@ -19,6 +19,7 @@ ttkTensorTractographyProcessPresenter::ttkTensorTractographyProcessPresenter(med
     m_smoothness = new medIntParameterPresenter(m_process->smoothness());
     m_minLength = new medIntParameterPresenter(m_process->minLength());
     m_sampling = new medIntParameterPresenter(m_process->sampling());
+    m_batchCount = new medIntParameterPresenter(m_process->batchCount());
 
     m_progressionPresenter = new medIntParameterPresenter(m_process->progression());
 }
@@ -125,6 +126,16 @@ QWidget *ttkTensorTractographyProcessPresenter::buildToolBoxWidget()
     connect(samplingSlider,SIGNAL(valueChanged(int)),samplingSpinBox,SLOT(setValue(int)));
     tbLayout->addLayout(samplingLayout);
 
+    QLabel *batchCountLabel = new QLabel(m_batchCount->parameter()->caption(), tbInternalWidget);
+    QHBoxLayout *batchCountLayout = new QHBoxLayout;
+    batchCountLayout->addWidget(batchCountLabel);
+    QWidget *batchCountSpinBox = m_batchCount->buildWidget();
+    batchCountSpinBox->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    batchCountSpinBox->setToolTip(m_batchCount->parameter()->description());
+    batchCountLayout->addStretch();
+    batchCountLayout->addWidget(batchCountSpinBox);
+    tbLayout->addLayout(batchCountLayout);
+
     tbGlobalLayout->addWidget(this->buildRunButton());
     tbGlobalLayout->addWidget(m_progressionPresenter->buildProgressBar());
     tbGlobalLayout->addWidget(this->buildCancelButton());
@@ -24,6 +24,7 @@ private:
     medIntParameterPresenter *m_smoothness;
     medIntParameterPresenter *m_minLength;
     medIntParameterPresenter *m_sampling;
+    medIntParameterPresenter *m_batchCount;
 
     medIntParameterPresenter *m_progressionPresenter;
 };